@@ -0,0 +1,823 @@
+/**
+ * @file bench.c
+ * @brief Micro and macro benchmarks of the engine core, written as JSON.
+ * * Five groups, run in this order:
+ * - micro: the vec2 helpers, is_colliding(), tackle(), update_team() and the
+ *   ball model's position and intercept queries (trajectory.h), each timed in
+ *   calibrated batches; the median and best batch are reported in ns/op.
+ * - broadphase: the possession check and every player's nearest teammate and
+ *   opponent, by plain scans and through the spatial grid (grid.h), for 3 to
+ *   176 players a side moving about the pitch, and the first size at which
+ *   the grid wins each of them; also body collisions (roster_collide()).
+ * - macro: full seeded matches on one thread (ticks/s, ns/tick, matches/s),
+ *   then the same matches with body collisions on, for what they add to a tick.
+ * - scaling: the same matches through batch_run() on 1, 2, 4 ... N threads,
+ *   with matches/s per core and the speedup over one thread.
+ * - roster: single-thread matches with 3 to 44 players a side, on pitches
+ *   grown with the player count, in ns per tick and per player-tick.
+ * The JSON goes to stdout (or --output) so runs can be diffed between
+ * releases; progress goes to stderr.
+ */
+#define _POSIX_C_SOURCE 200112L // clock_gettime
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "core/constants.h"
+#include "core/log.h"
+#include "core/profile.h"
+#include "core/rng.h"
+#include "core/vec2.h"
+#include "entities/ball.h"
+#include "entities/team.h"
+#include "game/batch.h"
+#include "game/grid.h"
+#include "game/perception.h"
+#include "game/possession.h"
+#include "game/rollout.h"
+#include "game/scene.h"
+#include "game/timestep.h"
+#include "game/trajectory.h"
+
+/** @brief Operand table size for the vec2 cases (a power of two, so indices wrap with a mask). */
+#define BENCH_INPUTS 1024
+/** @brief Timed batches per micro case; the median and the best are reported. */
+#define BENCH_SAMPLES 7
+/** @brief Game seconds played before update_team() is timed, so the coaches see open play. */
+#define BENCH_WARMUP_SECONDS 10.0f
+
+/** @brief Position sets each broadphase size cycles through; consecutive ones are one tick of running apart. */
+#define BENCH_FRAMES 64
+
+/** @brief Bumped whenever a field changes meaning, so old results are not compared blindly. */
+#define BENCH_SCHEMA 5
+
+/** @brief Team sizes of the roster sweep. The pitch area grows with them, from the default 6 a side. */
+static const int roster_sizes[] = { 3, 6, 11, 22, 44 };
+
+/** @brief Team sizes of the broadphase sweep, on the same growing pitches, well past any real squad. */
+static const int broadphase_sizes[] = { 3, 6, 11, 22, 44, 88, 176 };
+
+/** @brief State shared by the micro and broadphase cases. */
+struct BenchFixture {
+    struct Vec2 inputs[BENCH_INPUTS];
+    struct BallPath paths[BENCH_INPUTS];  /**< Free balls kicked from around the centre spot, up to full shooting speed. */
+    Scene scene;
+    struct Ball ball;
+    struct Vec2* frames;        /**< Broadphase only: BENCH_FRAMES x players positions, frame-major. */
+};
+
+/** @brief Runs one case `iterations` times and returns something derived from the results. */
+typedef float (*BenchFn)(struct BenchFixture* fixture, unsigned long iterations);
+
+struct MicroCase {
+    const char* name;
+    BenchFn run;
+};
+
+/** @brief Written after every batch so the compiler cannot drop the work. */
+static volatile float sink;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static float bench_vec2_add(struct BenchFixture* f, unsigned long iterations) {
+    struct Vec2 out;
+    float acc = 0.0f;
+    for (unsigned long i = 0; i < iterations; i++) {
+        vec2_add(&out, &f->inputs[i & (BENCH_INPUTS - 1)], &f->inputs[(i + 1) & (BENCH_INPUTS - 1)]);
+        acc += out.x;
+    }
+    return acc;
+}
+
+static float bench_vec2_sub(struct BenchFixture* f, unsigned long iterations) {
+    struct Vec2 out;
+    float acc = 0.0f;
+    for (unsigned long i = 0; i < iterations; i++) {
+        vec2_sub(&out, &f->inputs[i & (BENCH_INPUTS - 1)], &f->inputs[(i + 1) & (BENCH_INPUTS - 1)]);
+        acc += out.x;
+    }
+    return acc;
+}
+
+static float bench_mul(struct BenchFixture* f, unsigned long iterations) {
+    struct Vec2 out;
+    float acc = 0.0f;
+    for (unsigned long i = 0; i < iterations; i++) {
+        mulVec2(&out, &f->inputs[i & (BENCH_INPUTS - 1)], &f->inputs[(i + 1) & (BENCH_INPUTS - 1)]);
+        acc += out.y;
+    }
+    return acc;
+}
+
+static float bench_dot(struct BenchFixture* f, unsigned long iterations) {
+    float acc = 0.0f;
+    for (unsigned long i = 0; i < iterations; i++)
+        acc += dotProduct(&f->inputs[i & (BENCH_INPUTS - 1)], &f->inputs[(i + 1) & (BENCH_INPUTS - 1)]);
+    return acc;
+}
+
+static float bench_determinant(struct BenchFixture* f, unsigned long iterations) {
+    float acc = 0.0f;
+    for (unsigned long i = 0; i < iterations; i++)
+        acc += vec2Determinant(&f->inputs[i & (BENCH_INPUTS - 1)], &f->inputs[(i + 1) & (BENCH_INPUTS - 1)]);
+    return acc;
+}
+
+static float bench_length(struct BenchFixture* f, unsigned long iterations) {
+    float acc = 0.0f;
+    for (unsigned long i = 0; i < iterations; i++)
+        acc += lengthVec2(&f->inputs[i & (BENCH_INPUTS - 1)]);
+    return acc;
+}
+
+static float bench_rotation(struct BenchFixture* f, unsigned long iterations) {
+    float acc = 0.0f;
+    for (unsigned long i = 0; i < iterations; i++)
+        acc += vec2Rotation(&f->inputs[i & (BENCH_INPUTS - 1)]);
+    return acc;
+}
+
+static float bench_is_colliding(struct BenchFixture* f, unsigned long iterations) {
+    const struct Roster* roster = &f->scene.roster;
+    int hits = 0;
+    int idx = 0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        hits += is_colliding(roster, idx, &f->ball);
+        if (++idx == roster->count)
+            idx = 0;
+    }
+    return (float)hits;
+}
+
+/** @brief Every call is a contested tackle: the ball is handed to the previous player first. */
+static float bench_tackle(struct BenchFixture* f, unsigned long iterations) {
+    struct Player* views = f->scene.roster.views;
+    const int count = f->scene.roster.count;
+    struct Player* saved = f->ball.possessor;
+    int steals = 0;
+    int idx = 0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        const int next = idx + 1 == count ? 0 : idx + 1;
+        f->ball.possessor = &views[idx];
+        tackle(&views[next], &f->scene);
+        steals += f->ball.possessor == &views[next];
+        idx = next;
+    }
+    f->ball.possessor = saved;
+    return (float)steals;
+}
+
+/**
+ * @brief Alternates the two teams, as think_scene() does, dropping the shared
+ * perception before each pair. Nothing moves, so every call sees the same open-play position.
+ */
+static float bench_update_team(struct BenchFixture* f, unsigned long iterations) {
+    for (unsigned long i = 0; i < iterations; i++) {
+        if (!(i & 1))
+            perception_invalidate(&f->scene.perception);
+        update_team(&f->scene, (i & 1) ? f->scene.second_team : f->scene.first_team);
+    }
+    return f->scene.roster.views[0].velocity.x;
+}
+
+static float bench_ball_position_at(struct BenchFixture* f, unsigned long iterations) {
+    float acc = 0.0f;
+    for (unsigned long i = 0; i < iterations; i++)
+        acc += ball_position_at(&f->paths[i & (BENCH_INPUTS - 1)], (float)(i & 255) * (1.0f / 64.0f)).x;
+    return acc;
+}
+
+/** @brief A player somewhere on the pitch chasing one of the paths at 80% of top speed. */
+static float bench_ball_intercept_time(struct BenchFixture* f, unsigned long iterations) {
+    const Field* field = &f->scene.field;
+    const float reach = PLAYER_RADIUS + BALL_RADIUS;
+    float acc = 0.0f;
+    for (unsigned long i = 0; i < iterations; i++) {
+        const struct Vec2 offset = f->inputs[(i * 7 + 3) & (BENCH_INPUTS - 1)];
+        const struct Vec2 from = { field->center_x + offset.x * 0.4f, field->center_y + offset.y * 0.25f };
+        acc += ball_intercept_time(&f->paths[i & (BENCH_INPUTS - 1)], from, 0.8f * MAX_PLAYER_VELOCITY, reach);
+    }
+    return acc;
+}
+
+/** @brief One planning rollout: clone the scene, kick the ball one of the input ways, play 2 s at 15 Hz. */
+static float bench_rollout(struct BenchFixture* f, unsigned long iterations) {
+    struct Rollout* rollout = scene_rollout(&f->scene);
+    struct RolloutOutcome outcome;
+    float acc = 0.0f;
+    for (unsigned long i = 0; i < iterations; i++) {
+        const struct Vec2 kick = f->inputs[i & (BENCH_INPUTS - 1)];
+        rollout_clone(rollout, &f->scene);
+        rollout_kick(rollout, kick);
+        rollout_set_budget(rollout, 30);
+        rollout_run(rollout, 30, 1.0f / 15.0f, &outcome);
+        acc += outcome.ball.x;
+    }
+    return acc;
+}
+
+static const struct MicroCase micro_cases[] = {
+    { "vec2_add", bench_vec2_add },
+    { "vec2_sub", bench_vec2_sub },
+    { "mulVec2", bench_mul },
+    { "dotProduct", bench_dot },
+    { "vec2Determinant", bench_determinant },
+    { "lengthVec2", bench_length },
+    { "vec2Rotation", bench_rotation },
+    { "is_colliding", bench_is_colliding },
+    { "tackle", bench_tackle },
+    { "update_team", bench_update_team },
+    { "ball_position_at", bench_ball_position_at },
+    { "ball_intercept_time", bench_ball_intercept_time },
+    { "rollout", bench_rollout },
+};
+
+static int compare_doubles(const void* a, const void* b) {
+    const double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Doubles the batch size until one batch takes `batch_seconds`, then
+ * times BENCH_SAMPLES batches of that size into `ns_per_op`, sorted.
+ * @return The batch size.
+ */
+static unsigned long time_case(BenchFn run, struct BenchFixture* fixture, double batch_seconds,
+                               double ns_per_op[BENCH_SAMPLES]) {
+    unsigned long iterations = 16;
+    for (;;) {
+        const double start = now_seconds();
+        sink = run(fixture, iterations);
+        if (now_seconds() - start >= batch_seconds || iterations >= (1ul << 30))
+            break;
+        iterations *= 2;
+    }
+
+    for (int s = 0; s < BENCH_SAMPLES; s++) {
+        const double start = now_seconds();
+        sink = run(fixture, iterations);
+        ns_per_op[s] = (now_seconds() - start) * 1e9 / (double)iterations;
+    }
+    qsort(ns_per_op, BENCH_SAMPLES, sizeof(double), compare_doubles);
+    return iterations;
+}
+
+static void run_micro(FILE* out, const struct MicroCase* c, struct BenchFixture* fixture,
+                      double batch_seconds, int last) {
+    double ns_per_op[BENCH_SAMPLES];
+    const unsigned long iterations = time_case(c->run, fixture, batch_seconds, ns_per_op);
+
+    fprintf(stderr, "  %-16s %9.2f ns/op\n", c->name, ns_per_op[BENCH_SAMPLES / 2]);
+    fprintf(out, "    {\"name\": \"%s\", \"iterations\": %lu, \"samples\": %d, "
+                 "\"ns_per_op\": %.3f, \"ns_per_op_min\": %.3f, \"ns_per_op_max\": %.3f}%s\n",
+            c->name, iterations, BENCH_SAMPLES, ns_per_op[BENCH_SAMPLES / 2], ns_per_op[0],
+            ns_per_op[BENCH_SAMPLES - 1], last ? "" : ",");
+}
+
+/**
+ * @brief A seeded scene a few seconds into the match, plus random vec2 operands.
+ * @return 0 on success, -1 if the scene could not be built.
+ */
+static int setup_fixture(struct BenchFixture* fixture, uint64_t seed) {
+    struct Rng rng;
+    rng_seed(&rng, seed, 0);
+    for (int i = 0; i < BENCH_INPUTS; i++) {
+        fixture->inputs[i].x = (float)rng_range(&rng, 2001) - 1000.0f;
+        fixture->inputs[i].y = (float)rng_range(&rng, 2001) - 1000.0f;
+    }
+
+    const struct MatchSpec spec = { .seed = seed, .stream = 0, .length = 120.0f,
+                                    .tick_rate = DEFAULT_TICK_RATE };
+    if (batch_setup_scene(&fixture->scene, &fixture->ball, &spec) != 0)
+        return -1;
+    const float dt = 1.0f / spec.tick_rate;
+    for (float t = 0.0f; t < BENCH_WARMUP_SECONDS; t += dt)
+        update_scene(&fixture->scene, dt);
+
+    const Field* field = &fixture->scene.field;
+    for (int i = 0; i < BENCH_INPUTS; i++) {
+        const struct Vec2 spot = { field->center_x + fixture->inputs[i].y * 0.1f,
+                                   field->center_y + fixture->inputs[i].x * 0.1f };
+        const struct Vec2 kick = { fixture->inputs[i].x * (MAX_BALL_VELOCITY / 1000.0f),
+                                   fixture->inputs[i].y * (MAX_BALL_VELOCITY / 1000.0f) };
+        ball_path_free(&fixture->paths[i], spot, kick);
+    }
+    return 0;
+}
+
+/** @brief The pitch of the `team_size` a side sweeps: the default area per player, default proportions. */
+static Field sweep_field(int team_size) {
+    const Field reference = field_default();
+    const float scale = sqrtf((float)team_size / DEFAULT_TEAM_SIZE);
+    return field_make(reference.pitch_w * scale, reference.pitch_h * scale);
+}
+
+/** @brief Puts every player (views and roster arrays) where frame `k` has them. */
+static void load_frame(struct BenchFixture* f, unsigned long k) {
+    struct Roster* roster = &f->scene.roster;
+    const struct Vec2* frame = &f->frames[(k % BENCH_FRAMES) * (size_t)roster->count];
+    for (int i = 0; i < roster->count; i++) {
+        roster->views[i].position = frame[i];
+        roster->pos_x[i] = frame[i].x;
+        roster->pos_y[i] = frame[i].y;
+    }
+}
+
+/** @brief Only loads the frames: the common cost the other broadphase cases are reported net of. */
+static float bench_frames(struct BenchFixture* f, unsigned long iterations) {
+    for (unsigned long i = 0; i < iterations; i++)
+        load_frame(f, i);
+    return f->scene.roster.views[0].position.x;
+}
+
+/** @brief Loads the frames and brings the grid up to date: what the grid queries of a tick share. */
+static float bench_grid_update(struct BenchFixture* f, unsigned long iterations) {
+    struct Grid* grid = &f->scene.perception.grid;
+    for (unsigned long i = 0; i < iterations; i++) {
+        load_frame(f, i);
+        grid_update(grid, f->scene.roster.views);
+    }
+    return (float)grid->head[0];
+}
+
+/** @brief Loads the frames and pushes apart the players they overlap, keeping the sweep order between frames. */
+static float bench_collide(struct BenchFixture* f, unsigned long iterations) {
+    struct Roster* roster = &f->scene.roster;
+    const Field* field = &f->scene.field;
+    for (unsigned long i = 0; i < iterations; i++) {
+        load_frame(f, i);
+        roster_collide(roster, field->width, field->height);
+    }
+    return roster->pos_x[0];
+}
+
+/** @brief Puts the ball at the feet of roster player `i` (wrapped), in the frame last loaded. */
+static void place_ball(struct BenchFixture* f, unsigned long i) {
+    const struct Roster* roster = &f->scene.roster;
+    f->ball.position = roster->views[i % (unsigned long)roster->count].position;
+    f->ball.position.x += PLAYER_RADIUS;
+}
+
+/**
+ * @brief Tests every player against the ball, which visits a different
+ * player each time. Nobody moves: the grid counterpart reuses a current grid.
+ */
+static float bench_possession_scan(struct BenchFixture* f, unsigned long iterations) {
+    const struct Roster* roster = &f->scene.roster;
+    int hits = 0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        place_ball(f, i);
+        for (int idx = 0; idx < roster->count; idx++)
+            hits += is_colliding(roster, idx, &f->ball);
+    }
+    return (float)hits;
+}
+
+/** @brief The grid lookup update_ball_possessor() makes once the coaches brought the grid up to date. */
+static float bench_possession_lookup(struct BenchFixture* f, unsigned long iterations) {
+    const struct Roster* roster = &f->scene.roster;
+    struct Grid* grid = &f->scene.perception.grid;
+    int hits = 0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        place_ball(f, i);
+        const int found = grid_within(grid, f->ball.position.x, f->ball.position.y, f->ball.radius + grid->max_radius);
+        for (int k = 0; k < found; k++)
+            hits += is_colliding(roster, grid->hits[k], &f->ball);
+    }
+    return (float)hits;
+}
+
+/** @brief Every player's nearest teammate and opponent by testing every other player. */
+static float bench_nearest_scan(struct BenchFixture* f, unsigned long iterations) {
+    const struct Roster* roster = &f->scene.roster;
+    const int team_size = f->scene.team_size;
+    int acc = 0;
+    for (unsigned long it = 0; it < iterations; it++) {
+        load_frame(f, it);
+        for (int i = 0; i < roster->count; i++) {
+            int nearest[2] = { -1, -1 };
+            float best[2] = { 0.0f, 0.0f };
+            for (int j = 0; j < roster->count; j++) {
+                if (j == i)
+                    continue;
+                const int other = (j / team_size) != (i / team_size);
+                const float dx = roster->pos_x[j] - roster->pos_x[i];
+                const float dy = roster->pos_y[j] - roster->pos_y[i];
+                const float d2 = dx * dx + dy * dy;
+                if (nearest[other] < 0 || d2 < best[other]) {
+                    nearest[other] = j;
+                    best[other] = d2;
+                }
+            }
+            acc += nearest[0] + nearest[1];
+        }
+    }
+    return (float)acc;
+}
+
+static float bench_nearest_grid(struct BenchFixture* f, unsigned long iterations) {
+    const struct Roster* roster = &f->scene.roster;
+    struct Grid* grid = &f->scene.perception.grid;
+    const int team_size = f->scene.team_size;
+    int acc = 0;
+    for (unsigned long it = 0; it < iterations; it++) {
+        load_frame(f, it);
+        grid_update(grid, roster->views);
+        for (int i = 0; i < roster->count; i++) {
+            const int own = i < team_size ? 0 : team_size;
+            const int other = team_size - own;
+            acc += grid_nearest(grid, roster->pos_x[i], roster->pos_y[i], own, own + team_size, i);
+            acc += grid_nearest(grid, roster->pos_x[i], roster->pos_y[i], other, other + team_size, -1);
+        }
+    }
+    return (float)acc;
+}
+
+/**
+ * @brief A `team_size` a side scene on its sweep pitch, with BENCH_FRAMES
+ * frames of every player running straight and bouncing off the world edges.
+ * The first frame is loaded and the grid is current for it.
+ */
+static int setup_broadphase(struct BenchFixture* f, uint64_t seed, int team_size) {
+    struct MatchSpec spec = { .seed = seed, .stream = 0, .length = 120.0f, .tick_rate = DEFAULT_TICK_RATE,
+                              .team_size = team_size, .field = sweep_field(team_size) };
+    if (batch_setup_scene(&f->scene, &f->ball, &spec) != 0)
+        return -1;
+    const int count = f->scene.roster.count;
+    const Field* field = &f->scene.field;
+    f->frames = malloc(sizeof(struct Vec2) * BENCH_FRAMES * (size_t)count);
+    struct Vec2* velocity = malloc(sizeof(struct Vec2) * (size_t)count);
+    if (!f->frames || !velocity) {
+        free(velocity);
+        return -1;
+    }
+
+    struct Rng rng;
+    rng_seed(&rng, seed, (uint64_t)team_size);
+    const float dt = 1.0f / DEFAULT_TICK_RATE;
+    for (int i = 0; i < count; i++) {
+        f->frames[i].x = field->pitch_x + rng_float(&rng) * field->pitch_w;
+        f->frames[i].y = field->pitch_y + rng_float(&rng) * field->pitch_h;
+        const float angle = rng_float(&rng) * 6.2831853f;
+        velocity[i].x = cosf(angle) * MAX_PLAYER_VELOCITY * dt;
+        velocity[i].y = sinf(angle) * MAX_PLAYER_VELOCITY * dt;
+    }
+    for (int k = 1; k < BENCH_FRAMES; k++) {
+        for (int i = 0; i < count; i++) {
+            struct Vec2 p = f->frames[(size_t)(k - 1) * count + i];
+            p.x += velocity[i].x;
+            p.y += velocity[i].y;
+            if (p.x < PLAYER_RADIUS || p.x > field->width - PLAYER_RADIUS)
+                velocity[i].x = -velocity[i].x;
+            if (p.y < PLAYER_RADIUS || p.y > field->height - PLAYER_RADIUS)
+                velocity[i].y = -velocity[i].y;
+            f->frames[(size_t)k * count + i] = p;
+        }
+    }
+    free(velocity);
+    load_frame(f, 0);
+    grid_update(&f->scene.perception.grid, f->scene.roster.views);
+    return 0;
+}
+
+/** @brief Writes the smallest player count (both teams) from which `grid` beat `scan`, or null. */
+static void write_crossover(FILE* out, const char* name, const double* scan, const double* grid, int sizes,
+                            const char* tail) {
+    int from = -1;
+    for (int s = sizes - 1; s >= 0 && grid[s] < scan[s]; s--)
+        from = s;
+    if (from < 0) {
+        fprintf(stderr, "  %s: the scan wins at every size\n", name);
+        fprintf(out, "    \"%s_crossover_players\": null%s\n", name, tail);
+        return;
+    }
+    fprintf(stderr, "  %s: the grid wins from %d players\n", name, 2 * broadphase_sizes[from]);
+    fprintf(out, "    \"%s_crossover_players\": %d%s\n", name, 2 * broadphase_sizes[from], tail);
+}
+
+/**
+ * @brief Times each broadphase case per team size in ns per tick (the cases
+ * that load frames net of loading them), and where the grid starts to beat
+ * the plain scans. The possession lookup is timed without the grid update:
+ * in a match it reuses the grid the coaches' proximity queries brought up to date.
+ */
+static int run_broadphase(FILE* out, uint64_t seed, double batch_seconds) {
+    enum { FRAMES, GRID_UPDATE, NEAREST_SCAN, NEAREST_GRID, COLLIDE, POSSESSION_SCAN, POSSESSION_LOOKUP, CASES };
+    static const BenchFn cases[CASES] = {
+        bench_frames, bench_grid_update, bench_nearest_scan, bench_nearest_grid, bench_collide,
+        bench_possession_scan, bench_possession_lookup,
+    };
+    enum { SIZES = (int)(sizeof(broadphase_sizes) / sizeof(broadphase_sizes[0])) };
+    double net[CASES][SIZES];
+
+    fprintf(out, "  \"broadphase\": {\n    \"sizes\": [\n");
+    for (int s = 0; s < SIZES; s++) {
+        const int team_size = broadphase_sizes[s];
+        struct BenchFixture* f = calloc(1, sizeof(*f));
+        if (!f || setup_broadphase(f, seed, team_size) != 0) {
+            if (f && f->scene.first_team)
+                destroy_scene(&f->scene);
+            if (f)
+                free(f->frames);
+            free(f);
+            return -1;
+        }
+
+        double median[CASES];
+        for (int c = 0; c < CASES; c++) {
+            double ns_per_op[BENCH_SAMPLES];
+            time_case(cases[c], f, batch_seconds, ns_per_op);
+            median[c] = ns_per_op[BENCH_SAMPLES / 2];
+            const bool loads_frames = c > FRAMES && c < POSSESSION_SCAN;
+            net[c][s] = loads_frames ? fmax(median[c] - median[FRAMES], 0.0) : median[c];
+        }
+        destroy_scene(&f->scene);
+        free(f->frames);
+        free(f);
+
+        fprintf(stderr, "  %3d a side: update %7.1f, possession %7.1f scan %7.1f lookup, "
+                        "nearest %9.1f scan %9.1f grid, bodies %8.1f ns/tick\n", team_size, net[GRID_UPDATE][s],
+                net[POSSESSION_SCAN][s], net[POSSESSION_LOOKUP][s], net[NEAREST_SCAN][s], net[NEAREST_GRID][s],
+                net[COLLIDE][s]);
+        fprintf(out, "      {\"team_size\": %d, \"frame_ns\": %.2f, \"grid_update_ns\": %.2f, "
+                     "\"possession_scan_ns\": %.2f, \"possession_lookup_ns\": %.2f, "
+                     "\"nearest_scan_ns\": %.2f, \"nearest_grid_ns\": %.2f, \"collide_ns\": %.2f}%s\n",
+                team_size, net[FRAMES][s], net[GRID_UPDATE][s], net[POSSESSION_SCAN][s], net[POSSESSION_LOOKUP][s],
+                net[NEAREST_SCAN][s], net[NEAREST_GRID][s], net[COLLIDE][s], s == SIZES - 1 ? "" : ",");
+    }
+    fprintf(out, "    ],\n");
+    write_crossover(out, "possession", net[POSSESSION_SCAN], net[POSSESSION_LOOKUP], SIZES, ",");
+    write_crossover(out, "nearest", net[NEAREST_SCAN], net[NEAREST_GRID], SIZES, "");
+    fprintf(out, "  },\n");
+    return 0;
+}
+
+static void fill_specs(struct MatchSpec* specs, int count, uint64_t seed, float length) {
+    for (int i = 0; i < count; i++) {
+        specs[i].seed = seed;
+        specs[i].stream = (uint64_t)i;
+        specs[i].length = length;
+        specs[i].tick_rate = DEFAULT_TICK_RATE;
+        specs[i].record_path = NULL;
+        specs[i].coaches[0] = NULL;
+        specs[i].coaches[1] = NULL;
+        specs[i].team_size = 0;
+        memset(&specs[i].field, 0, sizeof(specs[i].field));
+        specs[i].body_collisions = false;
+        specs[i].checkpoint_path = NULL;
+        specs[i].checkpoint_every = 0.0f;
+        specs[i].resume_path = NULL;
+    }
+}
+
+/** @brief Plays `count` matches one after the other on this thread; returns the seconds taken, or -1. */
+static double play_matches(uint64_t seed, int count, float length, bool body_collisions, unsigned long* ticks) {
+    struct MatchSpec spec;
+    struct MatchResult result;
+
+    *ticks = 0;
+    const double start = now_seconds();
+    for (int i = 0; i < count; i++) {
+        fill_specs(&spec, 1, seed, length);
+        spec.stream = (uint64_t)i;
+        spec.body_collisions = body_collisions;
+        if (run_match(&spec, &result) != 0)
+            return -1.0;
+        *ticks += result.ticks;
+        match_result_free(&result);
+    }
+    return now_seconds() - start;
+}
+
+/**
+ * @brief Plays `count` matches on this thread, then the same ones again
+ * with body collisions. The matches play out differently once players
+ * push each other, so the overhead is per tick, not per match.
+ */
+static int run_macro(FILE* out, uint64_t seed, int count, float length) {
+    unsigned long ticks, solid_ticks;
+    const double elapsed = play_matches(seed, count, length, false, &ticks);
+    const double solid_elapsed = play_matches(seed, count, length, true, &solid_ticks);
+    if (elapsed < 0.0 || solid_elapsed < 0.0)
+        return -1;
+    const double ns_per_tick = elapsed * 1e9 / (double)ticks;
+    const double solid_ns_per_tick = solid_elapsed * 1e9 / (double)solid_ticks;
+    const double overhead = solid_ns_per_tick / ns_per_tick - 1.0;
+
+    fprintf(stderr, "  %d matches, %lu ticks in %.3f s (%.0f ticks/s), %+.1f%% per tick with body collisions\n",
+            count, ticks, elapsed, ticks / elapsed, overhead * 100.0);
+    fprintf(out, "  \"macro\": {\"matches\": %d, \"match_length\": %.1f, \"ticks\": %lu, \"seconds\": %.6f, "
+                 "\"ticks_per_sec\": %.1f, \"ns_per_tick\": %.2f, \"matches_per_sec_per_core\": %.3f, "
+                 "\"collisions_ns_per_tick\": %.2f, \"collisions_overhead\": %.4f},\n",
+            count, length, ticks, elapsed, ticks / elapsed, ns_per_tick, count / elapsed, solid_ns_per_tick, overhead);
+    return 0;
+}
+
+/** @brief batch_run() on 1, 2, 4 ... up to `max_threads` workers, `per_thread` matches each. */
+static int run_scaling(FILE* out, uint64_t seed, int max_threads, int per_thread, float length) {
+    const int most = max_threads * per_thread;
+    struct MatchSpec* specs = malloc(sizeof(*specs) * (size_t)most);
+    struct MatchResult* results = calloc((size_t)most, sizeof(*results));
+    if (!specs || !results) {
+        free(specs);
+        free(results);
+        return -1;
+    }
+    fill_specs(specs, most, seed, length);
+
+    double single = 0.0;
+    fprintf(out, "  \"scaling\": [\n");
+    for (int threads = 1;; threads = threads * 2 < max_threads ? threads * 2 : max_threads) {
+        const int count = threads * per_thread;
+        const double start = now_seconds();
+        if (batch_run(specs, results, count, threads, true) != 0) {
+            free(specs);
+            free(results);
+            return -1;
+        }
+        const double elapsed = now_seconds() - start;
+
+        unsigned long ticks = 0;
+        for (int i = 0; i < count; i++) {
+            ticks += results[i].ticks;
+            match_result_free(&results[i]);
+        }
+        const double rate = count / elapsed;
+        if (threads == 1)
+            single = rate;
+        const double speedup = rate / single;
+
+        fprintf(stderr, "  %3d threads: %8.2f matches/s (x%.2f)\n", threads, rate, speedup);
+        fprintf(out, "    {\"threads\": %d, \"matches\": %d, \"seconds\": %.6f, \"ticks_per_sec\": %.1f, "
+                     "\"matches_per_sec\": %.3f, \"matches_per_sec_per_core\": %.3f, "
+                     "\"speedup\": %.3f, \"efficiency\": %.3f}%s\n",
+                threads, count, elapsed, ticks / elapsed, rate, rate / threads, speedup,
+                speedup / threads, threads == max_threads ? "" : ",");
+        if (threads == max_threads)
+            break;
+    }
+    fprintf(out, "  ],\n");
+
+    free(specs);
+    free(results);
+    return 0;
+}
+
+/**
+ * @brief Plays `count` matches per team size on this thread. Each pitch keeps
+ * the default area per player, so only the entity count changes the work.
+ */
+static int run_roster(FILE* out, uint64_t seed, int count, float length) {
+    const int sizes = (int)(sizeof(roster_sizes) / sizeof(roster_sizes[0]));
+
+    fprintf(out, "  \"roster\": [\n");
+    for (int s = 0; s < sizes; s++) {
+        const int team_size = roster_sizes[s];
+        struct MatchSpec spec;
+        fill_specs(&spec, 1, seed, length);
+        spec.team_size = team_size;
+        spec.field = sweep_field(team_size);
+
+        struct MatchResult result;
+        unsigned long ticks = 0;
+        const double start = now_seconds();
+        for (int i = 0; i < count; i++) {
+            spec.stream = (uint64_t)i;
+            if (run_match(&spec, &result) != 0)
+                return -1;
+            ticks += result.ticks;
+            match_result_free(&result);
+        }
+        const double elapsed = now_seconds() - start;
+        const double ns_per_tick = elapsed * 1e9 / (double)ticks;
+
+        fprintf(stderr, "  %2d a side on %4.0fx%-4.0f %9.0f ns/tick %7.1f ns/player-tick\n", team_size,
+                spec.field.pitch_w, spec.field.pitch_h, ns_per_tick, ns_per_tick / (2 * team_size));
+        fprintf(out, "    {\"team_size\": %d, \"pitch_w\": %.1f, \"pitch_h\": %.1f, \"matches\": %d, "
+                     "\"ticks\": %lu, \"seconds\": %.6f, \"ns_per_tick\": %.2f, \"ns_per_player_tick\": %.3f}%s\n",
+                team_size, spec.field.pitch_w, spec.field.pitch_h, count, ticks, elapsed, ns_per_tick,
+                ns_per_tick / (2 * team_size), s == sizes - 1 ? "" : ",");
+    }
+    fprintf(out, "  ]\n");
+    return 0;
+}
+
+static void print_usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [--quick] [--seed N] [--matches N] [--threads N] [--length SECONDS]\n"
+            "          [--output FILE] [--log SPEC]\n"
+            "  --quick            shorter batches and fewer matches (smoke test)\n"
+            "  --seed N           seed of every scene and match (default %d)\n"
+            "  --matches N        single-thread matches, matches per worker when scaling and\n"
+            "                     matches per team size in the roster sweep (default 8)\n"
+            "  --threads N        most workers in the scaling runs (default: one per online CPU)\n"
+            "  --length SECONDS   match length in game seconds (default 120)\n"
+            "  --output FILE      write the JSON there instead of stdout\n"
+            "  --log SPEC         log levels while benchmarking (default off)\n",
+            prog, SEED);
+}
+
+int main(int argc, char **argv) {
+    uint64_t seed = SEED;
+    int matches = 8;
+    int threads = 0;
+    float match_length = 120.0f;
+    double batch_seconds = 0.1;
+    const char *output = NULL;
+
+    log_configure("off");
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--quick") == 0) {
+            batch_seconds = 0.01;
+            matches = 2;
+        } else if (strcmp(arg, "--seed") == 0 && value) {
+            seed = strtoull(value, NULL, 10);
+            i++;
+        } else if (strcmp(arg, "--matches") == 0 && value) {
+            matches = atoi(value);
+            i++;
+        } else if (strcmp(arg, "--threads") == 0 && value) {
+            threads = atoi(value);
+            i++;
+        } else if (strcmp(arg, "--length") == 0 && value) {
+            match_length = strtof(value, NULL);
+            i++;
+        } else if (strcmp(arg, "--output") == 0 && value) {
+            output = value;
+            i++;
+        } else if (strcmp(arg, "--log") == 0 && value && log_configure(value) == 0) {
+            i++;
+        } else {
+            print_usage(argv[0]);
+            return (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) ? 0 : 1;
+        }
+    }
+
+    if (matches < 1 || match_length <= 0.0f) {
+        fprintf(stderr, "match count and length must be positive\n");
+        return 1;
+    }
+    if (threads < 1)
+        threads = batch_cpu_count();
+
+    FILE *out = output ? fopen(output, "w") : stdout;
+    if (!out) {
+        perror(output);
+        return 1;
+    }
+
+    struct BenchFixture *fixture = malloc(sizeof(*fixture));
+    if (!fixture || setup_fixture(fixture, seed) != 0) {
+        fprintf(stderr, "out of memory\n");
+        free(fixture);
+        return 1;
+    }
+
+    fprintf(out, "{\n  \"schema\": %d,\n  \"seed\": %" PRIu64 ",\n  \"cpus\": %d,\n", BENCH_SCHEMA, seed,
+            batch_cpu_count());
+#if defined(__VERSION__)
+    fprintf(out, "  \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+    fprintf(out, "  \"profiler_compiled_in\": %s,\n", SOCCER_PROFILER ? "true" : "false");
+
+    fprintf(stderr, "micro\n");
+    fprintf(out, "  \"micro\": [\n");
+    const int cases = (int)(sizeof(micro_cases) / sizeof(micro_cases[0]));
+    for (int i = 0; i < cases; i++)
+        run_micro(out, &micro_cases[i], fixture, batch_seconds, i == cases - 1);
+    fprintf(out, "  ],\n");
+    destroy_scene(&fixture->scene);
+    free(fixture);
+
+    int status = 0;
+    fprintf(stderr, "broadphase\n");
+    if (run_broadphase(out, seed, batch_seconds) != 0)
+        status = 1;
+    fprintf(stderr, "macro\n");
+    if (status == 0 && run_macro(out, seed, matches, match_length) != 0)
+        status = 1;
+    fprintf(stderr, "scaling\n");
+    if (status == 0 && run_scaling(out, seed, threads, matches, match_length) != 0)
+        status = 1;
+    fprintf(stderr, "roster\n");
+    if (status == 0 && run_roster(out, seed, matches, match_length) != 0)
+        status = 1;
+    fprintf(out, "}\n");
+
+    if (out != stdout)
+        fclose(out);
+    if (status != 0)
+        fprintf(stderr, "a benchmark match failed\n");
+    return status;
+}
@@ -0,0 +1,57 @@
+# Checks that a match resumed from a checkpoint in another process plays on
+# bit for bit. Run with cmake -P and:
+#   HEADLESS  path to soccersim_headless
+#   WORK_DIR  scratch directory for the checkpoints and CSVs
+#   NAME      prefix of the scratch files
+#   ARGS      match arguments (;-separated), e.g. --seed;5;--length;60
+#
+# Three runs of the same match:
+#   a  plays it through, checkpointing every 25 s (the last one is kept)
+#   b  resumes from a's last checkpoint in a new process, checkpointing every 5 s
+#   c  plays it through, checkpointing every 5 s
+# b and c must end on the same score and violation tallies as a, and b's
+# last checkpoint must be byte-identical to c's: same tick, same state.
+
+foreach(var HEADLESS WORK_DIR NAME ARGS)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "CheckpointResume.cmake: ${var} is not set")
+    endif()
+endforeach()
+
+set(base ${WORK_DIR}/${NAME})
+file(REMOVE ${base}_a.sckp ${base}_b.sckp ${base}_c.sckp)
+
+function(play run)
+    execute_process(
+        COMMAND ${HEADLESS} ${ARGN} --violations ${base}_${run}.csv --log off
+        OUTPUT_VARIABLE out
+        RESULT_VARIABLE status)
+    if(NOT status EQUAL 0)
+        message(FATAL_ERROR "run ${run} failed (${status}): ${ARGN}")
+    endif()
+    # first line: "seed S stream N: team 1 X - Y team 2"
+    string(REGEX MATCH "^[^\n]*" score "${out}")
+    set(score_${run} "${score}" PARENT_SCOPE)
+endfunction()
+
+play(a ${ARGS} --checkpoint ${base}_a.sckp --checkpoint-every 25)
+play(b ${ARGS} --resume ${base}_a.sckp --checkpoint ${base}_b.sckp --checkpoint-every 5)
+play(c ${ARGS} --checkpoint ${base}_c.sckp --checkpoint-every 5)
+
+foreach(run b c)
+    if(NOT score_${run} STREQUAL score_a)
+        message(FATAL_ERROR "run ${run} ended '${score_${run}}', the full match '${score_a}'")
+    endif()
+    execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${base}_a.csv ${base}_${run}.csv
+                    RESULT_VARIABLE differ)
+    if(differ)
+        message(FATAL_ERROR "run ${run}: violation tallies differ from the full match")
+    endif()
+endforeach()
+
+execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${base}_b.sckp ${base}_c.sckp
+                RESULT_VARIABLE differ)
+if(differ)
+    message(FATAL_ERROR "the resumed match's last checkpoint differs from the full match's")
+endif()
+message(STATUS "${NAME}: resumed match matches the full match (${score_a})")
@@ -17,7 +17,10 @@
 // --- Entity Physics ---
 #define BALL_RADIUS 10.0f
 #define PLAYER_RADIUS 16.0f
-#define PLAYER_COUNT 6
+/** @brief Players per side when a scene does not ask for another size (Scene::team_size). */
+#define DEFAULT_TEAM_SIZE 6
+/** @brief Largest team size init_scene() builds; the pair distance table grows with its square. */
+#define MAX_TEAM_SIZE 255
 
 #define MAX_TALENT_PER_PLAYER 20
 #define MAX_TALENT_PER_SKILL 10
@@ -25,25 +28,28 @@
 #define MAX_BALL_VELOCITY 350.0f
 
 /** * @brief Ball friction coefficient. 
- * Multiplied by velocity every frame; 1.0 is no friction, 0.0 is an immediate stop.
+ * Velocity is multiplied by this once per 1/FRICTION_REFERENCE_RATE seconds
+ * (scaled by dt, so it does not depend on the tick rate);
+ * 1.0 is no friction, 0.0 is an immediate stop.
  */
 #define FRICTION 0.98f
+#define FRICTION_REFERENCE_RATE 60.0f
+
+/** @brief Below this speed (px/s) a free ball comes to rest. */
+#define BALL_STOP_SPEED 10.0f
 
 // --- Pitch & UI Layout ---
-#define SCREEN_WIDTH 1000
-#define SCREEN_HEIGHT 700
+// Every scene carries its own geometry (see entities/field.h); these are the
+// defaults field_default() builds it from.
+#define DEFAULT_SCREEN_WIDTH 1000
+#define DEFAULT_SCREEN_HEIGHT 700
 
+/** @brief Space around the pitch; twice as much above it, for the scoreboard. */
 #define PITCH_MARGIN     40.0f
-#define PITCH_Y          (PITCH_MARGIN * 2)
-#define PITCH_X          (PITCH_MARGIN)
-#define PITCH_W          (SCREEN_WIDTH - (PITCH_MARGIN * 2))
-#define PITCH_H          (SCREEN_HEIGHT - PITCH_Y - PITCH_MARGIN)
-
-#define CENTER_Y         ((PITCH_H / 2) + PITCH_Y)
-#define CENTER_X         (SCREEN_WIDTH / 2)
+#define CENTER_CIRCLE_RADIUS 90.0f
 
-#define GOAL_WIDTH 35
-#define GOAL_HEIGHT 120
+#define DEFAULT_GOAL_WIDTH 35
+#define DEFAULT_GOAL_HEIGHT 120
 #define GRASS_STRIPE_COUNT 10
 
 #endif
\ No newline at end of file
@@ -0,0 +1,313 @@
+#define _POSIX_C_SOURCE 200112L // clock_gettime, nanosleep, strtok_r
+#include "log.h"
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** @brief How often the flusher wakes up to drain the rings. */
+#define LOG_FLUSH_INTERVAL_MS 5
+/** @brief Rate-limit entries per thread, probed from a hash of the format pointer. */
+#define LOG_LIMIT_SLOTS 32
+
+unsigned char log_thresholds[LOG_CATEGORY_COUNT] = { LOG_INFO, LOG_INFO, LOG_INFO };
+
+static const char *const level_names[] = { "off", "error", "warn", "info", "debug" };
+static const char *const category_names[LOG_CATEGORY_COUNT] = { "match", "rules", "engine" };
+
+struct LogRecord {
+    unsigned char level;
+    unsigned char category;
+    char text[LOG_MESSAGE_MAX];
+};
+
+/** @brief Rate-limit state of one message format. */
+struct LogLimit {
+    const char *format;         /**< The format string literal, compared by address. */
+    uint64_t window_start;      /**< Monotonic ns. */
+    unsigned count;             /**< Messages in the current window. */
+    unsigned suppressed;        /**< Of those, not written. */
+    unsigned char level;
+    unsigned char category;
+};
+
+/**
+ * @brief One thread's single-producer / single-consumer queue.
+ * The owner only advances head, the flusher only advances tail; both are
+ * free-running counters used modulo LOG_RING_SLOTS.
+ */
+struct LogRing {
+    struct LogRecord records[LOG_RING_SLOTS];
+    unsigned head;
+    unsigned tail;
+    unsigned dropped;           /**< Messages lost to a full ring since the flusher last looked. */
+    int closed;                 /**< The owning thread exited; free once drained. */
+    struct LogLimit limits[LOG_LIMIT_SLOTS];    /**< Owner only. */
+    struct LogRing *next;       /**< Guarded by `lock`. */
+};
+
+static pthread_once_t once = PTHREAD_ONCE_INIT;
+static pthread_key_t ring_key;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;   // ring list, output stream, lifecycle
+static struct LogRing *rings;
+static FILE *output;
+static pthread_t flusher;
+static int started;             // start() ran: the key exists
+static int flushing;            // the flusher thread is running; otherwise messages are written directly
+static int stopping;
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void write_record(const struct LogRecord *record) {
+    fprintf(output ? output : stderr, "%-5s %s: %s\n",
+            level_names[record->level], category_names[record->category], record->text);
+}
+
+/** @brief Writes out whatever `ring` holds. Called with `lock` held. */
+static void drain(struct LogRing *ring) {
+    unsigned tail = ring->tail;
+    const unsigned head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    for (; tail != head; tail++)
+        write_record(&ring->records[tail % LOG_RING_SLOTS]);
+    __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+
+    const unsigned dropped = __atomic_exchange_n(&ring->dropped, 0, __ATOMIC_RELAXED);
+    if (dropped) {
+        struct LogRecord note = { LOG_WARN, LOG_ENGINE, "" };
+        snprintf(note.text, sizeof(note.text), "%u log messages dropped (ring full)", dropped);
+        write_record(&note);
+    }
+}
+
+/** @brief Drains every ring and frees those whose thread has exited. */
+static void drain_all(void) {
+    pthread_mutex_lock(&lock);
+    for (struct LogRing **link = &rings; *link;) {
+        struct LogRing *ring = *link;
+        // read `closed` first: everything the owner pushed before closing is then visible
+        const int closed = __atomic_load_n(&ring->closed, __ATOMIC_ACQUIRE);
+        drain(ring);
+        if (closed) {
+            *link = ring->next;
+            free(ring);
+        } else {
+            link = &ring->next;
+        }
+    }
+    fflush(output ? output : stderr);
+    pthread_mutex_unlock(&lock);
+}
+
+static void *flush_loop(void *unused) {
+    (void)unused;
+    const struct timespec interval = { 0, LOG_FLUSH_INTERVAL_MS * 1000000L };
+    while (!__atomic_load_n(&stopping, __ATOMIC_ACQUIRE)) {
+        drain_all();
+        nanosleep(&interval, NULL);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Formats one message into the calling thread's ring (or straight to
+ * the output when there is no flusher or no ring).
+ */
+static void emit(struct LogRing *ring, int level, int category, const char *format, va_list args) {
+    struct LogRecord local;
+    struct LogRecord *record = &local;
+    const bool queued = ring && __atomic_load_n(&flushing, __ATOMIC_ACQUIRE);
+    if (queued) {
+        const unsigned tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        if (ring->head - tail >= LOG_RING_SLOTS) {
+            __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        record = &ring->records[ring->head % LOG_RING_SLOTS];
+    }
+
+    record->level = (unsigned char)level;
+    record->category = (unsigned char)category;
+    vsnprintf(record->text, sizeof(record->text), format, args);
+
+    if (queued) {
+        __atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+    } else {
+        pthread_mutex_lock(&lock);
+        write_record(record);
+        pthread_mutex_unlock(&lock);
+    }
+}
+
+static void emit_formatted(struct LogRing *ring, int level, int category, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    emit(ring, level, category, format, args);
+    va_end(args);
+}
+
+static void report_suppressed(struct LogRing *ring, struct LogLimit *limit) {
+    if (limit->suppressed)
+        emit_formatted(ring, limit->level, limit->category, "suppressed %u repeats of \"%s\"",
+                       limit->suppressed, limit->format);
+    limit->suppressed = 0;
+}
+
+/**
+ * @brief The limit entry of `format`, claimed (and reset) if it has none.
+ * * Entries are probed linearly from the format's hash, so formats that hash
+ * alike keep separate counts. An entry is only ever replaced, never emptied,
+ * which keeps every probe chain intact. With the table full, an entry whose
+ * window has ended is reused first, else the one with the oldest window;
+ * either way its suppressed count is reported before it is taken over.
+ */
+static struct LogLimit *find_limit(struct LogRing *ring, int level, int category, const char *format,
+                                   uint64_t now) {
+    const unsigned home = (unsigned)(((uintptr_t)format >> 3) % LOG_LIMIT_SLOTS);
+    struct LogLimit *victim = NULL;
+    for (unsigned probe = 0; probe < LOG_LIMIT_SLOTS; probe++) {
+        struct LogLimit *limit = &ring->limits[(home + probe) % LOG_LIMIT_SLOTS];
+        if (limit->format == format)
+            return limit;
+        if (!limit->format) {
+            victim = limit;
+            break;
+        }
+        if (!victim || limit->window_start < victim->window_start)
+            victim = limit;
+    }
+    report_suppressed(ring, victim);
+    victim->format = format;
+    victim->window_start = now;
+    victim->count = 0;
+    victim->level = (unsigned char)level;
+    victim->category = (unsigned char)category;
+    return victim;
+}
+
+/** @brief Counts a message against its format's window; false if it should be suppressed. */
+static bool admit(struct LogRing *ring, int level, int category, const char *format) {
+    const uint64_t now = monotonic_ns();
+    struct LogLimit *limit = find_limit(ring, level, category, format, now);
+    if (now - limit->window_start >= (uint64_t)LOG_WINDOW_MS * 1000000u) {
+        report_suppressed(ring, limit);
+        limit->window_start = now;
+        limit->count = 0;
+    }
+    if (++limit->count <= LOG_BURST)
+        return true;
+    limit->suppressed++;
+    return false;
+}
+
+/** @brief Thread exit: report what the limiter held back and hand the ring to the flusher to free. */
+static void close_ring(void *data) {
+    struct LogRing *ring = data;
+    for (int i = 0; i < LOG_LIMIT_SLOTS; i++)
+        report_suppressed(ring, &ring->limits[i]);
+    __atomic_store_n(&ring->closed, 1, __ATOMIC_RELEASE);
+}
+
+static void start(void) {
+    pthread_key_create(&ring_key, close_ring);
+    __atomic_store_n(&started, 1, __ATOMIC_RELEASE);
+    if (pthread_create(&flusher, NULL, flush_loop, NULL) == 0)
+        __atomic_store_n(&flushing, 1, __ATOMIC_RELEASE);
+    atexit(log_shutdown);
+}
+
+static struct LogRing *current_ring(void) {
+    pthread_once(&once, start);
+    struct LogRing *ring = pthread_getspecific(ring_key);
+    if (ring)
+        return ring;
+
+    ring = calloc(1, sizeof(*ring));
+    if (!ring)
+        return NULL;    // messages are then written directly, without rate limiting
+    pthread_mutex_lock(&lock);
+    ring->next = rings;
+    rings = ring;
+    pthread_mutex_unlock(&lock);
+    pthread_setspecific(ring_key, ring);
+    return ring;
+}
+
+void log_write(int level, int category, const char *format, ...) {
+    struct LogRing *ring = current_ring();
+    if (ring && !admit(ring, level, category, format))
+        return;
+
+    va_list args;
+    va_start(args, format);
+    emit(ring, level, category, format, args);
+    va_end(args);
+}
+
+static int parse_name(const char *name, const char *const *names, int count) {
+    for (int i = 0; i < count; i++)
+        if (strcmp(name, names[i]) == 0)
+            return i;
+    return -1;
+}
+
+int log_configure(const char *spec) {
+    char buffer[128];
+    if (strlen(spec) >= sizeof(buffer))
+        return -1;
+    strcpy(buffer, spec);
+
+    unsigned char thresholds[LOG_CATEGORY_COUNT];
+    memcpy(thresholds, log_thresholds, sizeof(thresholds));
+
+    char *save = NULL;
+    for (char *item = strtok_r(buffer, ",", &save); item; item = strtok_r(NULL, ",", &save)) {
+        char *equals = strchr(item, '=');
+        if (!equals) {
+            const int level = parse_name(item, level_names, LOG_DEBUG + 1);
+            if (level < 0)
+                return -1;
+            memset(thresholds, level, sizeof(thresholds));
+            continue;
+        }
+        *equals = '\0';
+        const int category = parse_name(item, category_names, LOG_CATEGORY_COUNT);
+        const int level = parse_name(equals + 1, level_names, LOG_DEBUG + 1);
+        if (category < 0 || level < 0)
+            return -1;
+        thresholds[category] = (unsigned char)level;
+    }
+
+    memcpy(log_thresholds, thresholds, sizeof(thresholds));
+    return 0;
+}
+
+void log_set_output(FILE *out) {
+    pthread_mutex_lock(&lock);
+    output = out;
+    pthread_mutex_unlock(&lock);
+}
+
+void log_shutdown(void) {
+    if (!__atomic_load_n(&started, __ATOMIC_ACQUIRE))
+        return;     // nothing was ever logged
+    struct LogRing *ring = pthread_getspecific(ring_key);
+    if (ring) {
+        for (int i = 0; i < LOG_LIMIT_SLOTS; i++)
+            report_suppressed(ring, &ring->limits[i]);
+    }
+
+    if (!__atomic_exchange_n(&flushing, 0, __ATOMIC_ACQ_REL))
+        return;
+    // from here on messages are written directly; the flusher only has to finish
+    __atomic_store_n(&stopping, 1, __ATOMIC_RELEASE);
+    pthread_join(flusher, NULL);
+    drain_all();
+}
@@ -0,0 +1,77 @@
+/**
+ * @file log.h
+ * @brief Leveled, per-category logging that stays off the simulation's back.
+ * * Every thread formats its messages into its own lock-free ring buffer and a
+ * background thread writes them out, so a tick never waits on stdio. The same
+ * message format repeated by one thread is rate-limited (LOG_BURST per
+ * LOG_WINDOW_MS), which keeps a misbehaving coach from flooding a batch run.
+ * The suppressed count is reported by that thread, not on a timer: the next
+ * time it logs the format after the window ended, when the format's entry is
+ * given to another one, when the thread exits or at log_shutdown().
+ *
+ * A disabled LOG() costs one load and one branch: the arguments are not even
+ * evaluated. The flusher starts on the first enabled message and is stopped
+ * (and everything pending written) by log_shutdown(), which also runs at exit.
+ */
+
+#ifndef ENGINE_CORE_LOG_H
+#define ENGINE_CORE_LOG_H
+
+#include <stdio.h>
+
+/** @brief Severity; a message is written if its level is <= its category's threshold. */
+enum LogLevel {
+    LOG_OFF = 0,        /**< Only as a threshold: the category is silent. */
+    LOG_ERROR,
+    LOG_WARN,
+    LOG_INFO,
+    LOG_DEBUG
+};
+
+/** @brief What a message is about, each with its own threshold. */
+enum LogCategory {
+    LOG_MATCH,          /**< Match flow: goals, outs, kick-offs, full time. */
+    LOG_RULES,          /**< Referee corrections of coach decisions. */
+    LOG_ENGINE,         /**< Engine anomalies that were worked around. */
+    LOG_CATEGORY_COUNT
+};
+
+/** @brief Messages with the same format a thread may write per window before the rest are counted only. */
+#define LOG_BURST 8
+#define LOG_WINDOW_MS 1000
+
+/** @brief Longest message kept (longer ones are truncated), and records per thread ring. */
+#define LOG_MESSAGE_MAX 120
+#define LOG_RING_SLOTS 256
+
+/** @brief Per-category thresholds (LogLevel); change them with log_configure(). */
+extern unsigned char log_thresholds[LOG_CATEGORY_COUNT];
+
+#define LOG(level, category, ...)                                   \
+    do {                                                            \
+        if ((level) <= log_thresholds[(category)])                  \
+            log_write((level), (category), __VA_ARGS__);            \
+    } while (0)
+
+#if defined(__GNUC__)
+__attribute__((format(printf, 3, 4)))
+#endif
+void log_write(int level, int category, const char *format, ...);
+
+/**
+ * @brief Sets thresholds from a spec such as "warn" (every category) or
+ * "rules=off,match=info". Names: off, error, warn, info, debug; match, rules, engine.
+ * @return 0 on success, -1 on a malformed spec (thresholds are then unchanged).
+ */
+int log_configure(const char *spec);
+
+/** @brief Where messages go (default stderr). Set it before the first message. */
+void log_set_output(FILE *out);
+
+/**
+ * @brief Writes everything pending and stops the flusher thread.
+ * Later messages are written synchronously. Safe to call more than once.
+ */
+void log_shutdown(void);
+
+#endif
@@ -0,0 +1,232 @@
+#define _POSIX_C_SOURCE 200112L // clock_gettime
+#include "profile.h"
+#include "log.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+int profile_enabled;
+
+static const char *const phase_names[PROFILE_PHASE_COUNT] = {
+    "think", "act", "possession", "integrate", "bodies", "referee", "rollout",
+    "draw_pitch", "draw_players", "draw_ball", "draw_hud", "present"
+};
+
+/** @brief One timed span, kept for the trace. */
+struct ProfileSpan {
+    uint64_t start;
+    uint32_t duration;          /**< ns; saturates at ~4 s. */
+    uint32_t phase;
+};
+
+/** @brief Everything one thread measured. Only the owner writes it; it is read after the threads are done. */
+struct ProfileThread {
+    uint64_t buckets[PROFILE_PHASE_COUNT][PROFILE_BUCKETS];
+    uint64_t count[PROFILE_PHASE_COUNT];
+    uint64_t total[PROFILE_PHASE_COUNT];
+    uint64_t max[PROFILE_PHASE_COUNT];
+    struct ProfileSpan *spans;
+    size_t span_count;
+    size_t span_capacity;
+    uint64_t spans_dropped;
+    int suspended;              /**< PROFILE_SUSPEND depth; spans are dropped while it is above 0. */
+    int id;                     /**< Trace tid, in order of first use. */
+    struct ProfileThread *next;
+};
+
+static pthread_once_t once = PTHREAD_ONCE_INIT;
+static pthread_key_t thread_key;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;   // thread list
+static struct ProfileThread *threads;
+static int thread_count;
+static uint64_t epoch;          // profile_start() time, trace timestamps are relative to it
+static int tracing;
+static char *trace_path;
+
+uint64_t profile_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec + 1;
+}
+
+/** @brief 0-3 map to themselves, then the top bit picks a power of two and the next two bits a quarter of it. */
+static int bucket_of(uint64_t ns) {
+    if (ns < 4)
+        return (int)ns;
+    const int msb = 63 - __builtin_clzll(ns);
+    return 4 * (msb - 1) + (int)((ns >> (msb - 2)) & 3);
+}
+
+/** @brief Smallest value that falls in `bucket`. */
+static uint64_t bucket_floor(int bucket) {
+    if (bucket < 4)
+        return (uint64_t)bucket;
+    const int msb = bucket / 4 + 1;
+    return (uint64_t)(4 + bucket % 4) << (msb - 2);
+}
+
+static void make_key(void) {
+    pthread_key_create(&thread_key, NULL);     // blocks outlive their thread until the report
+}
+
+static struct ProfileThread *current_thread(void) {
+    pthread_once(&once, make_key);
+    struct ProfileThread *thread = pthread_getspecific(thread_key);
+    if (thread)
+        return thread;
+
+    thread = calloc(1, sizeof(*thread));
+    if (!thread)
+        return NULL;
+    pthread_mutex_lock(&lock);
+    thread->id = ++thread_count;
+    thread->next = threads;
+    threads = thread;
+    pthread_mutex_unlock(&lock);
+    pthread_setspecific(thread_key, thread);
+    return thread;
+}
+
+static void keep_span(struct ProfileThread *thread, int phase, uint64_t start, uint64_t duration) {
+    if (thread->span_count == thread->span_capacity) {
+        const size_t capacity = thread->span_capacity ? thread->span_capacity * 2 : 4096;
+        struct ProfileSpan *spans = capacity <= PROFILE_TRACE_MAX_EVENTS
+                                        ? realloc(thread->spans, capacity * sizeof(*spans)) : NULL;
+        if (!spans) {
+            thread->spans_dropped++;
+            return;
+        }
+        thread->spans = spans;
+        thread->span_capacity = capacity;
+    }
+    struct ProfileSpan *span = &thread->spans[thread->span_count++];
+    span->start = start;
+    span->duration = duration > UINT32_MAX ? UINT32_MAX : (uint32_t)duration;
+    span->phase = (uint32_t)phase;
+}
+
+void profile_record(int phase, uint64_t start) {
+    const uint64_t duration = profile_now() - start;
+    struct ProfileThread *thread = current_thread();
+    if (!thread || thread->suspended > 0)
+        return;
+
+    thread->buckets[phase][bucket_of(duration)]++;
+    thread->count[phase]++;
+    thread->total[phase] += duration;
+    if (duration > thread->max[phase])
+        thread->max[phase] = duration;
+    if (tracing)
+        keep_span(thread, phase, start, duration);
+}
+
+void profile_suspend(int delta) {
+    struct ProfileThread *thread = current_thread();
+    if (thread)
+        thread->suspended += delta;
+}
+
+void profile_start(const char *path) {
+#if !SOCCER_PROFILER
+    LOG(LOG_WARN, LOG_ENGINE, "profiling requested, but this build has the profiler compiled out");
+    (void)path;
+    return;
+#endif
+    if (path && !trace_path) {
+        trace_path = malloc(strlen(path) + 1);
+        if (trace_path)
+            strcpy(trace_path, path);
+    }
+    tracing = trace_path != NULL;
+    if (!epoch) {
+        epoch = profile_now();
+        atexit(profile_finish);
+    }
+    profile_enabled = 1;
+}
+
+/** @brief Value below which `fraction` of the samples fall, as the top of its bucket (capped at the max). */
+static uint64_t percentile(const uint64_t *buckets, uint64_t count, uint64_t max, double fraction) {
+    uint64_t rank = (uint64_t)(fraction * (double)count + 0.999999);
+    if (rank < 1)
+        rank = 1;
+    uint64_t seen = 0;
+    for (int b = 0; b < PROFILE_BUCKETS; b++) {
+        seen += buckets[b];
+        if (seen >= rank) {
+            const uint64_t top = b + 1 < PROFILE_BUCKETS ? bucket_floor(b + 1) - 1 : UINT64_MAX;
+            return top < max ? top : max;
+        }
+    }
+    return max;
+}
+
+void profile_report(FILE *out) {
+    uint64_t buckets[PROFILE_BUCKETS];
+    fprintf(out, "%-13s %10s %10s %10s %10s %12s\n", "phase", "count", "p50 us", "p99 us", "max us", "total ms");
+    for (int phase = 0; phase < PROFILE_PHASE_COUNT; phase++) {
+        uint64_t count = 0, total = 0, max = 0;
+        memset(buckets, 0, sizeof(buckets));
+        pthread_mutex_lock(&lock);
+        for (const struct ProfileThread *thread = threads; thread; thread = thread->next) {
+            for (int b = 0; b < PROFILE_BUCKETS; b++)
+                buckets[b] += thread->buckets[phase][b];
+            count += thread->count[phase];
+            total += thread->total[phase];
+            if (thread->max[phase] > max)
+                max = thread->max[phase];
+        }
+        pthread_mutex_unlock(&lock);
+        if (!count)
+            continue;
+
+        fprintf(out, "%-13s %10llu %10.2f %10.2f %10.2f %12.2f\n", phase_names[phase], (unsigned long long)count,
+                percentile(buckets, count, max, 0.50) / 1e3, percentile(buckets, count, max, 0.99) / 1e3,
+                max / 1e3, total / 1e6);
+    }
+}
+
+int profile_write_trace(const char *path) {
+    FILE *out = fopen(path, "w");
+    if (!out)
+        return -1;
+
+    uint64_t dropped = 0;
+    int first = 1;
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    pthread_mutex_lock(&lock);
+    for (const struct ProfileThread *thread = threads; thread; thread = thread->next) {
+        for (size_t i = 0; i < thread->span_count; i++) {
+            const struct ProfileSpan *span = &thread->spans[i];
+            // complete events, microsecond timestamps relative to profile_start()
+            fprintf(out, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    first ? "" : ",\n", phase_names[span->phase],
+                    span->phase >= PROFILE_DRAW_PITCH ? "render" : "tick", thread->id,
+                    (double)(span->start - epoch) / 1e3, span->duration / 1e3);
+            first = 0;
+        }
+        dropped += thread->spans_dropped;
+    }
+    pthread_mutex_unlock(&lock);
+    fprintf(out, "\n]}\n");
+
+    const int failed = ferror(out);
+    if (fclose(out) != 0 || failed)
+        return -1;
+    if (dropped)
+        LOG(LOG_WARN, LOG_ENGINE, "trace %s: %llu spans dropped (more than %d per thread)",
+            path, (unsigned long long)dropped, PROFILE_TRACE_MAX_EVENTS);
+    return 0;
+}
+
+void profile_finish(void) {
+    if (!profile_enabled)
+        return;
+    profile_enabled = 0;
+
+    profile_report(stderr);
+    if (trace_path && profile_write_trace(trace_path) != 0)
+        perror(trace_path);
+}
@@ -0,0 +1,107 @@
+/**
+ * @file profile.h
+ * @brief Per-phase timers that show where a tick (and a frame) spends its time.
+ * * Each timed phase is bracketed by PROFILE_BEGIN / PROFILE_END. The pair reads
+ * the monotonic clock and adds the duration to the phase's latency histogram,
+ * which lives in the calling thread's own block, so batch workers never share
+ * a cache line. Histograms have fixed log-linear buckets (four per power of
+ * two of nanoseconds), so percentiles are exact to within 25%.
+ *
+ * Two switches: configure with -DSOCCERENGINE_ENABLE_PROFILER=OFF and the
+ * macros compile to nothing; otherwise they cost one load and one branch until
+ * profile_start() turns them on. Once started, the per-phase count, p50, p99
+ * and max are printed to stderr at exit, and with a trace path every timed
+ * span is also written as Chrome trace-event JSON (chrome://tracing, Perfetto).
+ *
+ * Spans that end between PROFILE_SUSPEND and PROFILE_RESUME on a thread are
+ * not counted, so scratch work that runs the tick phases (a coach's rollouts)
+ * is timed once, as its own phase, instead of inflating the match's phases.
+ */
+
+#ifndef ENGINE_CORE_PROFILE_H
+#define ENGINE_CORE_PROFILE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/** @brief The timed phases. Simulation phases run once per tick (THINK and ACT once per team). */
+enum ProfilePhase {
+    PROFILE_THINK,          /**< update_team(): state changes and verify_state(). */
+    PROFILE_ACT,            /**< update_team(): movement and shooting logic, verified. */
+    PROFILE_POSSESSION,     /**< update_ball_possessor(). */
+    PROFILE_INTEGRATE,      /**< move_scene(): players and ball advance by dt; PROFILE_BODIES runs inside it. */
+    PROFILE_BODIES,         /**< roster_collide(): players pushed apart. */
+    PROFILE_REFEREE,        /**< referee(): goal and out checks. */
+    PROFILE_ROLLOUT,        /**< rollout_run(): a coach's lookahead, inside its ACT; the phases it plays are not counted. */
+    PROFILE_DRAW_PITCH,     /**< renderer_draw_scene() sections, viewer only. */
+    PROFILE_DRAW_PLAYERS,
+    PROFILE_DRAW_BALL,
+    PROFILE_DRAW_HUD,
+    PROFILE_PRESENT,
+    PROFILE_PHASE_COUNT
+};
+
+/** @brief Histogram buckets: 0-3 ns one each, then four per power of two up to 2^64 ns. */
+#define PROFILE_BUCKETS 252
+
+/** @brief Trace spans kept per thread; later ones are counted and dropped. */
+#define PROFILE_TRACE_MAX_EVENTS (1 << 20)
+
+/** @brief Non-zero once profile_start() ran (and until profile_finish()). */
+extern int profile_enabled;
+
+#ifndef SOCCER_PROFILER
+#define SOCCER_PROFILER 0
+#endif
+
+#if SOCCER_PROFILER
+#define PROFILE_BEGIN(phase) \
+    const uint64_t profile_start_##phase = profile_enabled ? profile_now() : 0
+#define PROFILE_END(phase)                                          \
+    do {                                                            \
+        if (profile_start_##phase)                                  \
+            profile_record((phase), profile_start_##phase);         \
+    } while (0)
+#define PROFILE_SUSPEND()                                           \
+    do {                                                            \
+        if (profile_enabled)                                        \
+            profile_suspend(1);                                     \
+    } while (0)
+#define PROFILE_RESUME()                                            \
+    do {                                                            \
+        if (profile_enabled)                                        \
+            profile_suspend(-1);                                    \
+    } while (0)
+#else
+#define PROFILE_BEGIN(phase) ((void)0)
+#define PROFILE_END(phase) ((void)0)
+#define PROFILE_SUSPEND() ((void)0)
+#define PROFILE_RESUME() ((void)0)
+#endif
+
+/** @brief Monotonic nanoseconds; never 0. */
+uint64_t profile_now(void);
+
+/** @brief Adds the span from `start` (a profile_now() value) until now to `phase`, unless the thread is suspended. */
+void profile_record(int phase, uint64_t start);
+
+/** @brief Adds `delta` (1 or -1) to the calling thread's suspension depth; spans are dropped while it is above 0. */
+void profile_suspend(int delta);
+
+/**
+ * @brief Turns the timers on. With a `trace_path`, spans are also kept for a
+ * trace file. The report (and the trace) are written by profile_finish(),
+ * which is registered to run at exit.
+ */
+void profile_start(const char *trace_path);
+
+/** @brief Writes one line per phase that ran: count, p50, p99, max and total time. */
+void profile_report(FILE *out);
+
+/** @brief Writes every kept span as Chrome trace-event JSON. Returns 0, or -1 if `path` can't be written. */
+int profile_write_trace(const char *path);
+
+/** @brief Stops the timers, then writes the report to stderr and the trace if one was asked for. Safe to call more than once. */
+void profile_finish(void);
+
+#endif
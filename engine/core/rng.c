@@ -0,0 +1,31 @@
+#include "rng.h"
+
+void rng_seed(struct Rng *rng, uint64_t seed, uint64_t stream) {
+    rng->state = 0u;
+    rng->inc = (stream << 1u) | 1u;
+    rng_next(rng);
+    rng->state += seed;
+    rng_next(rng);
+}
+
+uint32_t rng_next(struct Rng *rng) {
+    uint64_t old = rng->state;
+    rng->state = old * 6364136223846793005ULL + rng->inc;
+    uint32_t xorshifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+    uint32_t rot = (uint32_t)(old >> 59u);
+    return (xorshifted >> rot) | (xorshifted << ((32u - rot) & 31u));
+}
+
+uint32_t rng_range(struct Rng *rng, uint32_t bound) {
+    // Reject the few values below (2^32 % bound) so every residue is equally likely.
+    uint32_t threshold = (0u - bound) % bound;
+    for (;;) {
+        uint32_t r = rng_next(rng);
+        if (r >= threshold)
+            return r % bound;
+    }
+}
+
+float rng_float(struct Rng *rng) {
+    return (float)(rng_next(rng) >> 8) * (1.0f / 16777216.0f);
+}
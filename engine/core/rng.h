@@ -0,0 +1,40 @@
+/**
+ * @file rng.h
+ * @brief Small, fast, reproducible random number generator (PCG32).
+ * * Every match owns one generator, seeded from a match seed and a stream id.
+ * Two generators with the same seed but different streams produce
+ * independent sequences, so a batch of matches can share one seed and still
+ * be replayed bit-exactly one by one. Use these functions instead of rand().
+ */
+
+#ifndef ENGINE_CORE_RNG_H
+#define ENGINE_CORE_RNG_H
+
+#include <stdint.h>
+
+/**
+ * @struct Rng
+ * @brief PCG32 state: a 64-bit LCG state plus the (odd) stream increment.
+ */
+struct Rng {
+    uint64_t state;
+    uint64_t inc;
+};
+
+/**
+ * @brief Seeds a generator.
+ * @param seed   Match seed (any value).
+ * @param stream Substream id; different ids give independent sequences.
+ */
+void rng_seed(struct Rng *rng, uint64_t seed, uint64_t stream);
+
+/** @brief Next uniformly distributed 32-bit value. */
+uint32_t rng_next(struct Rng *rng);
+
+/** @brief Uniform integer in [0, bound), without modulo bias. bound must be > 0. */
+uint32_t rng_range(struct Rng *rng, uint32_t bound);
+
+/** @brief Uniform float in [0, 1). */
+float rng_float(struct Rng *rng);
+
+#endif
@@ -0,0 +1,52 @@
+#include "field.h"
+#include "core/constants.h"
+
+#include <stdlib.h>
+
+Field field_make(const float pitch_w, const float pitch_h) {
+    Field field = {
+        .width = pitch_w + PITCH_MARGIN * 2,
+        .height = pitch_h + PITCH_MARGIN * 3,
+        .pitch_x = PITCH_MARGIN,
+        .pitch_y = PITCH_MARGIN * 2,
+        .pitch_w = pitch_w,
+        .pitch_h = pitch_h,
+        .goal_width = DEFAULT_GOAL_WIDTH,
+        .goal_height = DEFAULT_GOAL_HEIGHT
+    };
+    field.center_x = field.pitch_x + field.pitch_w / 2;
+    field.center_y = field.pitch_y + field.pitch_h / 2;
+    return field;
+}
+
+Field field_default(void) {
+    return field_make(DEFAULT_SCREEN_WIDTH - PITCH_MARGIN * 2, DEFAULT_SCREEN_HEIGHT - PITCH_MARGIN * 3);
+}
+
+bool field_is_default_pitch(const Field *field) {
+    const Field reference = field_default();
+    return field->pitch_x == reference.pitch_x && field->pitch_y == reference.pitch_y &&
+           field->pitch_w == reference.pitch_w && field->pitch_h == reference.pitch_h;
+}
+
+struct Vec2 field_from_default(const Field *field, struct Vec2 point) {
+    if (field_is_default_pitch(field))
+        return point;
+    const Field reference = field_default();
+    point.x = field->pitch_x + (point.x - reference.pitch_x) * (field->pitch_w / reference.pitch_w);
+    point.y = field->pitch_y + (point.y - reference.pitch_y) * (field->pitch_h / reference.pitch_h);
+    return point;
+}
+
+int field_parse(const char *text, Field *field) {
+    char *end;
+    const float pitch_w = strtof(text, &end);
+    if (end == text || (*end != 'x' && *end != 'X'))
+        return -1;
+    const char *rest = end + 1;
+    const float pitch_h = strtof(rest, &end);
+    if (end == rest || *end != '\0' || !(pitch_w > 0.0f) || !(pitch_h > 0.0f))
+        return -1;
+    *field = field_make(pitch_w, pitch_h);
+    return 0;
+}
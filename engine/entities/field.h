@@ -1,18 +1,58 @@
 /**
  * @file field.h
  * @brief Defines the soccer field dimensions.
+ * * Every scene carries its own Field, so one binary can play 5v5 drills on
+ * a small pitch and 11v11 matches on a large one. The world is the whole
+ * window: players are kept inside it and the ball bounces off its edges.
+ * The pitch is the rectangle inside it the referee calls goals and outs on.
  */
 
 #ifndef ENGINE_ENTITIES_FIELD_H
 #define ENGINE_ENTITIES_FIELD_H
 
+#include <stdbool.h>
+
+#include "core/vec2.h"
+
 /**
  * @struct Field
  * @brief Represents the size of the soccer field.
  */
 typedef struct Field {
-    const int width;
-    const int height;
+    float width;            /**< World size in px. */
+    float height;
+    float pitch_x;          /**< Left touchline... */
+    float pitch_y;          /**< ...and top touchline. */
+    float pitch_w;
+    float pitch_h;
+    float center_x;         /**< Centre spot. */
+    float center_y;
+    float goal_width;       /**< Depth of the nets behind the goal lines. */
+    float goal_height;      /**< Width of the goal mouths. */
 } Field;
 
+/** @brief The 1000 x 700 layout every coach's kick-off positions are written for. */
+Field field_default(void);
+
+/**
+ * @brief A `pitch_w` x `pitch_h` pitch with the default margins and goals around it.
+ * field_make() of the default pitch size is field_default().
+ */
+Field field_make(float pitch_w, float pitch_h);
+
+/** @brief True if `field` has the default pitch (the world and goals may differ). */
+bool field_is_default_pitch(const Field *field);
+
+/**
+ * @brief Maps a point on the default pitch onto `field`'s, scaling each axis
+ * by the ratio of the pitch sizes. Points come back unchanged on the default pitch.
+ */
+struct Vec2 field_from_default(const Field *field, struct Vec2 point);
+
+/**
+ * @brief Parses a "WxH" pitch size (e.g. "920x580") into field_make(W, H).
+ * @return 0 on success, -1 if `text` is not two positive sizes.
+ */
+int field_parse(const char *text, Field *field);
+
 #endif /* ENGINE_ENTITIES_FIELD_H */
@@ -1,35 +1,44 @@
 #include "player.h"
-#include "logic/coach.h"
+#include "logic/coach_plugin.h"
 #include "core/constants.h"
-#include "logic/referee.h"
 #include <stdlib.h>
 #include <string.h>
 
 /**
- * @brief Creates a stack-allocated Player instance.
+ * @brief Creates a stack-allocated Player instance whose talents and logic come from `coach`.
+ * @param coach The team's coach table (see coach_plugin.h).
  * @param x Initial x-coordinate.
  * @param y Initial y-coordinate.
- * @param talents Player's skill attributes.
  * @return Initialized Player structure.
  */
-struct Player make_player(const float x, const float y, const int team, const int kit) {
+struct Player make_coached_player(const struct CoachApi *coach, const float x, const float y,
+                                  const int team, const int kit) {
     struct Player p = {
         .position = {x, y},
         .velocity = {0, 0},
         .radius = PLAYER_RADIUS,
-        .talents = get_talents(team, kit),
+        .talents = coach->talents(team, kit),
         .state = IDLE,
         .team = team,
         .kit = kit,
 
-        .movement_logic     = get_movement_logic(team, kit),
-        .shooting_logic     = get_shooting_logic(team, kit),
-        .change_state_logic = get_change_state_logic(team, kit),
+        .movement_logic     = coach->movement_logic(team, kit),
+        .shooting_logic     = coach->shooting_logic(team, kit),
+        .change_state_logic = coach->change_state_logic(team, kit),
     };
-    verify_talents(p.talents);
     return p;
 }
 
+/**
+ * @brief Creates a stack-allocated Player instance coached by the built-in coach.
+ * @param x Initial x-coordinate.
+ * @param y Initial y-coordinate.
+ * @return Initialized Player structure.
+ */
+struct Player make_player(const float x, const float y, const int team, const int kit) {
+    return make_coached_player(coach_builtin(), x, y, team, kit);
+}
+
 /**
  * @brief Creates a heap-allocated Player instance.
  * @param x Initial x-coordinate.
@@ -11,6 +11,7 @@
 #include "core/vec2.h"
 
 struct Scene; // Forward declaration: The player needs to know the world exists.
+struct CoachApi;
 
 /**
  * @enum PlayerActionState
@@ -65,6 +66,7 @@ typedef struct Player {
 
 // Allocation functions
 struct Player make_player(float x, float y, int team, const int kit);
+struct Player make_coached_player(const struct CoachApi *coach, float x, float y, int team, const int kit);
 struct Player *make_player_ptr(float x, float y, int team, const int kit);
 
 #endif /* ENGINE_ENTITIES_PLAYER_H */
@@ -2,6 +2,7 @@
 #include "ball.h"
 #include "game/scene.h"
 #include "logic/referee.h"
+#include "core/profile.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
@@ -17,15 +18,18 @@ void update_team(struct Scene* scene, struct Team* team) {
     struct Ball* ball = scene->ball;
 
     // STEP 1: THINK
-    for (int i = 0; i < PLAYER_COUNT; i++)
+    PROFILE_BEGIN(PROFILE_THINK);
+    for (int i = 0; i < team->size; i++)
         if (players[i] && players[i]->change_state_logic) {
             players[i]->change_state_logic(players[i], scene);
             verify_state(players[i], scene);
         }
+    PROFILE_END(PROFILE_THINK);
 
 
     // STEP 2: ACT
-    for (int i = 0; i < PLAYER_COUNT; i++) {
+    PROFILE_BEGIN(PROFILE_ACT);
+    for (int i = 0; i < team->size; i++) {
         if (players[i]) {
             struct Player *player = players[i];
             switch (player->state) {
@@ -39,7 +43,7 @@ void update_team(struct Scene* scene, struct Team* team) {
                     break;
                 case MOVING:
                     player->movement_logic(player, scene);
-                    verify_movement(player);            // Enforce speed limits
+                    verify_movement(player, scene);         // Enforce speed limits
                     if (player == ball->possessor) {    // possessor moves the ball
                         ball->velocity.x = player->velocity.x;
                         ball->velocity.y = player->velocity.y;
@@ -51,7 +55,7 @@ void update_team(struct Scene* scene, struct Team* team) {
                     break;
                 case SHOOTING:
                     player->shooting_logic(player, scene);
-                    verify_shoot(ball, false);          // Enforce speed limits
+                    verify_shoot(ball, false, scene);       // Enforce speed limits
                     ball->possessor = NULL;
                     break;
                 default:
@@ -59,29 +63,19 @@ void update_team(struct Scene* scene, struct Team* team) {
             }
         }
     }
-}
-
-/**
- * @brief Creates a stack-allocated Team instance.
- * @param kit The kit color of the team.
- * @return Initialized Team structure.
- */
-struct Team make_team() {
-    struct Team t = {
-        .score = 0
-    };
-    return t;
+    PROFILE_END(PROFILE_ACT);
 }
 
 /**
  * @brief Creates a heap-allocated Team instance.
- * @param kit The kit color of the team.
+ * @param size Number of player slots, all NULL until the scene fills them.
  * @return Pointer to a newly allocated Team.
  */
-struct Team * make_team_ptr() {
-    struct Team* t_ptr = (struct Team*)malloc(sizeof(struct Team));
+struct Team * make_team_ptr(int size) {
+    struct Team* t_ptr = (struct Team*)calloc(1, sizeof(struct Team) + sizeof(struct Player*) * (size_t)size);
     if (!t_ptr)
         return NULL;
-    *t_ptr = make_team();
+    t_ptr->score = 0;
+    t_ptr->size = size;
     return t_ptr;
 }
\ No newline at end of file
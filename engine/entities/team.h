@@ -14,25 +14,20 @@ struct Scene;  /**< Forward declaration of Scene for update functions. */
 /**
  * @struct Team
  * @brief Represents a soccer team with players and score.
+ * The player slots are allocated with the team (see make_team_ptr()).
  */
 struct Team {
     unsigned int score;
-    struct Player *players[PLAYER_COUNT];
+    int size;                   /**< Number of player slots (the scene's team_size). */
+    struct Player *players[];
 };
 
 /**
- * @brief Creates a new Team (stack-allocated).
- * @param kit The kit color for the team.
- * @return Initialized Team structure.
+ * @brief Creates a new Team (heap-allocated) with `size` empty player slots.
+ * @param size Players per side.
+ * @return Pointer to a newly allocated Team structure, or NULL on allocation failure.
  */
-struct Team make_team();
-
-/**
- * @brief Creates a new Team (heap-allocated).
- * @param kit The kit color for the team.
- * @return Pointer to a newly allocated Team structure.
- */
-struct Team *make_team_ptr();
+struct Team *make_team_ptr(int size);
 
 /**
  * @brief Updates the state of all players in the team within the given scene.
@@ -0,0 +1,253 @@
+#define _GNU_SOURCE // pthread_setaffinity_np, posix_memalign, sysconf
+#include "batch.h"
+#include "checkpoint.h"
+#include "scene.h"
+#include "entities/ball.h"
+#include "entities/team.h"
+#include "replay/recorder.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @struct BatchJob
+ * @brief Work shared by all workers: the match list and the next unclaimed index.
+ */
+struct BatchJob {
+    const struct MatchSpec* specs;
+    struct MatchResult* results;
+    int count;
+    int next;               /**< Next match index to hand out, guarded by lock. */
+    int failed;             /**< Set when any match fails, guarded by lock. */
+    pthread_mutex_t lock;
+};
+
+/**
+ * @struct BatchWorker
+ * @brief One worker thread and the match state it owns.
+ * * Workers are laid out at a cache-line-multiple stride so two threads never
+ * write to the same line while simulating.
+ */
+struct BatchWorker {
+    Scene scene;
+    struct Ball ball;
+    pthread_t thread;
+    int cpu;                /**< CPU to pin to, or -1 for no pinning. */
+    struct BatchJob* job;
+};
+
+int batch_setup_scene(Scene* scene, struct Ball* ball, const struct MatchSpec* spec) {
+    // Ball and Scene carry const members, so they are built on the stack and copied in.
+    struct Ball fresh_ball = make_ball(0, 0);
+    memcpy(ball, &fresh_ball, sizeof(struct Ball));
+
+    Scene fresh_scene = {
+        .field = spec->field,
+        .team_size = spec->team_size,
+        .body_collisions = spec->body_collisions,
+        .ball = ball
+    };
+    memcpy(scene, &fresh_scene, sizeof(Scene));
+    rng_seed(&scene->rng, spec->seed, spec->stream);
+    scene->coaches[0] = spec->coaches[0];
+    scene->coaches[1] = spec->coaches[1];
+
+    if (init_scene(scene) != 0)
+        return -1;
+    scene->remaining_time = spec->length;
+    return 0;
+}
+
+/**
+ * @brief Builds the scene for `spec` around `ball`: from its checkpoint or
+ * resume file if there is one, otherwise from kick-off.
+ * @param played Set to the spec the match is played with.
+ * @param ticks Set to the ticks already played.
+ * @return 0 on success, -1 (scene left unbuilt) if the scene could not be
+ * built or a checkpoint could not be used.
+ */
+static int setup_match(Scene* scene, struct Ball* ball, const struct MatchSpec* spec,
+                       struct MatchSpec* played, unsigned long* ticks) {
+    *played = *spec;
+    *ticks = 0;
+    const char* resume = spec->resume_path;
+    if (spec->checkpoint_path && access(spec->checkpoint_path, F_OK) == 0)
+        resume = spec->checkpoint_path;
+    if (!resume)
+        return batch_setup_scene(scene, ball, spec);
+    if (checkpoint_load(scene, ball, played, ticks, resume) != 0)
+        return -1;
+    if (resume == spec->checkpoint_path && (played->seed != spec->seed || played->stream != spec->stream)) {
+        destroy_scene(scene);
+        return -1;
+    }
+    played->checkpoint_path = spec->checkpoint_path;
+    played->checkpoint_every = spec->checkpoint_every;
+    played->resume_path = NULL;
+    return 0;
+}
+
+/**
+ * @brief Builds the scene around `ball` and plays it until STATE_TIMEOUT.
+ * @return 0 on success, -1 if a checkpoint or the requested recording failed.
+ */
+static int play_match(Scene* scene, struct Ball* ball, const struct MatchSpec* requested,
+                      struct MatchResult* result) {
+    struct MatchSpec played;
+    unsigned long ticks;
+    if (setup_match(scene, ball, requested, &played, &ticks) != 0)
+        return -1;
+    const struct MatchSpec* spec = &played;
+
+    struct Recorder recorder;
+    int status = 0;
+    if (requested->record_path) {
+        if (spec->record_path && recorder_begin(&recorder, scene, spec->seed, spec->stream, spec->tick_rate) == 0)
+            scene->recorder = &recorder;
+        else
+            status = -1;
+    }
+
+    unsigned long checkpoint_ticks = 0;
+    if (spec->checkpoint_path) {
+        const float every = spec->checkpoint_every * spec->tick_rate + 0.5f;
+        checkpoint_ticks = (every >= 1.0f) ? (unsigned long)every : 1;
+    }
+
+    const float dt = 1.0f / spec->tick_rate;
+    while (scene->state != STATE_TIMEOUT) {
+        update_scene(scene, dt);
+        ticks++;
+        if (checkpoint_ticks && ticks % checkpoint_ticks == 0 &&
+            checkpoint_save(scene, spec, ticks, spec->checkpoint_path) != 0)
+            status = -1;
+    }
+
+    result->seed = spec->seed;
+    result->stream = spec->stream;
+    result->first_score = scene->first_team->score;
+    result->second_score = scene->second_team->score;
+    result->ticks = ticks;
+    // the tallies move to the result, so destroy_scene() must not free them
+    result->violations = scene->violations;
+    memset(&scene->violations, 0, sizeof(scene->violations));
+
+    if (scene->recorder) {
+        if (recorder_end(&recorder, scene) != 0 || recorder_save(&recorder, spec->record_path) != 0)
+            status = -1;
+        recorder_free(&recorder);
+        scene->recorder = NULL;
+    }
+
+    destroy_scene(scene);
+    return status;
+}
+
+void match_result_free(struct MatchResult* result) {
+    violations_free(&result->violations);
+}
+
+int run_match(const struct MatchSpec* spec, struct MatchResult* result) {
+    if (spec->length <= 0.0f || spec->tick_rate <= 0.0f)
+        return -1;
+
+    Scene scene;
+    struct Ball ball = make_ball(0, 0);
+    return play_match(&scene, &ball, spec, result);
+}
+
+int batch_cpu_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+void batch_pin_current_thread(int cpu) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+static void* worker_main(void* arg) {
+    struct BatchWorker* worker = arg;
+    struct BatchJob* job = worker->job;
+
+    if (worker->cpu >= 0)
+        batch_pin_current_thread(worker->cpu);
+
+    for (;;) {
+        pthread_mutex_lock(&job->lock);
+        int index = job->next++;
+        pthread_mutex_unlock(&job->lock);
+
+        if (index >= job->count)
+            break;
+
+        const struct MatchSpec* spec = &job->specs[index];
+        if (spec->length <= 0.0f || spec->tick_rate <= 0.0f ||
+            play_match(&worker->scene, &worker->ball, spec, &job->results[index]) != 0) {
+            pthread_mutex_lock(&job->lock);
+            job->failed = 1;
+            pthread_mutex_unlock(&job->lock);
+        }
+    }
+    return NULL;
+}
+
+int batch_run(const struct MatchSpec* specs, struct MatchResult* results, int count,
+              int threads, bool pin) {
+    if (count <= 0)
+        return 0;
+
+    const int cpus = batch_cpu_count();
+    if (threads < 1)
+        threads = cpus;
+    if (threads > count)
+        threads = count;
+
+    const size_t stride = (sizeof(struct BatchWorker) + CACHE_LINE_SIZE - 1)
+                          / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+    void* storage = NULL;
+    if (posix_memalign(&storage, CACHE_LINE_SIZE, stride * (size_t)threads) != 0)
+        return -1;
+    memset(storage, 0, stride * (size_t)threads);
+
+    struct BatchJob job = {
+        .specs = specs,
+        .results = results,
+        .count = count,
+        .next = 0,
+        .failed = 0
+    };
+    pthread_mutex_init(&job.lock, NULL);
+
+    int started = 0;
+    for (int i = 0; i < threads; i++) {
+        struct BatchWorker* worker = (struct BatchWorker*)((char*)storage + stride * (size_t)i);
+        worker->cpu = pin ? (i % cpus) : -1;
+        worker->job = &job;
+        if (pthread_create(&worker->thread, NULL, worker_main, worker) != 0)
+            break;
+        started++;
+    }
+
+    for (int i = 0; i < started; i++) {
+        struct BatchWorker* worker = (struct BatchWorker*)((char*)storage + stride * (size_t)i);
+        pthread_join(worker->thread, NULL);
+    }
+
+    pthread_mutex_destroy(&job.lock);
+    free(storage);
+
+    // If no worker could start, nothing ran; otherwise the started ones drained the queue.
+    if (started == 0 || job.failed)
+        return -1;
+    return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file batch.h
+ * @brief Plays many headless matches concurrently on a pool of worker threads.
+ * * Every worker owns a private Scene, teams and ball, so matches never share
+ * mutable state. Results are stored by match index, which makes the output
+ * order independent of how many threads ran or which one finished first.
+ */
+
+#ifndef ENGINE_GAME_BATCH_H
+#define ENGINE_GAME_BATCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "entities/field.h"
+#include "logic/violations.h"
+
+struct CoachApi;
+
+/** @brief Size used to keep per-worker data on separate cache lines. */
+#define CACHE_LINE_SIZE 64
+
+/**
+ * @struct MatchSpec
+ * @brief Everything needed to replay one match.
+ */
+struct MatchSpec {
+    uint64_t seed;          /**< Match seed for the scene's random stream. */
+    uint64_t stream;        /**< Substream id; matches sharing a seed differ by stream. */
+    float length;           /**< Match length in game seconds. */
+    float tick_rate;        /**< Simulation ticks per game second. */
+    const char* record_path; /**< If not NULL, the match is recorded to this .srpl file. */
+    const struct CoachApi* coaches[2]; /**< Coach of team 1 and team 2; NULL plays the built-in one. */
+    int team_size;          /**< Players per side; 0 plays DEFAULT_TEAM_SIZE. */
+    Field field;            /**< Pitch; all zero plays field_default(). */
+    bool body_collisions;   /**< Push overlapping players apart (see Scene); off by default. */
+    const char* checkpoint_path; /**< If not NULL, the match is checkpointed here every checkpoint_every game seconds, and resumed from here if the file already exists. */
+    float checkpoint_every; /**< Game seconds between checkpoints (at least one tick). */
+    const char* resume_path; /**< If not NULL (and no checkpoint_path file exists yet), the match starts from this checkpoint instead of kick-off. */
+};
+
+/**
+ * @struct MatchResult
+ * @brief Final outcome of one match.
+ */
+struct MatchResult {
+    uint64_t seed;
+    uint64_t stream;
+    unsigned int first_score;
+    unsigned int second_score;
+    unsigned long ticks;    /**< Simulation steps taken until STATE_TIMEOUT. */
+    struct Violations violations;   /**< The referee's corrections, per player and rule; owned by the result. */
+};
+
+/** @brief Frees what a MatchResult owns (its violation tallies). */
+void match_result_free(struct MatchResult* result);
+
+struct Scene;
+struct Ball;
+
+/**
+ * @brief Builds a fresh, seeded scene around caller-owned storage, ready for update_scene().
+ * Release it with destroy_scene() once the match is over.
+ * @return 0 on success, -1 if init_scene() failed (nothing to release then).
+ */
+int batch_setup_scene(struct Scene* scene, struct Ball* ball, const struct MatchSpec* spec);
+
+/**
+ * @brief Plays one match to the end on the calling thread.
+ * * A match resumed from a checkpoint (see checkpoint.h) plays on with
+ * `spec`'s coaches and takes everything else from the file; it cannot be
+ * recorded, since a recording starts at kick-off. A checkpoint_path file
+ * holding a different seed or stream is an error, not a fresh start.
+ * On success the caller frees `result` with match_result_free().
+ * @return 0 on success, -1 on allocation failure, if a checkpoint could not be
+ * read or written, or if the recording could not be written.
+ */
+int run_match(const struct MatchSpec* spec, struct MatchResult* result);
+
+/**
+ * @brief Plays `count` matches on `threads` workers.
+ * * results[i] always holds the outcome of specs[i]; free each with match_result_free().
+ * @param threads Worker count; values < 1 use one worker per online CPU.
+ * @param pin     Pin worker i to CPU (i % CPUs) where the platform supports it.
+ * @return 0 on success, -1 if a worker could not be started or a match failed.
+ */
+int batch_run(const struct MatchSpec* specs, struct MatchResult* results, int count,
+              int threads, bool pin);
+
+/**
+ * @brief Number of CPUs currently online (at least 1).
+ */
+int batch_cpu_count(void);
+
+/**
+ * @brief Pins the calling thread to `cpu`; a no-op where the platform has no affinity API.
+ */
+void batch_pin_current_thread(int cpu);
+
+#endif /* ENGINE_GAME_BATCH_H */
@@ -0,0 +1,231 @@
+#include "checkpoint.h"
+#include "batch.h"
+#include "scene.h"
+#include "entities/ball.h"
+#include "entities/team.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** @brief Where the tallies start, for `players` players. */
+static size_t tallies_offset(int players) {
+    return sizeof(struct CheckpointHeader) + sizeof(struct CheckpointPlayer) * (size_t)players;
+}
+
+static size_t encoded_size(int players, int rule_count) {
+    return tallies_offset(players) + sizeof(struct RuleTally) * (size_t)players * (size_t)rule_count;
+}
+
+size_t checkpoint_size(const struct Scene* scene) {
+    return encoded_size(scene->roster.count, RULE_COUNT);
+}
+
+void checkpoint_write(const struct Scene* scene, const struct MatchSpec* spec, unsigned long ticks, void* out) {
+    const struct Roster* roster = &scene->roster;
+    const struct Ball* ball = scene->ball;
+    struct CheckpointHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CHECKPOINT_MAGIC, 4);
+    header.version = CHECKPOINT_VERSION;
+    header.player_count = (uint16_t)roster->count;
+    header.seed = spec->seed;
+    header.stream = spec->stream;
+    header.ticks = ticks;
+    header.rng_state = scene->rng.state;
+    header.rng_inc = scene->rng.inc;
+    header.tick_rate = spec->tick_rate;
+    header.match_length = spec->length;
+    header.remaining_time = scene->remaining_time;
+    header.wait_time = scene->wait_time;
+    header.state = (int32_t)scene->state;
+    header.first_score = scene->first_team->score;
+    header.second_score = scene->second_team->score;
+    header.possessor = roster_handle(roster, ball->possessor);
+    header.last_team = ball->last_team;
+    header.ball_contact = scene->ball_contact;
+    header.ball_contact_time = scene->ball_contact_time;
+    header.ball[0] = ball->position.x;
+    header.ball[1] = ball->position.y;
+    header.ball[2] = ball->velocity.x;
+    header.ball[3] = ball->velocity.y;
+    header.ball_from[0] = scene->ball_from.x;
+    header.ball_from[1] = scene->ball_from.y;
+    header.ball_to[0] = scene->ball_to.x;
+    header.ball_to[1] = scene->ball_to.y;
+    header.field = scene->field;
+    header.rule_count = RULE_COUNT;
+    header.body_collisions = scene->body_collisions;
+
+    char* cursor = out;
+    memcpy(cursor, &header, sizeof(header));
+    cursor += sizeof(header);
+    for (int i = 0; i < roster->count; i++) {
+        const struct Player* p = &roster->views[i];
+        const struct CheckpointPlayer record = {
+            .x = p->position.x, .y = p->position.y,
+            .vx = p->velocity.x, .vy = p->velocity.y,
+            .state = (int32_t)p->state,
+            .talents = { p->talents.defence, p->talents.agility, p->talents.dribbling, p->talents.shooting },
+            .sweep = roster->sweep[i]
+        };
+        memcpy(cursor, &record, sizeof(record));
+        cursor += sizeof(record);
+    }
+    memcpy(cursor, scene->violations.players, sizeof(struct RuleTally) * (size_t)roster->count * RULE_COUNT);
+}
+
+/** @brief Structural checks that need nothing but the bytes. */
+static bool valid(const struct CheckpointHeader* header, const struct CheckpointPlayer* players, size_t size) {
+    // a checkpoint from a host of the other byte order fails the version check
+    // (it reads byte-swapped), before any other multi-byte field is trusted
+    if (size < sizeof(*header) || memcmp(header->magic, CHECKPOINT_MAGIC, 4) != 0 ||
+        header->version != CHECKPOINT_VERSION || header->rule_count != RULE_COUNT ||
+        header->player_count == 0 || header->player_count % 2 != 0 ||
+        size != encoded_size(header->player_count, header->rule_count) ||
+        !(header->tick_rate > 0.0f) || !(header->match_length > 0.0f) ||
+        header->state < STATE_RUNNING || header->state > STATE_RESTARTING ||
+        header->possessor < -1 || header->possessor >= header->player_count ||
+        header->ball_contact < -1 || header->ball_contact >= header->player_count ||
+        !(header->field.width > 0.0f))
+        return false;
+
+    // the sweep order has to be a permutation of the roster
+    const int count = header->player_count;
+    bool* seen = calloc((size_t)count, sizeof(bool));
+    bool ok = seen != NULL;
+    for (int i = 0; ok && i < count; i++) {
+        const int s = players[i].sweep;
+        ok = players[i].state >= IDLE && players[i].state <= INTERCEPTING && s >= 0 && s < count && !seen[s];
+        if (ok)
+            seen[s] = true;
+    }
+    free(seen);
+    return ok;
+}
+
+int checkpoint_read(struct Scene* scene, struct Ball* ball, struct MatchSpec* spec, unsigned long* ticks,
+                    const void* data, size_t size) {
+    // the bytes may come from an unaligned buffer: copy the header out
+    struct CheckpointHeader header;
+    if (size < sizeof(header))
+        return -1;
+    memcpy(&header, data, sizeof(header));
+    const size_t players_size = sizeof(struct CheckpointPlayer) * header.player_count;
+    struct CheckpointPlayer* players = malloc(players_size ? players_size : 1);
+    if (!players)
+        return -1;
+    if (size >= sizeof(header) + players_size)
+        memcpy(players, (const char*)data + sizeof(header), players_size);
+    if (!valid(&header, players, size)) {
+        free(players);
+        return -1;
+    }
+
+    spec->seed = header.seed;
+    spec->stream = header.stream;
+    spec->length = header.match_length;
+    spec->tick_rate = header.tick_rate;
+    spec->record_path = NULL;
+    spec->team_size = header.player_count / 2;
+    spec->field = header.field;
+    spec->body_collisions = header.body_collisions != 0;
+    if (batch_setup_scene(scene, ball, spec) != 0) {
+        free(players);
+        return -1;
+    }
+
+    // everything init_scene() set up for kick-off is overwritten from here on
+    struct Roster* roster = &scene->roster;
+    for (int i = 0; i < roster->count; i++) {
+        struct Player* p = &roster->views[i];
+        const struct Talents talents = {
+            players[i].talents[0], players[i].talents[1], players[i].talents[2], players[i].talents[3]
+        };
+        p->position.x = players[i].x;
+        p->position.y = players[i].y;
+        p->velocity.x = players[i].vx;
+        p->velocity.y = players[i].vy;
+        p->state = (PlayerActionState)players[i].state;
+        memcpy((void*)&p->talents, &talents, sizeof(talents));   // const member
+        roster->sweep[i] = players[i].sweep;
+    }
+    free(players);
+    memcpy(scene->violations.players, (const char*)data + tallies_offset(roster->count),
+           sizeof(struct RuleTally) * (size_t)roster->count * RULE_COUNT);
+
+    scene->rng.state = header.rng_state;
+    scene->rng.inc = header.rng_inc;
+    scene->remaining_time = header.remaining_time;
+    scene->wait_time = header.wait_time;
+    scene->state = (GameState)header.state;
+    scene->first_team->score = header.first_score;
+    scene->second_team->score = header.second_score;
+    scene->ball_contact = header.ball_contact;
+    scene->ball_contact_time = header.ball_contact_time;
+    scene->ball_from.x = header.ball_from[0];
+    scene->ball_from.y = header.ball_from[1];
+    scene->ball_to.x = header.ball_to[0];
+    scene->ball_to.y = header.ball_to[1];
+    ball->position.x = header.ball[0];
+    ball->position.y = header.ball[1];
+    ball->velocity.x = header.ball[2];
+    ball->velocity.y = header.ball[3];
+    ball->possessor = roster_player(roster, header.possessor);
+    ball->last_team = header.last_team;
+    perception_invalidate(&scene->perception);
+
+    *ticks = (unsigned long)header.ticks;
+    return 0;
+}
+
+int checkpoint_save(const struct Scene* scene, const struct MatchSpec* spec, unsigned long ticks, const char* path) {
+    const size_t size = checkpoint_size(scene);
+    const size_t path_length = strlen(path);
+    char* data = malloc(size);
+    char* temp = malloc(path_length + 5);
+    if (!data || !temp) {
+        free(data);
+        free(temp);
+        return -1;
+    }
+    checkpoint_write(scene, spec, ticks, data);
+    memcpy(temp, path, path_length);
+    memcpy(temp + path_length, ".tmp", 5);
+
+    int status = -1;
+    FILE* file = fopen(temp, "wb");
+    if (file) {
+        const bool ok = fwrite(data, 1, size, file) == size;
+        if (fclose(file) == 0 && ok && rename(temp, path) == 0)
+            status = 0;
+        else
+            remove(temp);
+    }
+    free(data);
+    free(temp);
+    return status;
+}
+
+int checkpoint_load(struct Scene* scene, struct Ball* ball, struct MatchSpec* spec, unsigned long* ticks,
+                    const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return -1;
+    char* data = NULL;
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) > 0 && fseek(file, 0, SEEK_SET) == 0) {
+        data = malloc((size_t)size);
+        if (data && fread(data, 1, (size_t)size, file) != (size_t)size) {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(file);
+    if (!data)
+        return -1;
+    const int status = checkpoint_read(scene, ball, spec, ticks, data, (size_t)size);
+    free(data);
+    return status;
+}
@@ -0,0 +1,128 @@
+/**
+ * @file checkpoint.h
+ * @brief Saves a running match to disk and resumes it, bit for bit.
+ * * A checkpoint holds everything update_scene() reads that is not rebuilt by
+ * init_scene(): every player's position, velocity, state and talents, the
+ * ball (its possessor as a roster index, see roster_handle()), the clock and
+ * timers, the GameState, both scores, the random stream, the collision sweep
+ * order and the referee's tallies, plus the MatchSpec it was started from.
+ * Resuming it, in this process or another one, and playing on gives exactly
+ * the ticks the original match would have played.
+ *
+ * Layout (host byte order, naturally aligned, like the .srpl format):
+ *
+ *   [CheckpointHeader][CheckpointPlayer x player_count]
+ *   [RuleTally x player_count x rule_count]
+ *
+ * Not stored: the coaches (their logic comes from the MatchSpec the match is
+ * resumed with, as with scene_rebind_coach(); a plugin that keeps its own
+ * memory starts afresh) and any recording, which has to start at kick-off.
+ * The perception caches are rebuilt on the next tick.
+ *
+ * A checkpoint only resumes on a host of the byte order that wrote it;
+ * checkpoint_read() rejects one whose version reads byte-swapped.
+ */
+
+#ifndef ENGINE_GAME_CHECKPOINT_H
+#define ENGINE_GAME_CHECKPOINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "entities/field.h"
+
+#define CHECKPOINT_MAGIC "SCKP"
+/** @brief Version 2 stores body_collisions (on when set) where version 1 stored its inverse. */
+#define CHECKPOINT_VERSION 2
+
+/**
+ * @struct CheckpointHeader
+ * @brief First 168 bytes of every checkpoint: the spec and the match-wide state.
+ */
+struct CheckpointHeader {
+    char magic[4];              /**< CHECKPOINT_MAGIC, not NUL-terminated. */
+    uint16_t version;           /**< CHECKPOINT_VERSION. */
+    uint16_t player_count;      /**< Players of both teams (2 * team_size). */
+    uint64_t seed;              /**< MatchSpec seed. */
+    uint64_t stream;            /**< MatchSpec stream. */
+    uint64_t ticks;             /**< update_scene() calls made since kick-off. */
+    uint64_t rng_state;         /**< Scene::rng, as it is after the last tick. */
+    uint64_t rng_inc;
+    float tick_rate;            /**< Ticks per game second. */
+    float match_length;         /**< MatchSpec length in game seconds. */
+    float remaining_time;
+    float wait_time;
+    int32_t state;              /**< GameState. */
+    uint32_t first_score;
+    uint32_t second_score;
+    int32_t possessor;          /**< Roster index holding the ball, or -1. */
+    int32_t last_team;
+    int32_t ball_contact;       /**< Scene::ball_contact. */
+    float ball[4];              /**< Position x, y and velocity x, y. */
+    float ball_from[2];
+    float ball_to[2];
+    Field field;
+    uint16_t rule_count;        /**< RULE_COUNT of the writer. */
+    uint8_t body_collisions;    /**< MatchSpec body_collisions. */
+    uint8_t reserved;
+    float ball_contact_time;    /**< Scene::ball_contact_time. */
+};
+
+/**
+ * @struct CheckpointPlayer
+ * @brief One player, by roster index.
+ */
+struct CheckpointPlayer {
+    float x;
+    float y;
+    float vx;
+    float vy;
+    int32_t state;              /**< PlayerActionState. */
+    int32_t talents[4];         /**< defence, agility, dribbling, shooting. */
+    int32_t sweep;              /**< Roster::sweep at this index: the collision sweep order. */
+};
+
+struct Scene;
+struct Ball;
+struct MatchSpec;
+
+/** @brief Bytes checkpoint_write() needs for `scene`. */
+size_t checkpoint_size(const struct Scene* scene);
+
+/**
+ * @brief Encodes `scene`, started from `spec` and `ticks` ticks in, into
+ * `out`, which holds checkpoint_size() bytes.
+ */
+void checkpoint_write(const struct Scene* scene, const struct MatchSpec* spec, unsigned long ticks, void* out);
+
+/**
+ * @brief Rebuilds the scene stored in `data` around caller-owned storage,
+ * like batch_setup_scene(), ready for the next update_scene().
+ * * `spec` is in and out: its coaches are the ones the match plays on with;
+ * seed, stream, length, tick rate, team size, pitch and collisions are
+ * filled in from the checkpoint, and record_path is cleared.
+ * Release the scene with destroy_scene().
+ * @param ticks Set to the ticks played before the checkpoint.
+ * @return 0 on success, -1 if `data` is not a valid checkpoint, was written
+ * on a host of the other byte order, or the scene could not be built (it is
+ * then left unbuilt).
+ */
+int checkpoint_read(struct Scene* scene, struct Ball* ball, struct MatchSpec* spec, unsigned long* ticks,
+                    const void* data, size_t size);
+
+/**
+ * @brief Writes a checkpoint of `scene` to `path`.
+ * * The file is written next to `path` and renamed over it, so a process
+ * killed while saving leaves the previous checkpoint intact.
+ * @return 0 on success, -1 on I/O or allocation failure.
+ */
+int checkpoint_save(const struct Scene* scene, const struct MatchSpec* spec, unsigned long ticks, const char* path);
+
+/**
+ * @brief Reads the checkpoint at `path` with checkpoint_read().
+ * @return 0 on success, -1 if the file cannot be read or is not a valid checkpoint.
+ */
+int checkpoint_load(struct Scene* scene, struct Ball* ball, struct MatchSpec* spec, unsigned long* ticks,
+                    const char* path);
+
+#endif /* ENGINE_GAME_CHECKPOINT_H */
@@ -0,0 +1,185 @@
+#include "grid.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+int grid_init(struct Grid *grid, int count, float width, float height) {
+    // one player per cell on average, but never cells smaller than a few players
+    const float spacing = count > 0 ? sqrtf(width * height / (float)count) : 0.0f;
+    const float cell_size = spacing > GRID_MIN_CELL_SIZE ? spacing : GRID_MIN_CELL_SIZE;
+    const int cols = (int)ceilf(width / cell_size);
+    const int rows = (int)ceilf(height / cell_size);
+    const size_t n = (size_t)count;
+    const size_t cells = (size_t)(cols > 0 ? cols : 1) * (size_t)(rows > 0 ? rows : 1);
+    const size_t total = sizeof(float) * n * 2                   // x, y
+                       + sizeof(int) * n * 4                     // cell, next, prev, hits
+                       + sizeof(int) * cells;                    // head
+
+    memset(grid, 0, sizeof(*grid));
+    char *block = malloc(total);
+    if (!block)
+        return -1;
+
+    grid->count = count;
+    grid->cols = cols > 0 ? cols : 1;
+    grid->rows = rows > 0 ? rows : 1;
+    grid->cell_size = cell_size;
+    grid->inv_cell_size = 1.0f / cell_size;
+    grid->block = block;
+    grid->x = (float *)block;                   block += sizeof(float) * n;
+    grid->y = (float *)block;                   block += sizeof(float) * n;
+    grid->cell = (int *)block;                  block += sizeof(int) * n;
+    grid->next = (int *)block;                  block += sizeof(int) * n;
+    grid->prev = (int *)block;                  block += sizeof(int) * n;
+    grid->hits = (int *)block;                  block += sizeof(int) * n;
+    grid->head = (int *)block;
+
+    memset(grid->cell, 0xff, sizeof(int) * n);      // all -1: nothing is linked yet
+    memset(grid->head, 0xff, sizeof(int) * cells);
+    return 0;
+}
+
+void grid_free(struct Grid *grid) {
+    free(grid->block);
+    memset(grid, 0, sizeof(*grid));
+}
+
+/** @brief The column `x` falls in; points off the world go to the edge column. */
+static int column_of(const struct Grid *grid, float x) {
+    const float c = x * grid->inv_cell_size;
+    if (!(c >= 1.0f))
+        return 0;
+    return c >= (float)grid->cols ? grid->cols - 1 : (int)c;
+}
+
+static int row_of(const struct Grid *grid, float y) {
+    const float r = y * grid->inv_cell_size;
+    if (!(r >= 1.0f))
+        return 0;
+    return r >= (float)grid->rows ? grid->rows - 1 : (int)r;
+}
+
+static void unlink_item(struct Grid *grid, int i) {
+    const int prev = grid->prev[i];
+    const int next = grid->next[i];
+    if (prev >= 0)
+        grid->next[prev] = next;
+    else
+        grid->head[grid->cell[i]] = next;
+    if (next >= 0)
+        grid->prev[next] = prev;
+}
+
+static void link_item(struct Grid *grid, int i, int cell) {
+    const int head = grid->head[cell];
+    grid->prev[i] = -1;
+    grid->next[i] = head;
+    if (head >= 0)
+        grid->prev[head] = i;
+    grid->head[cell] = i;
+    grid->cell[i] = cell;
+}
+
+void grid_update(struct Grid *grid, const struct Player *views) {
+    float max_radius = 0.0f;
+    for (int i = 0; i < grid->count; i++) {
+        const float x = views[i].position.x;
+        const float y = views[i].position.y;
+        grid->x[i] = x;
+        grid->y[i] = y;
+        if (views[i].radius > max_radius)
+            max_radius = views[i].radius;
+
+        const int cell = row_of(grid, y) * grid->cols + column_of(grid, x);
+        if (cell == grid->cell[i])
+            continue;
+        if (grid->cell[i] >= 0)
+            unlink_item(grid, i);
+        link_item(grid, i, cell);
+    }
+    grid->max_radius = max_radius;
+}
+
+int grid_within(struct Grid *grid, float x, float y, float radius) {
+    const int col_lo = column_of(grid, x - radius), col_hi = column_of(grid, x + radius);
+    const int row_lo = row_of(grid, y - radius), row_hi = row_of(grid, y + radius);
+    const float r2 = radius * radius;
+    int found = 0;
+
+    for (int row = row_lo; row <= row_hi; row++) {
+        for (int col = col_lo; col <= col_hi; col++) {
+            for (int i = grid->head[row * grid->cols + col]; i >= 0; i = grid->next[i]) {
+                const float dx = grid->x[i] - x;
+                const float dy = grid->y[i] - y;
+                if (dx * dx + dy * dy <= r2)
+                    grid->hits[found++] = i;
+            }
+        }
+    }
+
+    // insertion sort: a query rarely finds more than a handful of players
+    for (int k = 1; k < found; k++) {
+        const int hit = grid->hits[k];
+        int j = k;
+        while (j > 0 && grid->hits[j - 1] > hit) {
+            grid->hits[j] = grid->hits[j - 1];
+            j--;
+        }
+        grid->hits[j] = hit;
+    }
+    return found;
+}
+
+int grid_nearest(const struct Grid *grid, float x, float y, int first, int last, int exclude) {
+    const int cx = column_of(grid, x);
+    const int cy = row_of(grid, y);
+    int rings = cx;
+    if (grid->cols - 1 - cx > rings) rings = grid->cols - 1 - cx;
+    if (cy > rings) rings = cy;
+    if (grid->rows - 1 - cy > rings) rings = grid->rows - 1 - cy;
+
+    const float size = grid->cell_size;
+    int best = -1;
+    float best_d2 = 0.0f;
+    for (int k = 0; k <= rings; k++) {
+        if (best >= 0) {
+            // ring k lies outside the square of the rings before it: stop once that
+            // square's nearest edge is farther than the best so far
+            float gap = x - (float)(cx - k + 1) * size;
+            const float right = (float)(cx + k) * size - x;
+            const float top = y - (float)(cy - k + 1) * size;
+            const float bottom = (float)(cy + k) * size - y;
+            if (right < gap) gap = right;
+            if (top < gap) gap = top;
+            if (bottom < gap) gap = bottom;
+            if (gap > 0.0f && gap * gap > best_d2)
+                break;
+        }
+
+        for (int row = cy - k; row <= cy + k; row++) {
+            if (row < 0 || row >= grid->rows)
+                continue;
+            // rows strictly inside the ring only contribute their two end cells
+            const bool edge = (row == cy - k || row == cy + k);
+            const int step = edge ? 1 : 2 * k;
+            for (int col = cx - k; col <= cx + k; col += step) {
+                if (col < 0 || col >= grid->cols)
+                    continue;
+                for (int i = grid->head[row * grid->cols + col]; i >= 0; i = grid->next[i]) {
+                    if (i < first || i >= last || i == exclude)
+                        continue;
+                    const float dx = grid->x[i] - x;
+                    const float dy = grid->y[i] - y;
+                    const float d2 = dx * dx + dy * dy;
+                    if (best < 0 || d2 < best_d2 || (d2 == best_d2 && i < best)) {
+                        best = i;
+                        best_d2 = d2;
+                    }
+                }
+            }
+        }
+    }
+    return best;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file grid.h
+ * @brief Uniform spatial hash over the world, for proximity queries.
+ * * The world is cut into square cells about as wide as the mean spacing of
+ * the players, so a cell holds one player on average, and every player is
+ * linked into the list of the cell its centre is in. grid_update() only relinks the
+ * players that changed cell since the last update, so keeping the grid
+ * current costs one cell computation per player and tick. A radius query
+ * then only visits the cells the circle overlaps, and a nearest-neighbour
+ * query walks rings of cells outwards from the point until no closer player
+ * can be left.
+ *
+ * Items are identified by roster index (see roster.h). Results never depend
+ * on the order players sit in a cell: radius queries return indices in
+ * ascending order and nearest queries break ties on the lowest index, so a
+ * grid answer is always the brute-force answer.
+ */
+
+#ifndef ENGINE_GAME_GRID_H
+#define ENGINE_GAME_GRID_H
+
+#include "entities/player.h"
+
+/** @brief Smallest cell side in px: four player radii, so a player overlaps at most four cells. */
+#define GRID_MIN_CELL_SIZE 64.0f
+
+/**
+ * @brief Rosters from this many players (both teams) on answer proximity
+ * queries from the grid; below it scanning every player is faster, grid
+ * update included (see the broadphase group of soccer_bench).
+ */
+#define GRID_MIN_PLAYERS 44
+
+/**
+ * @brief Rosters from this many players on look the ball's possession up in
+ * the grid when it is current anyway. Updating the grid only for that one
+ * lookup never pays: it costs more than the scan it replaces.
+ */
+#define GRID_LOOKUP_MIN_PLAYERS 16
+
+struct Grid {
+    int count;              /**< Items (players). */
+    int cols;
+    int rows;
+    float cell_size;
+    float inv_cell_size;
+    float max_radius;       /**< Largest player radius seen by the last update. */
+    float *x;               /**< Item positions as of the last grid_update(). */
+    float *y;
+    int *cell;              /**< Cell of each item, -1 before the first update. */
+    int *next;              /**< Per-cell doubly linked lists, -1 terminated. */
+    int *prev;
+    int *head;              /**< First item of each cell, cols x rows, row-major. */
+    int *hits;              /**< Results of the last grid_within(), ascending. */
+    void *block;            /**< Backing storage for every array above. */
+};
+
+/**
+ * @brief Allocates a grid for `count` items over a `width` x `height` world.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int grid_init(struct Grid *grid, int count, float width, float height);
+
+void grid_free(struct Grid *grid);
+
+/** @brief Re-reads every position from `views` (grid->count of them) and relinks the items that changed cell. */
+void grid_update(struct Grid *grid, const struct Player *views);
+
+/**
+ * @brief Finds every item whose centre is within `radius` of (x, y).
+ * @return How many were found; their indices are in grid->hits[0..n), ascending.
+ */
+int grid_within(struct Grid *grid, float x, float y, float radius);
+
+/**
+ * @brief The item in [first, last) closest to (x, y), other than `exclude` (may be -1).
+ * Ties go to the lowest index.
+ * @return Its index, or -1 if the range holds no other item.
+ */
+int grid_nearest(const struct Grid *grid, float x, float y, int first, int last, int exclude);
+
+#endif /* ENGINE_GAME_GRID_H */
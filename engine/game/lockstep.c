@@ -0,0 +1,412 @@
+#include "lockstep.h"
+#include "entities/ball.h"
+#include "entities/team.h"
+#include "game/possession.h"
+#include "game/trajectory.h"
+#include "logic/referee.h"
+#include "replay/recorder.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------
+ * Vector helpers: one register holds LOCKSTEP_WIDTH match lanes.
+ * Every helper maps to exactly one IEEE operation, mirroring the scalar code.
+ * ------------------------------------------------------------------------- */
+#if defined(__AVX__)
+#include <immintrin.h>
+#define LOCKSTEP_ISA "avx"
+#define LOCKSTEP_WIDTH 8
+typedef __m256 vfloat;
+#define v_load(p)           _mm256_loadu_ps(p)
+#define v_store(p, a)       _mm256_storeu_ps((p), (a))
+#define v_set1(x)           _mm256_set1_ps(x)
+#define v_add(a, b)         _mm256_add_ps((a), (b))
+#define v_sub(a, b)         _mm256_sub_ps((a), (b))
+#define v_mul(a, b)         _mm256_mul_ps((a), (b))
+#define v_div(a, b)         _mm256_div_ps((a), (b))
+#define v_lt(a, b)          _mm256_cmp_ps((a), (b), _CMP_LT_OQ)
+#define v_gt(a, b)          _mm256_cmp_ps((a), (b), _CMP_GT_OQ)
+#define v_le(a, b)          _mm256_cmp_ps((a), (b), _CMP_LE_OQ)
+#define v_ge(a, b)          _mm256_cmp_ps((a), (b), _CMP_GE_OQ)
+#define v_and(a, b)         _mm256_and_ps((a), (b))
+#define v_or(a, b)          _mm256_or_ps((a), (b))
+#define v_andnot(m, a)      _mm256_andnot_ps((m), (a))          /* a where m is clear */
+#define v_xor(a, b)         _mm256_xor_ps((a), (b))
+#define v_select(m, a, b)   _mm256_blendv_ps((b), (a), (m))     /* m ? a : b */
+#define v_bits(m)           _mm256_movemask_ps(m)
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define LOCKSTEP_ISA "sse2"
+#define LOCKSTEP_WIDTH 4
+typedef __m128 vfloat;
+#define v_load(p)           _mm_loadu_ps(p)
+#define v_store(p, a)       _mm_storeu_ps((p), (a))
+#define v_set1(x)           _mm_set1_ps(x)
+#define v_add(a, b)         _mm_add_ps((a), (b))
+#define v_sub(a, b)         _mm_sub_ps((a), (b))
+#define v_mul(a, b)         _mm_mul_ps((a), (b))
+#define v_div(a, b)         _mm_div_ps((a), (b))
+#define v_lt(a, b)          _mm_cmplt_ps((a), (b))
+#define v_gt(a, b)          _mm_cmpgt_ps((a), (b))
+#define v_le(a, b)          _mm_cmple_ps((a), (b))
+#define v_ge(a, b)          _mm_cmpge_ps((a), (b))
+#define v_and(a, b)         _mm_and_ps((a), (b))
+#define v_or(a, b)          _mm_or_ps((a), (b))
+#define v_andnot(m, a)      _mm_andnot_ps((m), (a))
+#define v_xor(a, b)         _mm_xor_ps((a), (b))
+#define v_select(m, a, b)   _mm_or_ps(_mm_and_ps((m), (a)), _mm_andnot_ps((m), (b)))
+#define v_bits(m)           _mm_movemask_ps(m)
+#else
+#define LOCKSTEP_ISA "scalar"
+#endif
+
+const char* lockstep_isa(void) {
+    return LOCKSTEP_ISA;
+}
+
+int lockstep_init(struct Lockstep* group, Scene** scenes, int lanes, bool use_simd) {
+    if (lanes < 1 || lanes > LOCKSTEP_MAX_LANES)
+        return -1;
+
+    memset(group, 0, sizeof(*group));
+    group->lanes = lanes;
+    group->entities = scenes[0]->roster.count;
+    group->field = scenes[0]->field;
+    group->use_simd = use_simd;
+    for (int l = 0; l < lanes; l++) {
+        if (scenes[l]->roster.count != group->entities)
+            return -1;
+        if (memcmp(&scenes[l]->field, &group->field, sizeof(Field)) != 0)
+            return -1;
+        group->scenes[l] = scenes[l];
+    }
+
+    const size_t n = (size_t)group->entities * LOCKSTEP_MAX_LANES;
+    float* block = calloc(n * 5, sizeof(float));
+    if (!block)
+        return -1;
+
+    group->block = block;
+    group->px = block;
+    group->py = block + n;
+    group->vx = block + 2 * n;
+    group->vy = block + 3 * n;
+    group->radius = block + 4 * n;
+    return 0;
+}
+
+void lockstep_free(struct Lockstep* group) {
+    free(group->block);
+    group->block = NULL;
+}
+
+/* -------------------------------------------------------------------------
+ * Lane transfer: scene <-> lane-major arrays
+ * ------------------------------------------------------------------------- */
+static void gather_lane(struct Lockstep* group, int lane, float dt, float decay) {
+    const Scene* scene = group->scenes[lane];
+    const struct Roster* roster = &scene->roster;
+    for (int e = 0; e < group->entities; e++) {
+        const int k = e * LOCKSTEP_MAX_LANES + lane;
+        group->px[k] = roster->pos_x[e];
+        group->py[k] = roster->pos_y[e];
+        group->vx[k] = roster->vel_x[e];
+        group->vy[k] = roster->vel_y[e];
+        group->radius[k] = roster->radius[e];
+    }
+    const struct Ball* ball = scene->ball;
+    group->bx[lane] = ball->position.x;
+    group->by[lane] = ball->position.y;
+
+    // the ball's own way and the first player a free one runs into, as in move_scene()
+    struct Vec2 velocity = ball->velocity;
+    const float travel = ball->possessor ? dt : ball_roll(&velocity, decay, ball_travel(decay));
+    const struct Vec2 shift = { ball->velocity.x * travel, ball->velocity.y * travel };
+    group->bvx[lane] = velocity.x;
+    group->bvy[lane] = velocity.y;
+    group->shift_x[lane] = shift.x;
+    group->shift_y[lane] = shift.y;
+    group->impact[lane] = INFINITY;
+    const int hit = ball->possessor ? -1 : first_ball_contact(scene, dt, shift, &group->impact[lane]);
+    group->hit[lane] = hit;
+}
+
+static void scatter_lane(struct Lockstep* group, int lane) {
+    Scene* scene = group->scenes[lane];
+    struct Roster* roster = &scene->roster;
+    for (int e = 0; e < group->entities; e++) {
+        const int k = e * LOCKSTEP_MAX_LANES + lane;
+        roster->pos_x[e] = group->px[k];
+        roster->pos_y[e] = group->py[k];
+    }
+    // body collisions depend on where each match's players are, so they stay scalar
+    if (scene->body_collisions)
+        roster_collide(roster, group->field.width, group->field.height);
+    roster_scatter_positions(roster);
+    struct Ball* ball = scene->ball;
+    ball->position.x = group->bx[lane];
+    ball->position.y = group->by[lane];
+    ball->velocity.x = group->bvx[lane];
+    ball->velocity.y = group->bvy[lane];
+    scene->ball_from.x = group->from_x[lane];
+    scene->ball_from.y = group->from_y[lane];
+    scene->ball_to.x = group->to_x[lane];
+    scene->ball_to.y = group->to_y[lane];
+    scene->ball_contact = group->caught[lane] ? group->hit[lane] : -1;
+    scene->ball_contact_time = group->caught[lane] ? group->impact[lane] : 0.0f;
+}
+
+/* -------------------------------------------------------------------------
+ * Scalar kernels (reference and fallback): same order as move_scene()
+ * ------------------------------------------------------------------------- */
+static void players_scalar(struct Lockstep* group, float dt) {
+    const float width = group->field.width;
+    const float height = group->field.height;
+    for (int e = 0; e < group->entities; e++) {
+        for (int l = 0; l < group->lanes; l++) {
+            const int k = e * LOCKSTEP_MAX_LANES + l;
+            const float rad = group->radius[k];
+            float x = group->px[k] + group->vx[k] * dt;
+            float y = group->py[k] + group->vy[k] * dt;
+            x = (x < rad) ? rad : x;
+            x = (x > width - rad) ? width - rad : x;
+            y = (y < rad) ? rad : y;
+            y = (y > height - rad) ? height - rad : y;
+            group->px[k] = x;
+            group->py[k] = y;
+        }
+    }
+}
+
+static void ball_scalar(struct Lockstep* group, float dt) {
+    const float r = BALL_RADIUS;
+    const float width = group->field.width;
+    const float height = group->field.height;
+    for (int l = 0; l < group->lanes; l++) {
+        float x = group->bx[l] + group->shift_x[l];
+        float y = group->by[l] + group->shift_y[l];
+        float vx = group->bvx[l];
+        float vy = group->bvy[l];
+        int scored;
+        bool out;
+        const float off = referee_sweep(&group->field, group->bx[l], group->by[l], x, y, &scored, &out);
+        group->caught[l] = group->impact[l] < off * dt;
+        group->from_x[l] = group->bx[l];
+        group->from_y[l] = group->by[l];
+        group->to_x[l] = x;
+        group->to_y[l] = y;
+        group->scored[l] = scored;
+        group->out[l] = out;
+
+        if (x - r < 0) { x = r; vx = -vx; }
+        if (x + r > width) { x = width - r; vx = -vx; }
+        if (y - r < 0) { y = r; vy = -vy; }
+        if (y + r > height) { y = height - r; vy = -vy; }
+        group->bx[l] = x;
+        group->by[l] = y;
+        group->bvx[l] = vx;
+        group->bvy[l] = vy;
+    }
+}
+
+/* -------------------------------------------------------------------------
+ * Vector kernels
+ * ------------------------------------------------------------------------- */
+#ifdef LOCKSTEP_WIDTH
+static void players_simd(struct Lockstep* group, float dt) {
+    const vfloat vdt = v_set1(dt);
+    const vfloat width = v_set1(group->field.width);
+    const vfloat height = v_set1(group->field.height);
+
+    for (int e = 0; e < group->entities; e++) {
+        for (int l = 0; l < group->lanes; l += LOCKSTEP_WIDTH) {
+            const int k = e * LOCKSTEP_MAX_LANES + l;
+            const vfloat rad = v_load(&group->radius[k]);
+            vfloat x = v_add(v_load(&group->px[k]), v_mul(v_load(&group->vx[k]), vdt));
+            vfloat y = v_add(v_load(&group->py[k]), v_mul(v_load(&group->vy[k]), vdt));
+            const vfloat max_x = v_sub(width, rad);
+            const vfloat max_y = v_sub(height, rad);
+            x = v_select(v_lt(x, rad), rad, x);
+            x = v_select(v_gt(x, max_x), max_x, x);
+            y = v_select(v_lt(y, rad), rad, y);
+            y = v_select(v_gt(y, max_y), max_y, y);
+            v_store(&group->px[k], x);
+            v_store(&group->py[k], y);
+        }
+    }
+}
+
+/** @brief Pitch lines and goal mouth as referee_sweep() computes them, in float. */
+struct SweepLines {
+    vfloat right;           /**< Goal lines and touchlines pushed out by the ball radius. */
+    vfloat left;
+    vfloat bottom;
+    vfloat top;
+    vfloat right_out;       /**< Past these the whole ball is off the pitch... */
+    vfloat left_out;
+    vfloat bottom_out;
+    vfloat top_out;
+    vfloat goal_top;        /**< ...and between these it is inside the goal mouth. */
+    vfloat goal_bottom;
+};
+
+/**
+ * @brief referee_sweep() over 8/4 lanes: the same operations, with selects
+ * for its branches. Lanes that crossed no line divide by zero harmlessly.
+ * @return The fraction at which each ball first lay fully off the pitch, or 2.
+ */
+static vfloat sweep_simd(const struct SweepLines* k, vfloat x0, vfloat y0, vfloat x1, vfloat y1,
+                         int* right_goal, int* left_goal, int* out) {
+    const vfloat r = v_set1(BALL_RADIUS);
+    const vfloat zero = v_set1(0.0f);
+    const vfloat one = v_set1(1.0f);
+    const vfloat dx = v_sub(x1, x0);
+    const vfloat dy = v_sub(y1, y0);
+
+    const vfloat past_right = v_gt(v_sub(x1, r), k->right);
+    const vfloat past_x = v_or(past_right, v_lt(v_add(x1, r), k->left));
+    vfloat s = v_div(v_sub(v_select(past_right, k->right_out, k->left_out), x0), dx);
+    s = v_select(v_gt(s, zero), s, zero);
+    s = v_select(v_lt(s, one), s, one);
+    const vfloat y = v_add(y0, v_mul(dy, s));
+    const vfloat mouth = v_and(v_ge(v_sub(y, r), k->goal_top), v_le(v_add(y, r), k->goal_bottom));
+    const vfloat goal = v_and(past_x, mouth);
+    vfloat first = v_select(past_x, s, v_set1(2.0f));
+
+    const vfloat past_bottom = v_gt(v_sub(y1, r), k->bottom);
+    const vfloat past_y = v_or(past_bottom, v_lt(v_add(y1, r), k->top));
+    s = v_div(v_sub(v_select(past_bottom, k->bottom_out, k->top_out), y0), dy);
+    s = v_select(v_gt(s, zero), s, zero);
+    s = v_select(v_lt(s, one), s, one);
+    first = v_select(v_and(past_y, v_lt(s, first)), s, first);
+
+    *right_goal = v_bits(v_and(goal, past_right));
+    *left_goal = v_bits(v_andnot(past_right, goal));
+    *out = v_bits(v_or(past_x, past_y));
+    return first;
+}
+
+static void ball_simd(struct Lockstep* group, float dt) {
+    const vfloat vdt = v_set1(dt);
+    const vfloat zero = v_set1(0.0f);
+    const vfloat sign = v_set1(-0.0f);
+    const Field* field = &group->field;
+    const vfloat r = v_set1(BALL_RADIUS);
+    const vfloat width = v_set1(field->width);
+    const vfloat height = v_set1(field->height);
+    const vfloat max_x = v_set1(field->width - BALL_RADIUS);
+    const vfloat max_y = v_set1(field->height - BALL_RADIUS);
+    // same expressions as referee_sweep(), evaluated in float
+    const float left_line = field->pitch_x;
+    const float right_line = field->pitch_x + field->pitch_w;
+    const float top_line = field->pitch_y;
+    const float bottom_line = field->pitch_y + field->pitch_h;
+    const struct SweepLines lines = {
+        .right = v_set1(right_line), .left = v_set1(left_line),
+        .bottom = v_set1(bottom_line), .top = v_set1(top_line),
+        .right_out = v_set1(right_line + BALL_RADIUS), .left_out = v_set1(left_line - BALL_RADIUS),
+        .bottom_out = v_set1(bottom_line + BALL_RADIUS), .top_out = v_set1(top_line - BALL_RADIUS),
+        .goal_top = v_set1(field->center_y - field->goal_height / 2.0f),
+        .goal_bottom = v_set1(field->center_y + field->goal_height / 2.0f),
+    };
+
+    for (int l = 0; l < group->lanes; l += LOCKSTEP_WIDTH) {
+        const vfloat bx = v_load(&group->bx[l]);
+        const vfloat by = v_load(&group->by[l]);
+        vfloat vx = v_load(&group->bvx[l]);
+        vfloat vy = v_load(&group->bvy[l]);
+        const vfloat shift_x = v_load(&group->shift_x[l]);
+        const vfloat shift_y = v_load(&group->shift_y[l]);
+        vfloat x = v_add(bx, shift_x);
+        vfloat y = v_add(by, shift_y);
+        int right_goal, left_goal, out;
+        const vfloat off = sweep_simd(&lines, bx, by, x, y, &right_goal, &left_goal, &out);
+
+        // the ball keeps its path; a player met before it left the pitch is only recorded
+        const vfloat impact = v_load(&group->impact[l]);
+        const int caught_bits = v_bits(v_lt(impact, v_mul(off, vdt)));
+        v_store(&group->from_x[l], bx);
+        v_store(&group->from_y[l], by);
+        v_store(&group->to_x[l], x);
+        v_store(&group->to_y[l], y);
+
+        // wall bounces, one side at a time like the scalar ifs
+        vfloat m = v_lt(v_sub(x, r), zero);
+        x = v_select(m, r, x);
+        vx = v_select(m, v_xor(vx, sign), vx);
+        m = v_gt(v_add(x, r), width);
+        x = v_select(m, max_x, x);
+        vx = v_select(m, v_xor(vx, sign), vx);
+        m = v_lt(v_sub(y, r), zero);
+        y = v_select(m, r, y);
+        vy = v_select(m, v_xor(vy, sign), vy);
+        m = v_gt(v_add(y, r), height);
+        y = v_select(m, max_y, y);
+        vy = v_select(m, v_xor(vy, sign), vy);
+
+        v_store(&group->bx[l], x);
+        v_store(&group->by[l], y);
+        v_store(&group->bvx[l], vx);
+        v_store(&group->bvy[l], vy);
+
+        for (int i = 0; i < LOCKSTEP_WIDTH; i++) {
+            group->scored[l + i] = (right_goal >> i & 1) ? 1 : ((left_goal >> i & 1) ? 2 : 0);
+            group->out[l + i] = out >> i & 1;
+            group->caught[l + i] = caught_bits >> i & 1;
+        }
+    }
+}
+#endif
+
+/* -------------------------------------------------------------------------
+ * Driver
+ * ------------------------------------------------------------------------- */
+int lockstep_step(struct Lockstep* group, float dt) {
+    const float decay = ball_decay(dt);
+    bool any_active = false;
+    bool played[LOCKSTEP_MAX_LANES];   // lanes a plain driver would have called update_scene() on
+
+    // scalar per match: clock, set pieces, coaches and possession
+    for (int l = 0; l < group->lanes; l++) {
+        Scene* scene = group->scenes[l];
+        played[l] = scene->state != STATE_TIMEOUT;
+        group->active[l] = advance_scene_clock(scene, dt);
+        if (group->active[l]) {
+            think_scene(scene);
+            gather_lane(group, l, dt, decay);
+            any_active = true;
+        }
+    }
+
+    // vector across matches: physics and referee checks (idle lanes are computed and ignored)
+    if (any_active) {
+#ifdef LOCKSTEP_WIDTH
+        if (group->use_simd) {
+            players_simd(group, dt);
+            ball_simd(group, dt);
+        } else
+#endif
+        {
+            players_scalar(group, dt);
+            ball_scalar(group, dt);
+        }
+    }
+
+    int running = 0;
+    for (int l = 0; l < group->lanes; l++) {
+        Scene* scene = group->scenes[l];
+        int call = PLAY_ON;
+        if (group->active[l]) {
+            scatter_lane(group, l);
+            call = referee_decide(scene, group->scored[l], group->out[l] != 0);
+            apply_referee_call(scene, call);
+        }
+        if (scene->recorder && played[l])
+            recorder_tick(scene->recorder, scene, call);
+        if (scene->state != STATE_TIMEOUT)
+            running++;
+    }
+    return running;
+}
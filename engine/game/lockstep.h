@@ -0,0 +1,85 @@
+/**
+ * @file lockstep.h
+ * @brief Steps a group of independent matches together, one SIMD lane per match.
+ * * Coaches, possession, set pieces and body collisions still run scalar, one scene at a time.
+ * So do the ball's roll for the tick (ball_roll(), one ball per match) and
+ * the swept ball-vs-player test (first_ball_contact()), which needs it. The physics
+ * that follows (player integration and pitch clamping, the ball's flight,
+ * whether it met that player before leaving the pitch, and its wall bounce) and the
+ * referee's swept goal/out checks run as vector kernels over "match lanes":
+ * for every entity the kinematics of all matches sit side by side, so one
+ * AVX/SSE register holds the same player (or the ball) of 8/4 different matches.
+ *
+ * The scalar kernels perform the same float operations in the same order,
+ * so both paths, and plain update_scene(), give bit-identical matches.
+ */
+
+#ifndef ENGINE_GAME_LOCKSTEP_H
+#define ENGINE_GAME_LOCKSTEP_H
+
+#include <stdbool.h>
+#include "game/scene.h"
+
+/** @brief Most matches one Lockstep group can hold. */
+#define LOCKSTEP_MAX_LANES 16
+
+/**
+ * @struct Lockstep
+ * @brief Lane-major kinematics for up to LOCKSTEP_MAX_LANES matches.
+ * Player arrays are indexed [entity * LOCKSTEP_MAX_LANES + lane].
+ */
+struct Lockstep {
+    int lanes;                              /**< Matches in the group. */
+    int entities;                           /**< Players per match. */
+    Field field;                            /**< Pitch every match in the group plays on. */
+    bool use_simd;                          /**< false forces the scalar kernels. */
+    Scene* scenes[LOCKSTEP_MAX_LANES];
+    bool active[LOCKSTEP_MAX_LANES];        /**< Lanes whose physics runs this tick. */
+
+    float* px;
+    float* py;
+    float* vx;
+    float* vy;
+    float* radius;
+
+    float bx[LOCKSTEP_MAX_LANES];
+    float by[LOCKSTEP_MAX_LANES];
+    float bvx[LOCKSTEP_MAX_LANES];          /**< Already rolled on for this tick by gather... */
+    float bvy[LOCKSTEP_MAX_LANES];
+    float shift_x[LOCKSTEP_MAX_LANES];      /**< ...which also leaves how far the ball goes on its own. */
+    float shift_y[LOCKSTEP_MAX_LANES];
+    float impact[LOCKSTEP_MAX_LANES];       /**< first_ball_contact() time per lane, INFINITY if none... */
+    int hit[LOCKSTEP_MAX_LANES];            /**< ...and the player it finds. */
+    int caught[LOCKSTEP_MAX_LANES];         /**< The ball met that player before it went off the pitch (Scene::ball_contact). */
+    float from_x[LOCKSTEP_MAX_LANES];       /**< Scene::ball_from and Scene::ball_to per lane. */
+    float from_y[LOCKSTEP_MAX_LANES];
+    float to_x[LOCKSTEP_MAX_LANES];
+    float to_y[LOCKSTEP_MAX_LANES];
+    int scored[LOCKSTEP_MAX_LANES];         /**< referee_sweep() per lane. */
+    int out[LOCKSTEP_MAX_LANES];
+
+    void* block;                            /**< Backing storage for the player arrays. */
+};
+
+/**
+ * @brief Groups already initialized scenes (see batch_setup_scene()).
+ * All scenes must have the same roster size and field.
+ * @return 0 on success, -1 on bad arguments or allocation failure.
+ */
+int lockstep_init(struct Lockstep* group, Scene** scenes, int lanes, bool use_simd);
+
+void lockstep_free(struct Lockstep* group);
+
+/**
+ * @brief Advances every match by one tick, exactly like update_scene() on each.
+ * @return Number of matches that have not reached STATE_TIMEOUT yet.
+ */
+int lockstep_step(struct Lockstep* group, float dt);
+
+/**
+ * @brief Name of the vector instruction set the kernels were compiled for.
+ * @return "avx", "sse2" or "scalar".
+ */
+const char* lockstep_isa(void);
+
+#endif /* ENGINE_GAME_LOCKSTEP_H */
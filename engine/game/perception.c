@@ -0,0 +1,283 @@
+#include "perception.h"
+#include "game/scene.h"
+#include "entities/ball.h"
+#include "entities/player.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+int perception_init(struct Perception *perception, int team_size, const Field *field) {
+    const size_t n = (size_t)team_size * 2;
+    const size_t total = sizeof(struct Vec2) * n                 // to_ball
+                       + sizeof(float) * n                       // ball_distance
+                       + sizeof(int) * n                         // attack_order
+                       + sizeof(float) * n * n;                  // distance
+
+    memset(perception, 0, sizeof(*perception));
+    char *block = calloc(1, total);
+    if (!block)
+        return -1;
+    if (grid_init(&perception->grid, (int)n, field->width, field->height) != 0) {
+        free(block);
+        return -1;
+    }
+
+    perception->players = (int)n;
+    perception->team_size = team_size;
+    perception->block = block;
+    perception->to_ball = (struct Vec2 *)block;                 block += sizeof(struct Vec2) * n;
+    perception->ball_distance = (float *)block;                 block += sizeof(float) * n;
+    perception->attack_order[0] = (int *)block;                 block += sizeof(int) * (size_t)team_size;
+    perception->attack_order[1] = (int *)block;                 block += sizeof(int) * (size_t)team_size;
+    perception->distance = (float *)block;
+    return 0;
+}
+
+void perception_free(struct Perception *perception) {
+    free(perception->block);
+    grid_free(&perception->grid);
+    memset(perception, 0, sizeof(*perception));
+}
+
+void perception_invalidate(struct Perception *perception) {
+    perception->offsets_ready = false;
+    perception->order_ready = false;
+    perception->path_ready = false;
+    perception->pairs_ready = false;
+    perception->grid_ready = false;
+}
+
+int perception_index(const struct Scene *scene, const struct Player *player) {
+    return (int)(player - scene->roster.views);
+}
+
+/** @brief True if `a` is closer than `b` to the goal `team` attacks (team 1 attacks to the right). */
+static bool ahead(int team, const struct Player *a, const struct Player *b) {
+    return (team == 1) ? (a->position.x > b->position.x) : (a->position.x < b->position.x);
+}
+
+static void build_offsets(struct Scene *scene) {
+    struct Perception *perception = &scene->perception;
+    const struct Player *views = scene->roster.views;
+    const struct Ball *ball = scene->ball;
+    const int players = perception->players;
+
+    for (int i = 0; i < players; i++) {
+        const float dx = ball->position.x - views[i].position.x;
+        const float dy = ball->position.y - views[i].position.y;
+        perception->to_ball[i].x = dx;
+        perception->to_ball[i].y = dy;
+        perception->ball_distance[i] = hypotf(dx, dy);
+    }
+    perception->offsets_ready = true;
+}
+
+static void build_order(struct Scene *scene) {
+    struct Perception *perception = &scene->perception;
+    const struct Player *views = scene->roster.views;
+    const int team_size = perception->team_size;
+
+    // insertion sort per team: rosters are small and barely reorder between
+    // ticks, and a stable order keeps ties in kit order
+    for (int t = 0; t < 2; t++) {
+        int *order = perception->attack_order[t];
+        const int base = t * team_size;
+        for (int k = 0; k < team_size; k++) {
+            int j = k;
+            while (j > 0 && ahead(t + 1, &views[base + k], &views[order[j - 1]])) {
+                order[j] = order[j - 1];
+                j--;
+            }
+            order[j] = base + k;
+        }
+    }
+    perception->order_ready = true;
+}
+
+static void build_pairs(struct Scene *scene) {
+    struct Perception *perception = &scene->perception;
+    const struct Player *views = scene->roster.views;
+    const int players = perception->players;
+    float *distance = perception->distance;
+
+    for (int i = 0; i < players; i++) {
+        distance[i * players + i] = 0.0f;
+        for (int j = i + 1; j < players; j++) {
+            const float d = hypotf(views[j].position.x - views[i].position.x,
+                                   views[j].position.y - views[i].position.y);
+            distance[i * players + j] = d;
+            distance[j * players + i] = d;
+        }
+    }
+    perception->pairs_ready = true;
+}
+
+const struct Perception *perception_ball(struct Scene *scene) {
+    if (!scene->perception.offsets_ready)
+        build_offsets(scene);
+    return &scene->perception;
+}
+
+const struct Perception *perception_pairs(struct Scene *scene) {
+    if (!scene->perception.pairs_ready)
+        build_pairs(scene);
+    return &scene->perception;
+}
+
+struct Grid *perception_grid(struct Scene *scene) {
+    if (!scene->perception.grid_ready) {
+        grid_update(&scene->perception.grid, scene->roster.views);
+        scene->perception.grid_ready = true;
+    }
+    return &scene->perception.grid;
+}
+
+/** @brief The roster index range [first, last) of `team`, or of both teams for 0. */
+static void team_range(const struct Perception *perception, int team, int *first, int *last) {
+    *first = (team == 2) ? perception->team_size : 0;
+    *last = (team == 1) ? perception->team_size : perception->players;
+}
+
+/**
+ * @brief The roster index of the `team` player (0: either) nearest to (x, y),
+ * other than `exclude`. Small rosters are scanned; the answer is the grid's.
+ */
+static int nearest_index(struct Scene *scene, float x, float y, int team, int exclude) {
+    int first, last;
+    team_range(&scene->perception, team, &first, &last);
+    if (scene->perception.players >= GRID_MIN_PLAYERS)
+        return grid_nearest(perception_grid(scene), x, y, first, last, exclude);
+
+    const struct Player *views = scene->roster.views;
+    int best = -1;
+    float best_d2 = 0.0f;
+    for (int i = first; i < last; i++) {
+        if (i == exclude)
+            continue;
+        const float dx = views[i].position.x - x;
+        const float dy = views[i].position.y - y;
+        const float d2 = dx * dx + dy * dy;
+        if (best < 0 || d2 < best_d2) {
+            best = i;
+            best_d2 = d2;
+        }
+    }
+    return best;
+}
+
+/** @brief The nearest player to `player` of its own team (`same`) or of the other one. */
+static struct Player *nearest_of(struct Scene *scene, const struct Player *player, bool same) {
+    const int team = same ? player->team : 3 - player->team;
+    const int nearest = nearest_index(scene, player->position.x, player->position.y, team,
+                                        perception_index(scene, player));
+    return nearest < 0 ? NULL : &scene->roster.views[nearest];
+}
+
+float perception_ball_distance(struct Scene *scene, const struct Player *player) {
+    return perception_ball(scene)->ball_distance[perception_index(scene, player)];
+}
+
+bool perception_touches_ball(struct Scene *scene, const struct Player *player) {
+    const struct Ball *ball = scene->ball;
+    const float rs = player->radius + ball->radius;
+    const float cx = player->position.x - ball->position.x;
+    const float cy = player->position.y - ball->position.y;
+    return (cx * cx + cy * cy) <= (rs * rs) || perception_index(scene, player) == scene->ball_contact;
+}
+
+float perception_goal_distance(struct Scene *scene, const struct Player *player, enum PerceptionGoal goal) {
+    const Field *field = &scene->field;
+    const float goal_x = (goal == GOAL_LEFT) ? field->pitch_x : field->pitch_x + field->pitch_w;
+    return hypotf(goal_x - player->position.x, field->center_y - player->position.y);
+}
+
+float perception_intercept(struct Scene *scene, const struct Player *player, float speed, struct Vec2 *point) {
+    struct Perception *perception = &scene->perception;
+    if (!perception->path_ready) {
+        ball_path(&perception->ball_path, scene->ball);
+        perception->path_ready = true;
+    }
+    const struct BallPath *path = &perception->ball_path;
+    const float t = ball_intercept_time(path, player->position, speed, player->radius + scene->ball->radius);
+    if (point && t < INFINITY)
+        *point = ball_position_at(path, t);
+    return t;
+}
+
+float perception_distance(struct Scene *scene, const struct Player *a, const struct Player *b) {
+    const struct Perception *perception = perception_pairs(scene);
+    return perception->distance[perception_index(scene, a) * perception->players + perception_index(scene, b)];
+}
+
+struct Player *perception_nearest_teammate(struct Scene *scene, const struct Player *player) {
+    return nearest_of(scene, player, true);
+}
+
+struct Player *perception_nearest_opponent(struct Scene *scene, const struct Player *player) {
+    return nearest_of(scene, player, false);
+}
+
+struct Player *perception_most_advanced(struct Scene *scene, int team, const struct Player *exclude) {
+    const struct Perception *perception = &scene->perception;
+    if (!perception->order_ready)
+        build_order(scene);
+    const int *order = perception->attack_order[team - 1];
+    for (int k = 0; k < perception->team_size; k++) {
+        struct Player *player = &scene->roster.views[order[k]];
+        if (player != exclude)
+            return player;
+    }
+    return NULL;
+}
+
+struct Player *perception_nearest_to_ball(struct Scene *scene, int team) {
+    const struct Perception *perception = perception_ball(scene);
+    const int base = (team - 1) * perception->team_size;
+    int nearest = base;
+    for (int i = base + 1; i < base + perception->team_size; i++)
+        if (perception->ball_distance[i] < perception->ball_distance[nearest])
+            nearest = i;
+    return &scene->roster.views[nearest];
+}
+
+struct Player *perception_nearest_player(struct Scene *scene, struct Vec2 point, int team,
+                                         const struct Player *exclude) {
+    const int nearest = nearest_index(scene, point.x, point.y, team,
+                                        exclude ? perception_index(scene, exclude) : -1);
+    return nearest < 0 ? NULL : &scene->roster.views[nearest];
+}
+
+int perception_players_within(struct Scene *scene, struct Vec2 point, float radius, int team,
+                              struct Player **out, int max) {
+    int first, last;
+    team_range(&scene->perception, team, &first, &last);
+    int count = 0;
+
+    if (scene->perception.players < GRID_MIN_PLAYERS) {
+        const struct Player *views = scene->roster.views;
+        const float r2 = radius * radius;
+        for (int i = first; i < last; i++) {
+            const float dx = views[i].position.x - point.x;
+            const float dy = views[i].position.y - point.y;
+            if (dx * dx + dy * dy > r2)
+                continue;
+            if (count < max)
+                out[count] = &scene->roster.views[i];
+            count++;
+        }
+        return count;
+    }
+
+    struct Grid *grid = perception_grid(scene);
+    const int found = grid_within(grid, point.x, point.y, radius);
+    for (int k = 0; k < found; k++) {
+        const int i = grid->hits[k];
+        if (i < first || i >= last)
+            continue;
+        if (count < max)
+            out[count] = &scene->roster.views[i];
+        count++;
+    }
+    return count;
+}
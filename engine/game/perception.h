@@ -0,0 +1,147 @@
+/**
+ * @file perception.h
+ * @brief Per-tick geometry shared by every coach callback.
+ * * Coaches keep asking the same questions: how far am I from the ball, do I
+ * touch it, who is the most advanced teammate, who is the nearest opponent.
+ * Instead of every player redoing the whole roster's worth of geometry,
+ * the scene answers them from one block computed at most once per tick.
+ *
+ * The block is lazy, and every part of it is built on the first query of a
+ * tick that needs it and only then: the ball offsets (offset and distance
+ * from each player to the ball), the attack orderings, the ball's predicted
+ * path (see trajectory.h), the player-pair distance matrix, and the grid (a
+ * spatial hash, see grid.h) behind the proximity queries: nearest teammate,
+ * opponent or player, and players within a radius. The grid is relinked
+ * incrementally, so those queries stay cheap however big the rosters get;
+ * rosters smaller than GRID_MIN_PLAYERS are simply scanned, with the same
+ * answers. Questions that cost no more to answer than to look up, whether a
+ * player touches the ball and how far they are from a goal, are not cached.
+ * think_scene() invalidates the block, so during the THINK and ACT passes it
+ * describes the positions the coaches see. Positions do not change until
+ * move_scene(), except at set pieces: set_piece_goal() and set_piece_out()
+ * place the players and the ball and invalidate the block after them, so a
+ * kick-off or kick-in sees where everyone now stands. Anything else that
+ * moves players or the ball outside move_scene() has to do the same.
+ *
+ * Players are identified by roster index (see roster.h); every query also
+ * has a `struct Player*` form for coaches. The arrays are sized for the
+ * scene's roster by perception_init(), which init_scene() calls.
+ */
+
+#ifndef ENGINE_GAME_PERCEPTION_H
+#define ENGINE_GAME_PERCEPTION_H
+
+#include <stdbool.h>
+
+#include "core/vec2.h"
+#include "entities/field.h"
+#include "game/grid.h"
+#include "game/trajectory.h"
+
+struct Scene;
+struct Player;
+
+/** @brief Which goal: the one team 1 defends (left) or the one team 2 defends (right). */
+enum PerceptionGoal {
+    GOAL_LEFT,
+    GOAL_RIGHT
+};
+
+struct Perception {
+    bool offsets_ready;
+    bool order_ready;
+    bool path_ready;
+    bool pairs_ready;
+    bool grid_ready;
+    int players;                /**< Both teams; every array below has one entry per player. */
+    int team_size;
+
+    /* ball offsets */
+    struct Vec2 *to_ball;       /**< Ball position minus player position. */
+    float *ball_distance;
+
+    /* attack orderings */
+    /** Per team, team_size roster indices from the most advanced (closest to the goal it attacks) back; ties by kit. */
+    int *attack_order[2];
+
+    /* ball path */
+    struct BallPath ball_path;  /**< Where the ball is headed; see trajectory.h. */
+
+    /* pairs */
+    float *distance;            /**< players x players, row-major: distance[i * players + j]. */
+
+    /* grid */
+    struct Grid grid;           /**< Player positions hashed over the world; see grid.h. */
+
+    void *block;                /**< Backing storage for every array above. */
+};
+
+/**
+ * @brief Allocates the arrays for two teams of `team_size` players on `field`.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int perception_init(struct Perception *perception, int team_size, const Field *field);
+
+void perception_free(struct Perception *perception);
+
+/** @brief Forgets everything; the next query recomputes. Call it whenever positions change. */
+void perception_invalidate(struct Perception *perception);
+
+/** @brief The roster index of `player` in `scene`. */
+int perception_index(const struct Scene *scene, const struct Player *player);
+
+/** @brief The ball offsets (to_ball, ball_distance), built if needed. */
+const struct Perception *perception_ball(struct Scene *scene);
+
+/** @brief The pair distances, built if needed. */
+const struct Perception *perception_pairs(struct Scene *scene);
+
+/** @brief The grid part, brought up to date if needed. */
+struct Grid *perception_grid(struct Scene *scene);
+
+/** @name Coach queries */
+///@{
+float perception_ball_distance(struct Scene *scene, const struct Player *player);
+
+/** @brief Hitboxes overlap (squared distances, no root), or the ball ran into `player` during the last move (Scene::ball_contact). */
+bool perception_touches_ball(struct Scene *scene, const struct Player *player);
+
+/** @brief Distance from `player` to the centre of `goal`'s mouth. */
+float perception_goal_distance(struct Scene *scene, const struct Player *player, enum PerceptionGoal goal);
+
+/**
+ * @brief How soon `player`, running at `speed`, can first touch the ball,
+ * and (if `point` is not NULL) where the ball is then: ball_intercept_time()
+ * on the shared ball path. INFINITY if never; `point` is then left alone.
+ */
+float perception_intercept(struct Scene *scene, const struct Player *player, float speed, struct Vec2 *point);
+float perception_distance(struct Scene *scene, const struct Player *a, const struct Player *b);
+struct Player *perception_nearest_teammate(struct Scene *scene, const struct Player *player);
+struct Player *perception_nearest_opponent(struct Scene *scene, const struct Player *player);
+
+/**
+ * @brief The `team` player closest to the goal it attacks, skipping `exclude` (may be NULL).
+ * Among equally advanced players the lowest kit wins.
+ */
+struct Player *perception_most_advanced(struct Scene *scene, int team, const struct Player *exclude);
+
+/** @brief The `team` player closest to the ball; the lowest kit wins ties. */
+struct Player *perception_nearest_to_ball(struct Scene *scene, int team);
+
+/**
+ * @brief The player of `team` (0 for either) closest to `point`, skipping
+ * `exclude` (may be NULL); ties go to the lower roster index.
+ */
+struct Player *perception_nearest_player(struct Scene *scene, struct Vec2 point, int team,
+                                         const struct Player *exclude);
+
+/**
+ * @brief The players of `team` (0 for either) whose centre is within `radius`
+ * of `point`, in roster order. At most `max` are written to `out`.
+ * @return How many there are, which may be more than `max`.
+ */
+int perception_players_within(struct Scene *scene, struct Vec2 point, float radius, int team,
+                              struct Player **out, int max);
+///@}
+
+#endif /* ENGINE_GAME_PERCEPTION_H */
@@ -1,23 +1,69 @@
 #include "possession.h"
 #include "entities/team.h"
+#include "core/profile.h"
 
+#include <math.h>
 #include <stdlib.h>
-#include <time.h>
 #include <stdio.h>
 
 /**
- * @brief Internal helper to check if a player's circular hitbox overlaps the ball's.
+ * @brief Checks if a player's circular hitbox overlaps the ball's.
  * @return 1 if colliding, 0 otherwise.
  */
-static int is_colliding(const struct Player* p, const struct Ball* b) {
+int is_colliding(const struct Roster* roster, int idx, const struct Ball* b) {
     // Standard Circle-to-Circle collision math: (dist^2 <= combined_radius^2)
-    float dx = p->position.x - b->position.x;
-    float dy = p->position.y - b->position.y;
+    float dx = roster->pos_x[idx] - b->position.x;
+    float dy = roster->pos_y[idx] - b->position.y;
     float dist_sq = dx * dx + dy * dy;
-    float radius_sum = p->radius + b->radius;
+    float radius_sum = roster->radius[idx] + b->radius;
     return dist_sq <= radius_sum * radius_sum;
 }
 
+/**
+ * @brief Finds when the ball first touches a player as both travel for `dt`.
+ *
+ * With d the ball's offset from the player and w their relative velocity,
+ * they touch once |d + w t| reaches the sum of the radii R. That is the
+ * smaller root of a t^2 + 2 b t + c = 0 with a = w.w, b = d.w and
+ * c = d.d - R^2, written as c / (-b + sqrt(b^2 - a c)): no division by a,
+ * and no cancellation when they barely close in.
+ * Players already touching the ball are skipped: the coaches saw that touch
+ * this tick, and a ball passing through someone who let it go must not stop.
+ */
+int first_ball_contact(const struct Scene* scene, float dt, struct Vec2 shift, float* impact) {
+    const struct Roster* roster = &scene->roster;
+    const struct Ball* ball = scene->ball;
+    const float ball_vx = shift.x / dt;
+    const float ball_vy = shift.y / dt;
+    int first = -1;
+    float best = dt;
+
+    for (int idx = 0; idx < roster->count; idx++) {
+        const float dx = ball->position.x - roster->pos_x[idx];
+        const float dy = ball->position.y - roster->pos_y[idx];
+        const float wx = ball_vx - roster->vel_x[idx];
+        const float wy = ball_vy - roster->vel_y[idx];
+        const float reach = roster->radius[idx] + ball->radius;
+        const float c = dx * dx + dy * dy - reach * reach;
+        if (c <= 0.0f)
+            continue;       // already touching
+        const float b = dx * wx + dy * wy;
+        if (b >= 0.0f)
+            continue;       // not closing in
+        const float disc = b * b - (wx * wx + wy * wy) * c;
+        if (disc < 0.0f)
+            continue;       // passes by
+        const float t = c / (-b + sqrtf(disc));
+        if (t < best || (first < 0 && t <= best)) {
+            first = idx;
+            best = t;
+        }
+    }
+    if (first >= 0)
+        *impact = best;
+    return first;
+}
+
 /**
  * @brief Resolves a tackle attempt on the ball by a player.
  *
@@ -26,7 +72,8 @@ static int is_colliding(const struct Player* p, const struct Ball* b) {
  * the current possessor's dribbling skill and uses a weighted random roll
  * to determine if the tackle is successful.
  */
-void tackle(struct Player* player, struct Ball* ball) {
+void tackle(struct Player* player, struct Scene* scene) {
+    struct Ball* ball = scene->ball;
     if (!ball->possessor) {
         ball->possessor = player;
         ball->velocity.x = player->velocity.x;
@@ -38,8 +85,7 @@ void tackle(struct Player* player, struct Ball* ball) {
     int dribble_score = ball->possessor->talents.dribbling;
     int sum = defence_score + dribble_score;
 
-    srand((unsigned int)time(NULL));
-    int random_roll = rand() % sum;
+    int random_roll = (int)rng_range(&scene->rng, (uint32_t)sum);
 
     if (random_roll < defence_score) {
         ball->possessor = player;
@@ -48,24 +94,72 @@ void tackle(struct Player* player, struct Ball* ball) {
     }
 }
 
+/** @brief Tackles for roster player `idx` if it is intercepting and touches the ball, or the ball ran into it. */
+static void contest(struct Scene* scene, int idx) {
+    const struct Roster* roster = &scene->roster;
+    if (roster->state[idx] == INTERCEPTING && (is_colliding(roster, idx, scene->ball) || idx == scene->ball_contact))
+        tackle(&roster->views[idx], scene);
+}
+
+/** @brief Where roster player `idx` comes in the visiting order: first team kit i, then second team kit i. */
+static int kit_order(int idx, int half) {
+    return idx < half ? 2 * idx : 2 * (idx - half) + 1;
+}
+
 /**
  * @brief Updates which player currently possesses the ball.
  *
- * Iterates through all players on both teams and checks if any player
- * in the INTERCEPTING state is colliding with the ball.  
+ * Checks every player in the INTERCEPTING state for contact with the ball
+ * (or for having been run into by it during the last move).
  * If so, calls `tackle()` to potentially transfer possession.
+ * Reads the roster arrays, so roster_gather() must have run this tick.
+ * Players are visited first team kit i, then second team kit i, as before.
+ * When the coaches' proximity queries brought the perception grid up to date
+ * this tick and there are GRID_LOOKUP_MIN_PLAYERS players or more, only the
+ * players the grid finds near the ball are checked, plus the one the ball
+ * ran into (it rolls on past them, so they may be out of reach of the
+ * query), in the same order.
  */
 void update_ball_possessor(struct Scene* scene) {
-    struct Ball* ball = scene->ball;
-
-    for (int i = 0; i < PLAYER_COUNT; i++) {
-        struct Player* p1 = scene->first_team->players[i];
-        struct Player* p2 = scene->second_team->players[i];
-
-        if (p1 && p1->state == INTERCEPTING && is_colliding(p1, ball))
-            tackle(p1, ball);
+    const struct Ball* ball = scene->ball;
+    const struct Roster* roster = &scene->roster;
+    const int half = roster->count / 2;
 
-        if (p2 && p2->state == INTERCEPTING && is_colliding(p2, ball))
-            tackle(p2, ball);
+    PROFILE_BEGIN(PROFILE_POSSESSION);
+    if (!scene->perception.grid_ready || roster->count < GRID_LOOKUP_MIN_PLAYERS) {
+        for (int i = 0; i < half; i++) {
+            contest(scene, i);
+            contest(scene, half + i);
+        }
+    } else {
+        // the coaches have not moved anyone since the grid was updated
+        struct Grid* grid = &scene->perception.grid;
+        const int found = grid_within(grid, ball->position.x, ball->position.y, ball->radius + grid->max_radius);
+        int contact = scene->ball_contact;
+        for (int k = 0; k < found && contact >= 0; k++)
+            if (grid->hits[k] == contact)
+                contact = -1;
+        // hits are ascending: merge the two teams (and the contact) back into kit order
+        int a = 0, b = 0;
+        while (b < found && grid->hits[b] < half)
+            b++;
+        const int first_end = b;
+        while (a < first_end || b < found || contact >= 0) {
+            int next = -1;
+            if (a < first_end)
+                next = grid->hits[a];
+            if (b < found && (next < 0 || kit_order(grid->hits[b], half) < kit_order(next, half)))
+                next = grid->hits[b];
+            if (contact >= 0 && (next < 0 || kit_order(contact, half) < kit_order(next, half)))
+                next = contact;
+            if (next == contact)
+                contact = -1;
+            else if (a < first_end && next == grid->hits[a])
+                a++;
+            else
+                b++;
+            contest(scene, next);
+        }
     }
+    PROFILE_END(PROFILE_POSSESSION);
 }
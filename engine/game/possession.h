@@ -12,12 +12,35 @@
 #include "entities/ball.h"
 #include "entities/player.h"
 
+/**
+ * @brief Checks whether roster player `idx` touches the ball (circle overlap).
+ * Reads the roster arrays, so they must be current (roster_gather()).
+ * Only the end positions are compared: update_ball_possessor() and the
+ * perception layer also count Scene::ball_contact as touching.
+ * @return 1 if colliding, 0 otherwise.
+ */
+int is_colliding(const struct Roster* roster, int idx, const struct Ball* b);
+
+/**
+ * @brief Swept ball-vs-player test: the first player the ball runs into
+ * during the next `dt`, with the ball moving by `shift` over it and every
+ * player at their velocity, all in straight lines from where they are now
+ * (the roster arrays, before the move). The ball is taken to cover its
+ * shift evenly over the tick.
+ * Players already touching the ball are skipped: the coaches have seen those.
+ * Ties go to the lowest roster index.
+ * @param impact Set to the time of impact in (0, dt]; left alone if nobody is met.
+ * @return The player's roster index, or -1.
+ */
+int first_ball_contact(const struct Scene* scene, float dt, struct Vec2 shift, float* impact);
+
 /**
  * @brief Resolves a contest for the ball between a player and the current possessor.
  * * This uses a "Weighted Random" roll based on player talents. 
  * If (Player's Defence) > (Possessor's Dribbling), the ball likely changes hands.
+ * The roll is drawn from the scene's own random stream (scene->rng).
  */
-void tackle(struct Player* player, struct Ball* ball);
+void tackle(struct Player* player, struct Scene* scene);
 
 /**
  * @brief Scans the field to see if any free player has touched the ball.
@@ -0,0 +1,242 @@
+#include "rollout.h"
+#include "core/constants.h"
+#include "core/profile.h"
+#include "entities/team.h"
+#include "logic/referee.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** @brief The rollout a scratch scene belongs to (Rollout::scene is its first member). */
+static struct Rollout* rollout_of(struct Scene* scene) {
+    return (struct Rollout*)scene;
+}
+
+/** @brief Sets Rollout::chaser: per team, the player nearest the ball (the lower kit on a tie). */
+static void pick_chasers(struct Rollout* rollout) {
+    const struct Roster* roster = &rollout->scene.roster;
+    const struct Ball* ball = &rollout->ball;
+    const int team_size = rollout->scene.team_size;
+    for (int t = 0; t < 2; t++) {
+        int best = t * team_size;
+        float best_d2 = INFINITY;
+        for (int i = t * team_size; i < (t + 1) * team_size; i++) {
+            const float dx = ball->position.x - roster->views[i].position.x;
+            const float dy = ball->position.y - roster->views[i].position.y;
+            const float d2 = dx * dx + dy * dy;
+            if (d2 < best_d2) {
+                best = i;
+                best_d2 = d2;
+            }
+        }
+        rollout->chaser[t] = best;
+    }
+}
+
+/** @brief Whether `self` touches the ball, as perception_touches_ball() has it. */
+static bool touches_ball(const struct Player* self, int idx, const struct Scene* scene) {
+    const struct Ball* ball = scene->ball;
+    const float dx = self->position.x - ball->position.x;
+    const float dy = self->position.y - ball->position.y;
+    const float reach = self->radius + ball->radius;
+    return dx * dx + dy * dy <= reach * reach || idx == scene->ball_contact;
+}
+
+/** @brief Default policy, state: the holder dribbles, the chaser of each team runs and tackles, the rest stand. */
+static void rollout_change_state(struct Player* self, struct Scene* scene) {
+    const struct Player* holder = scene->ball->possessor;
+    const int idx = roster_handle(&scene->roster, self);
+    struct Rollout* rollout = rollout_of(scene);
+    if (idx == rollout->kicker) {
+        if (touches_ball(self, idx, scene)) {
+            self->state = IDLE;     // let the ball go first
+            return;
+        }
+        rollout->kicker = -1;
+    }
+    if (holder == self)
+        self->state = MOVING;
+    else if (holder && holder->team == self->team)
+        self->state = IDLE;
+    else if (touches_ball(self, idx, scene))
+        self->state = INTERCEPTING;
+    else if (idx == rollout->chaser[self->team - 1])
+        self->state = MOVING;
+    else
+        self->state = IDLE;
+}
+
+/** @brief Default policy, movement: the holder keeps their velocity, the chaser runs at the ball at top speed. */
+static void rollout_movement(struct Player* self, struct Scene* scene) {
+    if (scene->ball->possessor == self)
+        return;
+    const float dx = scene->ball->position.x - self->position.x;
+    const float dy = scene->ball->position.y - self->position.y;
+    const float d = hypotf(dx, dy);
+    if (d <= 0.001f) {
+        self->velocity.x = 0.0f;
+        self->velocity.y = 0.0f;
+        return;
+    }
+    const float max_v = ((float)self->talents.agility / MAX_TALENT_PER_SKILL) * MAX_PLAYER_VELOCITY;
+    self->velocity.x = dx / d * max_v;
+    self->velocity.y = dy / d * max_v;
+}
+
+/** @brief Default policy, shooting: never called, since nobody is put in SHOOTING. */
+static void rollout_shooting(struct Player* self, struct Scene* scene) {
+    (void)self;
+    (void)scene;
+}
+
+int rollout_init(struct Rollout* rollout, int team_size, const Field* field) {
+    // Ball and Scene carry const members, so they are built on the stack and copied in.
+    struct Ball fresh_ball = make_ball(0, 0);
+    memcpy(&rollout->ball, &fresh_ball, sizeof(struct Ball));
+    Scene fresh_scene = {
+        .field = *field,
+        .team_size = team_size,
+        .ball = &rollout->ball
+    };
+    memcpy(&rollout->scene, &fresh_scene, sizeof(Scene));
+    rollout->budget = 0;
+    rollout->kicker = -1;
+
+    Scene* scene = &rollout->scene;
+    if (init_scene(scene) != 0)
+        return -1;
+    for (int i = 0; i < scene->roster.count; i++) {
+        struct Player* p = &scene->roster.views[i];
+        p->movement_logic = rollout_movement;
+        p->shooting_logic = rollout_shooting;
+        p->change_state_logic = rollout_change_state;
+    }
+    return 0;
+}
+
+void rollout_free(struct Rollout* rollout) {
+    destroy_scene(&rollout->scene);
+}
+
+void rollout_set_budget(struct Rollout* rollout, long ticks) {
+    rollout->budget = ticks;
+}
+
+int rollout_clone(struct Rollout* rollout, const Scene* source) {
+    Scene* scene = &rollout->scene;
+    if (source->team_size != scene->team_size || memcmp(&source->field, &scene->field, sizeof(Field)) != 0)
+        return -1;
+
+    struct Roster* roster = &scene->roster;
+    const struct Roster* from = &source->roster;
+    for (int i = 0; i < roster->count; i++) {
+        struct Player* p = &roster->views[i];
+        const struct Player* q = &from->views[i];
+        p->position = q->position;
+        p->velocity = q->velocity;
+        p->state = q->state;
+        memcpy((void*)&p->talents, &q->talents, sizeof(struct Talents));   // const member
+    }
+    memcpy(roster->sweep, from->sweep, sizeof(int) * (size_t)roster->count);
+
+    const struct Ball* ball = source->ball;
+    rollout->ball.position = ball->position;
+    rollout->ball.velocity = ball->velocity;
+    rollout->ball.possessor = roster_player(roster, roster_handle(from, ball->possessor));
+    rollout->ball.last_team = ball->last_team;
+
+    scene->first_team->score = source->first_team->score;
+    scene->second_team->score = source->second_team->score;
+    scene->body_collisions = source->body_collisions;
+    scene->state = source->state;
+    scene->wait_time = source->wait_time;
+    scene->remaining_time = source->remaining_time;
+    scene->ball_from = source->ball_from;
+    scene->ball_to = source->ball_to;
+    scene->ball_contact = source->ball_contact;
+    scene->ball_contact_time = source->ball_contact_time;
+    scene->rng = source->rng;
+    perception_invalidate(&scene->perception);
+    rollout->kicker = -1;
+    return 0;
+}
+
+void rollout_kick(struct Rollout* rollout, struct Vec2 velocity) {
+    rollout->kicker = roster_handle(&rollout->scene.roster, rollout->ball.possessor);
+    rollout->ball.velocity = velocity;
+    rollout->ball.possessor = NULL;
+}
+
+/** @brief rollout_run() without the profiling around it. */
+static int play(struct Rollout* rollout, int ticks, float dt, struct RolloutOutcome* outcome) {
+    Scene* scene = &rollout->scene;
+    struct Ball* ball = &rollout->ball;
+    struct Roster* roster = &scene->roster;
+    int holder = roster_handle(roster, ball->possessor);
+
+    memset(outcome, 0, sizeof(*outcome));
+    outcome->first_gain = -1;
+    for (int t = 1; t <= ticks; t++) {
+        if (rollout->budget <= 0) {
+            outcome->exhausted = true;
+            break;
+        }
+        rollout->budget--;
+        outcome->ticks = t;
+
+        pick_chasers(rollout);
+        think_scene(scene);
+        const int now = roster_handle(roster, ball->possessor);
+        if (now >= 0 && now != holder && outcome->first_gain < 0) {
+            outcome->first_gain = now;
+            outcome->first_gain_tick = t;
+        }
+        holder = now;
+        move_scene(scene, dt);
+
+        // referee() without the reporting and scoring: the rollout just ends
+        int scored;
+        bool is_out;
+        const float s = referee_sweep(&scene->field, scene->ball_from.x, scene->ball_from.y,
+                                      scene->ball_to.x, scene->ball_to.y, &scored, &is_out);
+        if (scored || is_out) {
+            outcome->goal = scored;
+            outcome->out = !scored;
+            outcome->possessor = -1;
+            outcome->last_team = ball->last_team;
+            outcome->ball.x = scene->ball_from.x + (scene->ball_to.x - scene->ball_from.x) * s;
+            outcome->ball.y = scene->ball_from.y + (scene->ball_to.y - scene->ball_from.y) * s;
+            return outcome->ticks;
+        }
+    }
+    outcome->possessor = roster_handle(roster, ball->possessor);
+    outcome->last_team = ball->last_team;
+    outcome->ball = ball->position;
+    return outcome->ticks;
+}
+
+int rollout_run(struct Rollout* rollout, int ticks, float dt, struct RolloutOutcome* outcome) {
+    // the scratch ticks are timed as one rollout, not as match ticks
+    PROFILE_BEGIN(PROFILE_ROLLOUT);
+    PROFILE_SUSPEND();
+    const int played = play(rollout, ticks, dt, outcome);
+    PROFILE_RESUME();
+    PROFILE_END(PROFILE_ROLLOUT);
+    return played;
+}
+
+struct Rollout* scene_rollout(Scene* scene) {
+    if (!scene->rollout) {
+        struct Rollout* rollout = malloc(sizeof(*rollout));
+        if (!rollout)
+            return NULL;
+        if (rollout_init(rollout, scene->team_size, &scene->field) != 0) {
+            free(rollout);
+            return NULL;
+        }
+        rollout->budget = ROLLOUT_TICK_BUDGET;
+        scene->rollout = rollout;
+    }
+    return scene->rollout;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file rollout.h
+ * @brief Lookahead for planning coaches: copy the match into a scratch scene
+ * and play it forward a few ticks with cheap stand-in policies.
+ * * A Rollout owns a complete Scene, built once for a team size and pitch.
+ * rollout_clone() copies the match state into it without allocating: the
+ * roster is flat (one block of players, addressed by roster index), so the
+ * teams, the ball's possessor (a roster_handle()) and every per-player array
+ * of the scratch scene already point at their own storage and only the
+ * values are copied. The caller then tries a move on the scratch scene, e.g.
+ * rollout_kick() for a pass, and rollout_run() plays it forward.
+ *
+ * In a rollout every player follows the same default policy instead of its
+ * coach: whoever holds the ball runs on at their current velocity, the
+ * player of each team nearest the ball runs at it and tackles it once they
+ * touch it (never a teammate), and everyone else stands. Nobody shoots. The physics, possession
+ * and goal/out checks are the real ones, so a rollout is only as different
+ * from the match as those policies are from the coaches. Set pieces and the
+ * match clock are not played: a rollout stops at the first goal or out.
+ *
+ * Rollouts never touch the scene they were cloned from, including its random
+ * stream, so a coach that plans with them keeps the match reproducible. The
+ * ball model and the swept contacts hold at coarse steps, so rollouts can
+ * run at a bigger dt than the match (e.g. 1/15 s) for a fraction of the
+ * cost; clearing scene.body_collisions on the scratch scene saves more.
+ * Two seconds at 15 Hz cost about 12 us for six a side. Under --profile a
+ * rollout_run() counts as one PROFILE_ROLLOUT span; the ticks it plays are
+ * kept out of the match's phases.
+ */
+
+#ifndef ENGINE_GAME_ROLLOUT_H
+#define ENGINE_GAME_ROLLOUT_H
+
+#include <stdbool.h>
+
+#include "core/vec2.h"
+#include "entities/ball.h"
+#include "game/scene.h"
+
+/** @brief Rollout ticks a scene's own rollout (scene_rollout()) may play per match tick: a thousand 2-second rollouts at 15 Hz. */
+#define ROLLOUT_TICK_BUDGET 30000
+
+/**
+ * @struct Rollout
+ * @brief A scratch scene and the rollout ticks it may still play.
+ */
+struct Rollout {
+    Scene scene;            /**< The scratch scene; edit it between rollout_clone() and rollout_run() to try a move. Must stay first: the policies find the rollout from it. */
+    struct Ball ball;       /**< scene.ball points here. */
+    long budget;            /**< Ticks rollout_run() may still play; see rollout_set_budget(). */
+    int chaser[2];          /**< This tick, per team, the roster index of the player nearest the ball. */
+    int kicker;             /**< Roster index of the player rollout_kick() released the ball from, until they stop touching it; else -1. */
+};
+
+/**
+ * @struct RolloutOutcome
+ * @brief How a rollout ended.
+ */
+struct RolloutOutcome {
+    int ticks;              /**< Ticks played: fewer than asked after a goal or out, or when the budget ran out. */
+    bool exhausted;         /**< The budget ran out before the rollout was done. */
+    int goal;               /**< Team that scored (1 or 2), or 0. */
+    bool out;               /**< The ball went out without a goal. */
+    int possessor;          /**< Roster index holding the ball at the end, or -1. */
+    int last_team;          /**< Team that last had the ball at the end (Ball::last_team). */
+    int first_gain;         /**< Roster index of the first player to win the ball during the rollout, or -1. */
+    int first_gain_tick;    /**< Tick (1-based) at which they won it; 0 if nobody did. */
+    struct Vec2 ball;       /**< Ball position at the end (where it crossed the line after a goal or out). */
+};
+
+/**
+ * @brief Builds the scratch scene for two teams of `team_size` on `field`
+ * (with init_scene(): this is the only allocation a rollout makes). The budget starts empty.
+ * @return 0 on success, -1 if init_scene() failed (nothing to free then).
+ */
+int rollout_init(struct Rollout* rollout, int team_size, const Field* field);
+
+/** @brief Frees the scratch scene. */
+void rollout_free(struct Rollout* rollout);
+
+/** @brief Sets how many ticks rollout_run() may play from now on, across all rollouts. */
+void rollout_set_budget(struct Rollout* rollout, long ticks);
+
+/**
+ * @brief Copies the state of `source` into the scratch scene: players,
+ * ball and holder, scores, GameState, timers and random stream. O(players), no allocation.
+ * @return 0 on success, -1 if `source` has another team size or pitch than the rollout.
+ */
+int rollout_clone(struct Rollout* rollout, const Scene* source);
+
+/**
+ * @brief Releases the ball from whoever holds it at `velocity`, as a pass
+ * or shot by them would (no speed limit is applied). The kicker stands and
+ * does not try to win the ball back until it has left them.
+ */
+void rollout_kick(struct Rollout* rollout, struct Vec2 velocity);
+
+/**
+ * @brief Plays the scratch scene forward by up to `ticks` steps of `dt`
+ * with the default policies, stopping at the first goal or out.
+ * @return outcome->ticks.
+ */
+int rollout_run(struct Rollout* rollout, int ticks, float dt, struct RolloutOutcome* outcome);
+
+/**
+ * @brief The scene's own rollout, for coaches: built on first use and freed
+ * by destroy_scene(). Its budget is refilled to ROLLOUT_TICK_BUDGET at the
+ * start of every match tick, so planning costs at most that much per tick.
+ * @return NULL if the rollout could not be built.
+ */
+struct Rollout* scene_rollout(Scene* scene);
+
+#endif /* ENGINE_GAME_ROLLOUT_H */
@@ -0,0 +1,240 @@
+#define _POSIX_C_SOURCE 200112L // posix_memalign
+#include "roster.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The block is 32-byte aligned, and array lengths are rounded up to 8 lanes
+// so every array after the first starts on its own 32-byte boundary too.
+#define ROSTER_ALIGN 32
+#define ROSTER_LANE_PAD 8
+
+static size_t padded(int count) {
+    return (size_t)((count + ROSTER_LANE_PAD - 1) / ROSTER_LANE_PAD * ROSTER_LANE_PAD);
+}
+
+int roster_init(struct Roster *roster, int count) {
+    const size_t n = padded(count);
+    const size_t views_size = sizeof(struct Player) * n;
+    const size_t floats_size = sizeof(float) * n;
+    const size_t state_size = sizeof(PlayerActionState) * n;
+    const size_t talents_size = sizeof(struct Talents) * n;
+    const size_t sweep_size = sizeof(int) * n;
+    const size_t contacts = n * ROSTER_CONTACTS_PER_PLAYER;
+    const size_t contacts_size = (sizeof(int) * 2 + sizeof(float) * 4) * contacts;
+    const size_t total = views_size + floats_size * 9 + state_size + talents_size + sweep_size + contacts_size;
+
+    void *storage = NULL;
+    if (posix_memalign(&storage, ROSTER_ALIGN, total) != 0)
+        return -1;
+    memset(storage, 0, total);
+
+    char *block = storage;
+    roster->count = count;
+    roster->block = block;
+    roster->views = (struct Player *)block;           block += views_size;
+    roster->pos_x = (float *)block;                   block += floats_size;
+    roster->pos_y = (float *)block;                   block += floats_size;
+    roster->vel_x = (float *)block;                   block += floats_size;
+    roster->vel_y = (float *)block;                   block += floats_size;
+    roster->radius = (float *)block;                  block += floats_size;
+    roster->state = (PlayerActionState *)block;       block += state_size;
+    roster->talents = (struct Talents *)block;        block += talents_size;
+    roster->sweep = (int *)block;                     block += sweep_size;
+    roster->sweep_left = (float *)block;              block += floats_size;
+    roster->sweep_x = (float *)block;                 block += floats_size;
+    roster->sweep_y = (float *)block;                 block += floats_size;
+    roster->sweep_radius = (float *)block;            block += floats_size;
+    roster->contact_capacity = (int)contacts;
+    roster->contact_dx = (float *)block;              block += sizeof(float) * contacts;
+    roster->contact_dy = (float *)block;              block += sizeof(float) * contacts;
+    roster->contact_d2 = (float *)block;              block += sizeof(float) * contacts;
+    roster->contact_reach = (float *)block;           block += sizeof(float) * contacts;
+    roster->contact_a = (int *)block;                 block += sizeof(int) * contacts;
+    roster->contact_b = (int *)block;
+    for (int i = 0; i < count; i++)
+        roster->sweep[i] = i;
+    return 0;
+}
+
+void roster_free(struct Roster *roster) {
+    free(roster->block);
+    memset(roster, 0, sizeof(*roster));
+}
+
+int roster_handle(const struct Roster *roster, const struct Player *player) {
+    return player ? (int)(player - roster->views) : -1;
+}
+
+struct Player *roster_player(struct Roster *roster, int handle) {
+    return (handle >= 0 && handle < roster->count) ? &roster->views[handle] : NULL;
+}
+
+void roster_gather(struct Roster *roster) {
+    const struct Player *views = roster->views;
+    for (int i = 0; i < roster->count; i++) {
+        roster->pos_x[i] = views[i].position.x;
+        roster->pos_y[i] = views[i].position.y;
+        roster->vel_x[i] = views[i].velocity.x;
+        roster->vel_y[i] = views[i].velocity.y;
+        roster->radius[i] = views[i].radius;
+        roster->state[i] = views[i].state;
+        roster->talents[i] = views[i].talents;
+    }
+}
+
+void roster_scatter_positions(struct Roster *roster) {
+    struct Player *views = roster->views;
+    for (int i = 0; i < roster->count; i++) {
+        views[i].position.x = roster->pos_x[i];
+        views[i].position.y = roster->pos_y[i];
+    }
+}
+
+void roster_integrate(struct Roster *roster, const float dt) {
+    float *restrict px = roster->pos_x;
+    float *restrict py = roster->pos_y;
+    const float *restrict vx = roster->vel_x;
+    const float *restrict vy = roster->vel_y;
+    const int n = roster->count;
+
+    for (int i = 0; i < n; i++) {
+        px[i] += vx[i] * dt;
+        py[i] += vy[i] * dt;
+    }
+}
+
+void roster_clamp(struct Roster *roster, const float width, const float height) {
+    float *restrict px = roster->pos_x;
+    float *restrict py = roster->pos_y;
+    const float *restrict rad = roster->radius;
+    const int n = roster->count;
+
+    // Branch-free selects so the loop vectorizes; same order as the old per-player ifs.
+    for (int i = 0; i < n; i++) {
+        float x = px[i];
+        float y = py[i];
+        x = (x < rad[i]) ? rad[i] : x;
+        x = (x > width - rad[i]) ? width - rad[i] : x;
+        y = (y < rad[i]) ? rad[i] : y;
+        y = (y > height - rad[i]) ? height - rad[i] : y;
+        px[i] = x;
+        py[i] = y;
+    }
+}
+
+/** @brief Applies the first `count` contacts found by roster_collide(), each from the positions they were found at. */
+static void resolve_contacts(struct Roster *roster, int count) {
+    float *restrict dx = roster->contact_dx;
+    float *restrict dy = roster->contact_dy;
+    const float *restrict d2 = roster->contact_d2;
+    const float *restrict reach = roster->contact_reach;
+
+    // each moves half the overlap along the line between the centres;
+    // no branches and no calls, so this loop vectorizes
+    for (int c = 0; c < count; c++) {
+        const float d = sqrtf(d2[c]);
+        const float scale = (reach[c] - d) * 0.5f / d;
+        dx[c] *= scale;
+        dy[c] *= scale;
+    }
+    for (int c = 0; c < count; c++) {
+        const int a = roster->contact_a[c];
+        const int b = roster->contact_b[c];
+        roster->pos_x[a] -= dx[c];
+        roster->pos_y[a] -= dy[c];
+        roster->pos_x[b] += dx[c];
+        roster->pos_y[b] += dy[c];
+    }
+}
+
+void roster_collide(struct Roster *roster, const float width, const float height) {
+    float *px = roster->pos_x;
+    float *py = roster->pos_y;
+    const float *rad = roster->radius;
+    int *restrict sweep = roster->sweep;
+    float *restrict left = roster->sweep_left;
+    float *restrict sx = roster->sweep_x;
+    float *restrict sy = roster->sweep_y;
+    float *restrict sr = roster->sweep_radius;
+    int *restrict pair_a = roster->contact_a;
+    int *restrict pair_b = roster->contact_b;
+    float *restrict pair_dx = roster->contact_dx;
+    float *restrict pair_dy = roster->contact_dy;
+    float *restrict pair_d2 = roster->contact_d2;
+    float *restrict pair_reach = roster->contact_reach;
+    const int capacity = roster->contact_capacity;
+    const int n = roster->count;
+
+    // copied out in last tick's order, so the sort and the sweep read them contiguously
+    for (int k = 0; k < n; k++) {
+        const int i = sweep[k];
+        sx[k] = px[i];
+        sy[k] = py[i];
+        sr[k] = rad[i];
+        left[k] = px[i] - rad[i];
+    }
+
+    // that order is nearly sorted already
+    for (int k = 1; k < n; k++) {
+        const float key = left[k];
+        if (left[k - 1] <= key)
+            continue;
+        const int i = sweep[k];
+        const float x = sx[k], y = sy[k], r = sr[k];
+        int j = k;
+        while (j > 0 && left[j - 1] > key) {
+            sweep[j] = sweep[j - 1];
+            left[j] = left[j - 1];
+            sx[j] = sx[j - 1];
+            sy[j] = sy[j - 1];
+            sr[j] = sr[j - 1];
+            j--;
+        }
+        sweep[j] = i;
+        left[j] = key;
+        sx[j] = x;
+        sy[j] = y;
+        sr[j] = r;
+    }
+
+    bool moved = false;
+    int contacts = 0;
+    for (int k = 0; k < n; k++) {
+        const float right = sx[k] + sr[k];
+        for (int m = k + 1; m < n && left[m] <= right; m++) {
+            const float reach = sr[k] + sr[m];
+            const float dx = sx[m] - sx[k];
+            const float dy = sy[m] - sy[k];
+            const float d2 = dx * dx + dy * dy;
+            if (d2 == 0.0f) {
+                // on top of each other: no direction to push along, so the lower index goes left
+                const int a = sweep[k], b = sweep[m];
+                const float push = (a < b) ? reach * 0.5f : -reach * 0.5f;
+                px[a] -= push;
+                px[b] += push;
+                moved = true;
+                continue;
+            }
+            // whether a pair overlaps is a coin flip in a crowd, so rather than
+            // branch on it every pair is written and only overlaps are kept
+            pair_a[contacts] = sweep[k];
+            pair_b[contacts] = sweep[m];
+            pair_dx[contacts] = dx;
+            pair_dy[contacts] = dy;
+            pair_d2[contacts] = d2;
+            pair_reach[contacts] = reach;
+            contacts += d2 < reach * reach;
+            if (contacts == capacity) {
+                resolve_contacts(roster, contacts);
+                moved = true;
+                contacts = 0;
+            }
+        }
+    }
+    resolve_contacts(roster, contacts);
+    if (moved || contacts > 0)
+        roster_clamp(roster, width, height);
+}
@@ -0,0 +1,103 @@
+/**
+ * @file roster.h
+ * @brief Structure-of-arrays storage for every player on the pitch.
+ * * The simulation core walks players as flat float arrays (positions,
+ * velocities, radii) so the per-tick integrate and clamp passes are tight
+ * loops the compiler can vectorize. Coaches still receive `struct Player*`:
+ * those Player structs ("views") live in one contiguous block owned by the
+ * roster, and the physics step copies between views and arrays around its
+ * passes (roster_gather() / roster_scatter_positions()).
+ *
+ * Index layout: i in [0, team_size) is first team kit i,
+ * team_size + i is second team kit i, for the scene's team_size.
+ */
+
+#ifndef ENGINE_GAME_ROSTER_H
+#define ENGINE_GAME_ROSTER_H
+
+#include "entities/player.h"
+
+/** @brief Overlapping pairs roster_collide() batches per player before resolving them. */
+#define ROSTER_CONTACTS_PER_PLAYER 4
+
+/**
+ * @struct Roster
+ * @brief One allocation holding every per-player array of a scene.
+ */
+struct Roster {
+    int count;                  /**< Number of players (both teams). */
+    struct Player *views;       /**< Player structs handed to coaches; Team::players point in here. */
+    float *pos_x;
+    float *pos_y;
+    float *vel_x;
+    float *vel_y;
+    float *radius;
+    PlayerActionState *state;
+    struct Talents *talents;
+    int *sweep;                 /**< Roster indices by left edge (x - radius); kept across ticks by roster_collide(). */
+    float *sweep_left;          /**< roster_collide() scratch: left edge, x, y and radius in sweep order. */
+    float *sweep_x;
+    float *sweep_y;
+    float *sweep_radius;
+    int contact_capacity;       /**< roster_collide() scratch: overlapping pairs found by the sweep... */
+    int *contact_a;
+    int *contact_b;
+    float *contact_dx;          /**< ...their centre offsets (b - a), and then the push each gets. */
+    float *contact_dy;
+    float *contact_d2;
+    float *contact_reach;       /**< Sum of the two radii. */
+    void *block;                /**< Backing storage for every array above. */
+};
+
+/**
+ * @brief Allocates storage for `count` players. Views are left zeroed.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int roster_init(struct Roster *roster, int count);
+
+/** @brief Frees the roster storage (and with it every view). */
+void roster_free(struct Roster *roster);
+
+/**
+ * @brief Index-based handle of a player (roster index), for storing a
+ * reference outside the process, e.g. the ball's possessor in a checkpoint.
+ * @return The roster index of `player`, or -1 for NULL.
+ */
+int roster_handle(const struct Roster *roster, const struct Player *player);
+
+/** @brief The player behind a roster_handle(): NULL for -1 or any index out of range. */
+struct Player *roster_player(struct Roster *roster, int handle);
+
+/** @brief Copies position, velocity, radius, state and talents from the views into the arrays. */
+void roster_gather(struct Roster *roster);
+
+/** @brief Copies the array positions back into the views. */
+void roster_scatter_positions(struct Roster *roster);
+
+/** @brief position += velocity * dt for every player. */
+void roster_integrate(struct Roster *roster, float dt);
+
+/** @brief Keeps every player fully inside a width x height area. */
+void roster_clamp(struct Roster *roster, float width, float height);
+
+/**
+ * @brief Pushes overlapping players apart, teammates and opponents alike.
+ * * Sweep and prune on x: `sweep` is re-sorted by left edge with an
+ * insertion sort, which is close to linear because players barely reorder
+ * between ticks (left edge, x, y and radius are copied out in that order, so
+ * the sort and the sweep read contiguous arrays), then each player is only tested against those whose left
+ * edge lies before its right edge. Each overlapping pair moves apart by half
+ * the overlap each along the line between the centres (one pass, so big
+ * piles settle over a few ticks); everyone is then clamped to the width x
+ * height area again.
+ *
+ * The pairs are resolved together (Jacobi style): all pushes are computed
+ * from the same positions, in a loop the compiler vectorizes, then summed
+ * per player. Only when more than ROSTER_CONTACTS_PER_PLAYER pairs per
+ * player overlap is a full batch applied before the sweep goes on. Either
+ * way the result only depends on the positions and last tick's sweep order,
+ * so replaying a match reproduces it bit for bit.
+ */
+void roster_collide(struct Roster *roster, float width, float height);
+
+#endif /* ENGINE_GAME_ROSTER_H */
@@ -1,107 +1,237 @@
 #include "scene.h"
 #include "game/possession.h"
+#include "game/rollout.h"
+#include "game/trajectory.h"
 #include "entities/ball.h"
 #include "entities/team.h"
-#include "logic/coach.h"
+#include "logic/coach_plugin.h"
+#include "logic/referee.h"
+#include "core/log.h"
+#include "core/profile.h"
+#include "replay/recorder.h"
 
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 
 /**
  * @brief Initializes the game scene, including teams, players, and the ball.
  * @param scene Pointer to the Scene to initialize.
+ * @return 0 on success, -1 if the team size is out of range or an allocation failed.
  */
-void init_scene(struct Scene *scene) {
+int init_scene(struct Scene *scene) {
+    if (scene->team_size <= 0)
+        scene->team_size = DEFAULT_TEAM_SIZE;
+    if (scene->field.width <= 0.0f)
+        scene->field = field_default();
+    const int team_size = scene->team_size;
+    if (team_size > MAX_TEAM_SIZE)
+        return -1;
+
     scene->remaining_time = 120.0f; // 2 minutes game
     scene->wait_time = 0.0f;
-    scene->first_team = make_team_ptr();
-    scene->second_team = make_team_ptr();
+    // nothing is allocated yet: a failure below frees only what was built
+    memset(&scene->roster, 0, sizeof(scene->roster));
+    memset(&scene->violations, 0, sizeof(scene->violations));
+    memset(&scene->perception, 0, sizeof(scene->perception));
+    scene->rollout = NULL;
+    scene->first_team = make_team_ptr(team_size);
+    scene->second_team = make_team_ptr(team_size);
+    if (!scene->first_team || !scene->second_team ||
+        roster_init(&scene->roster, 2 * team_size) != 0 ||
+        violations_init(&scene->violations, team_size) != 0 ||
+        perception_init(&scene->perception, team_size, &scene->field) != 0) {
+        destroy_scene(scene);
+        return -1;
+    }
 
-    // create players
-    for (int i = 0; i < PLAYER_COUNT; i++) {
-        scene->first_team->players[i] = make_player_ptr((float)(50 + i * 50), 300, 1, i);
-        scene->second_team->players[i] = make_player_ptr((float)(700 - i * 40), 300, 2, i);
+    // create players: all of them live contiguously in the roster
+    struct Player* views = scene->roster.views;
+    for (int i = 0; i < team_size; i++) {
+        // Player has const members, so build on the stack and copy the bytes in.
+        struct Player p1 = make_coached_player(scene_coach(scene, 1), (float)(50 + i * 50), 300, 1, i);
+        struct Player p2 = make_coached_player(scene_coach(scene, 2), (float)(700 - i * 40), 300, 2, i);
+        memcpy(&views[i], &p1, sizeof(struct Player));
+        memcpy(&views[team_size + i], &p2, sizeof(struct Player));
+        scene->first_team->players[i] = &views[i];
+        scene->second_team->players[i] = &views[team_size + i];
     }
+    for (int i = 0; i < 2 * team_size; i++)
+        verify_talents(&views[i], scene);
 
     // initialize ball
-    scene->ball->position.x = CENTER_X + (rand() % 2) * 2 - 1;  // gives -1 or +1, randomly selecting starter team
-    scene->ball->position.y = CENTER_Y;
+    scene->ball->position.x = scene->field.center_x + (int)rng_range(&scene->rng, 2) * 2 - 1;  // gives -1 or +1, randomly selecting starter team
+    scene->ball->position.y = scene->field.center_y;
     set_piece_goal(scene);
     scene->state = STATE_RESTARTING;
+    return 0;
+}
+
+const struct CoachApi* scene_coach(const struct Scene *scene, int team) {
+    const struct CoachApi* coach = scene->coaches[team - 1];
+    return coach ? coach : coach_builtin();
+}
+
+void scene_rebind_coach(struct Scene *scene, int team, const struct CoachApi* coach) {
+    scene->coaches[team - 1] = coach;
+    coach = scene_coach(scene, team);
+    struct Team* side = (team == 1) ? scene->first_team : scene->second_team;
+    for (int i = 0; i < side->size; i++) {
+        struct Player* p = side->players[i];
+        p->movement_logic = coach->movement_logic(team, p->kit);
+        p->shooting_logic = coach->shooting_logic(team, p->kit);
+        p->change_state_logic = coach->change_state_logic(team, p->kit);
+    }
+}
+
+/**
+ * @brief Releases the teams, player roster and per-player tables created by init_scene().
+ * @param scene Pointer to the Scene to tear down.
+ */
+void destroy_scene(struct Scene *scene) {
+    free(scene->first_team);
+    free(scene->second_team);
+    roster_free(&scene->roster);
+    perception_free(&scene->perception);
+    violations_free(&scene->violations);
+    if (scene->rollout) {
+        rollout_free(scene->rollout);
+        free(scene->rollout);
+        scene->rollout = NULL;
+    }
+    scene->first_team = NULL;
+    scene->second_team = NULL;
 }
 
 /**
- * @brief Updates the states of both teams in the scene.
+ * @brief Runs both coaches and resolves possession (no movement yet).
  * @param scene Pointer to the Scene to update.
  */
-void update_and_verify_scene_states(struct Scene *scene, const float dt) {
+void think_scene(struct Scene *scene) {
+    perception_invalidate(&scene->perception);   // positions moved since the last tick
+    if (scene->rollout)
+        rollout_set_budget(scene->rollout, ROLLOUT_TICK_BUDGET);
     update_team(scene, scene->first_team);
     update_team(scene, scene->second_team);
+
+    // the coaches wrote velocities and states into the views; pull them into the arrays
+    roster_gather(&scene->roster);
     update_ball_possessor(scene);
-    
-    for (int i = 0; i < PLAYER_COUNT; i++) {
-        struct Player* p1 = scene->first_team->players[i];
-        struct Player* p2 = scene->second_team->players[i];
-
-        // move players
-        p1->position.x += p1->velocity.x * dt;
-        p1->position.y += p1->velocity.y * dt;
-        p2->position.x += p2->velocity.x * dt;
-        p2->position.y += p2->velocity.y * dt;
-        // make sure no one walks off the pitch
-        if (p1->position.x < p1->radius) p1->position.x = p1->radius;
-        if (p1->position.x > SCREEN_WIDTH - p1->radius) p1->position.x = SCREEN_WIDTH - p1->radius;
-        if (p1->position.y < p1->radius) p1->position.y = p1->radius;
-        if (p1->position.y > SCREEN_HEIGHT - p1->radius) p1->position.y = SCREEN_HEIGHT - p1->radius;
-        if (p2->position.x < p2->radius) p2->position.x = p2->radius;
-        if (p2->position.x > SCREEN_WIDTH - p2->radius) p2->position.x = SCREEN_WIDTH - p2->radius;
-        if (p2->position.y < p2->radius) p2->position.y = p2->radius;
-        if (p2->position.y > SCREEN_HEIGHT - p2->radius) p2->position.y = SCREEN_HEIGHT - p2->radius;
-    }
 
     struct Ball* ball = scene->ball;
     if (ball->possessor != NULL)
         ball->last_team = ball->possessor->team;
-    ball->position.x += ball->velocity.x * dt;
-    ball->position.y += ball->velocity.y * dt;
-    ball->velocity.x *= FRICTION;
-    ball->velocity.y *= FRICTION;
-    // finally the ball stops
-    if (hypotf(ball->velocity.x, ball->velocity.y) < 10.0f) {
-        ball->velocity.x = 0;
-        ball->velocity.y = 0;
+}
+
+/**
+ * @brief Integrates players and ball by dt, applying pitch limits, friction and bounces.
+ *
+ * A free ball rolls as trajectory.h models it (ball_roll()), so it covers
+ * the same ground and stops at the same point whatever the tick rate; a
+ * carried ball moves at its velocity, which its possessor sets, like them.
+ * It goes in a straight line for the whole tick. The first player it runs
+ * into on the way, by time of impact, that it was not already touching
+ * (first_ball_contact()) is remembered in Scene::ball_contact, with the time
+ * in Scene::ball_contact_time, unless the ball went fully off the pitch
+ * before reaching them. The next think counts that player as touching the
+ * ball, so whether to take it is up to the coach (a tackle hands it over),
+ * as it is when the timestep is small enough to see the overlap; until then
+ * the ball keeps its own path. The referee sweeps that path for goals and
+ * outs, so at big timesteps the ball can neither skip over a player nor
+ * over a goal mouth.
+ * @param scene Pointer to the Scene to update.
+ */
+void move_scene(struct Scene *scene, const float dt) {
+    PROFILE_BEGIN(PROFILE_INTEGRATE);
+    struct Roster* roster = &scene->roster;
+    const Field* field = &scene->field;
+    struct Ball* ball = scene->ball;
+
+    // where the ball would get to on its own
+    struct Vec2 velocity = ball->velocity;
+    const float decay = ball_decay(dt);
+    const float travel = ball->possessor ? dt : ball_roll(&velocity, decay, ball_travel(decay));
+    const struct Vec2 shift = { ball->velocity.x * travel, ball->velocity.y * travel };
+
+    // time of impact, from where everyone stands before moving
+    float impact = INFINITY;
+    const int hit = ball->possessor ? -1 : first_ball_contact(scene, dt, shift, &impact);
+
+    // move players and make sure no one walks off the pitch
+    roster_integrate(roster, dt);
+    roster_clamp(roster, field->width, field->height);
+    if (scene->body_collisions) {
+        PROFILE_BEGIN(PROFILE_BODIES);
+        roster_collide(roster, field->width, field->height);
+        PROFILE_END(PROFILE_BODIES);
+    }
+    roster_scatter_positions(roster);
+
+    float x = ball->position.x + shift.x;
+    float y = ball->position.y + shift.y;
+    scene->ball_from = ball->position;
+    scene->ball_contact = -1;
+    scene->ball_contact_time = 0.0f;
+    if (hit >= 0) {
+        int scored;
+        bool is_out;
+        const float off = referee_sweep(field, ball->position.x, ball->position.y, x, y, &scored, &is_out);
+        if (impact < off * dt) {
+            // met before it could leave the pitch
+            scene->ball_contact = hit;
+            scene->ball_contact_time = impact;
+        }
     }
+    scene->ball_to.x = x;
+    scene->ball_to.y = y;
+    ball->position.x = x;
+    ball->position.y = y;
+    ball->velocity = velocity;
     // ball bounces off the window edges 
     if (ball->position.x - ball->radius < 0) {
         ball->position.x = ball->radius;
         ball->velocity.x = -ball->velocity.x;
     }
-    if (ball->position.x + ball->radius > SCREEN_WIDTH) {
-        ball->position.x = SCREEN_WIDTH - ball->radius;
+    if (ball->position.x + ball->radius > field->width) {
+        ball->position.x = field->width - ball->radius;
         ball->velocity.x = -ball->velocity.x;
     }
     if (ball->position.y - ball->radius < 0) {
         ball->position.y = ball->radius;
         ball->velocity.y = -ball->velocity.y;
     }
-    if (ball->position.y + ball->radius > SCREEN_HEIGHT) {
-        ball->position.y = SCREEN_HEIGHT - ball->radius;
+    if (ball->position.y + ball->radius > field->height) {
+        ball->position.y = field->height - ball->radius;
         ball->velocity.y = -ball->velocity.y;
     }
+    PROFILE_END(PROFILE_INTEGRATE);
+}
+
+/**
+ * @brief Updates the states of both teams in the scene, then moves everything.
+ * @param scene Pointer to the Scene to update.
+ */
+void update_and_verify_scene_states(struct Scene *scene, const float dt) {
+    think_scene(scene);
+    move_scene(scene, dt);
 }
 
 /**
  * @brief Stops ball and players movements.
  */
 void stop_movements(struct Scene* scene) {
+    // whoever the ball last ran into has been placed elsewhere
+    scene->ball_contact = -1;
+    scene->ball_contact_time = 0.0f;
+
     // Stop the ball
     scene->ball->velocity.x = 0.0f;
     scene->ball->velocity.y = 0.0f;
 
     // Stop all players from both teams
-    for (int i = 0; i < PLAYER_COUNT; i++) {
+    for (int i = 0; i < scene->team_size; i++) {
         if (scene->first_team->players[i]) {
             scene->first_team->players[i]->velocity.x = 0.0f;
             scene->first_team->players[i]->velocity.y = 0.0f;
@@ -122,8 +252,7 @@ void set_piece_out(struct Scene* scene) {
 
     struct Ball* ball = scene->ball;
     if (ball->last_team == 0) {
-        printf("it's not clear which team throw the ball out!\n");
-        printf("let's assume it was the first team.\n");
+        LOG(LOG_WARN, LOG_ENGINE, "it's not clear which team throw the ball out! let's assume it was the first team.");
         ball->last_team = 1;
     }
     int last_team = ball->last_team;
@@ -132,10 +261,12 @@ void set_piece_out(struct Scene* scene) {
     float x = ball->position.x;
     float y = ball->position.y;
 
-    float left_line   = PITCH_X;
-    float right_line  = (PITCH_X + PITCH_W);
-    float top_line    = PITCH_Y;
-    float bottom_line = (PITCH_Y + PITCH_H);
+    const Field* field = &scene->field;
+    float left_line   = field->pitch_x;
+    float right_line  = (field->pitch_x + field->pitch_w);
+    float top_line    = field->pitch_y;
+    float bottom_line = (field->pitch_y + field->pitch_h);
+    float center_y    = field->center_y;
 
     bool past_left   = (x + BALL_RADIUS < left_line);
     bool past_right  = (x - BALL_RADIUS > right_line);
@@ -143,22 +274,22 @@ void set_piece_out(struct Scene* scene) {
     bool past_bottom = (y - BALL_RADIUS > bottom_line);
     if (past_left) {
         if (last_team == 2) { // goal kick
-            ball->position.y = CENTER_Y;
+            ball->position.y = center_y;
             ball->position.x = left_line + PITCH_MARGIN;
         } else { // corner
             ball->position.x = left_line;
-            if (y > CENTER_Y) // put the ball at the higher corner
+            if (y > center_y) // put the ball at the higher corner
                 ball->position.y = bottom_line;
             else // put the ball at the lower corner
                 ball->position.y = top_line;
         }
     } else if (past_right) { // similar to past_left
         if (last_team == 1) {
-            ball->position.y = CENTER_Y;
+            ball->position.y = center_y;
             ball->position.x = right_line - PITCH_MARGIN;
         } else {
             ball->position.x = right_line;
-            if (y > CENTER_Y)
+            if (y > center_y)
                 ball->position.y = bottom_line;
             else
                 ball->position.y = top_line;
@@ -170,32 +301,13 @@ void set_piece_out(struct Scene* scene) {
     }
 
     // Find the closest player to the ball to take the throw-in/kick-in
-    struct Player* kicker = NULL;
-    float min_dist = 999999.0f;
-    struct Player* p = NULL;
-    if (last_team == 2) {
-        for(int i=0; i < PLAYER_COUNT; i++) {
-            p = scene->first_team->players[i];
-            float d = hypotf(p->position.x - ball->position.x, p->position.y - ball->position.y);
-            if (d < min_dist) { min_dist = d; kicker = p; }
-        }
-    } else {
-        for(int i=0; i < PLAYER_COUNT; i++) {
-            p = scene->second_team->players[i];
-            float d = hypotf(p->position.x - ball->position.x, p->position.y - ball->position.y);
-            if (d < min_dist) { min_dist = d; kicker = p; }
-        }
-    }
-
-    if (!kicker) {
-        printf("couln't select a player throw-in the ball!\n");
-        return;
-    }
+    perception_invalidate(&scene->perception);   // the ball was just placed
+    struct Player* kicker = perception_nearest_to_ball(scene, last_team == 2 ? 1 : 2);
     ball->possessor = kicker;
     ball->last_team = kicker->team;
     // Position the player slightly "behind" the ball relative to the pitch center
-    float dir_x = (CENTER_X) - ball->position.x;
-    float dir_y = (CENTER_Y) - ball->position.y;
+    float dir_x = (field->center_x) - ball->position.x;
+    float dir_y = (center_y) - ball->position.y;
     float length = hypotf(dir_x, dir_y);
     
     // Normalize and push player 30 units away from center, behind the ball
@@ -204,10 +316,19 @@ void set_piece_out(struct Scene* scene) {
 
     ball->position.x += (dir_x / length) * 5.0f;
     ball->position.y += (dir_y / length) * 5.0f;
+    perception_invalidate(&scene->perception);   // the kicker and the ball were just placed
 
     return;
 }
 
+/**
+ * @brief Where the coach puts `p` at kick-off. Coaches place players on the
+ * default pitch; the position is scaled onto this scene's.
+ */
+static Vec2 kickoff_position(const Scene* scene, const struct Player* p) {
+    return field_from_default(&scene->field, scene_coach(scene, p->team)->positions(p->team, p->kit));
+}
+
 /**
  * @brief Resets ball and players to kickoff positions after a goal.
  */
@@ -216,19 +337,20 @@ void set_piece_goal(struct Scene* scene) {
     stop_movements(scene);
 
     struct Ball* ball = scene->ball;
+    const Field* field = &scene->field;
     // Identify who kicks off
-    struct Team* kickoff_team = (ball->position.x < CENTER_X) ? scene->first_team : scene->second_team;
-    struct Team* waiting_team = (ball->position.x > CENTER_X) ? scene->first_team : scene->second_team;
+    struct Team* kickoff_team = (ball->position.x < field->center_x) ? scene->first_team : scene->second_team;
+    struct Team* waiting_team = (ball->position.x > field->center_x) ? scene->first_team : scene->second_team;
 
-    ball->position.x = (float)CENTER_X;
-    ball->position.y = (float)CENTER_Y;
+    ball->position.x = field->center_x;
+    ball->position.y = field->center_y;
     ball->possessor = NULL;
 
     const float circle_radius = 90.0f;
     const float padding = 20.0f; // Extra space to ensure they are outside the line
 
     // Position Kickoff Team
-    for (int i = 0; i < PLAYER_COUNT; i++) {
+    for (int i = 0; i < kickoff_team->size; i++) {
         struct Player* p = kickoff_team->players[i];
         if (!p) continue;
 
@@ -236,27 +358,129 @@ void set_piece_goal(struct Scene* scene) {
             // The designated kicker: Place them just behind the ball
             // Direction depends on which side they are attacking
             float side_multiplier = (kickoff_team == scene->first_team) ? 1.0f : -1.0f;
-            p->position.x = (float)CENTER_X + (side_multiplier * 15.0f);
-            p->position.y = (float)CENTER_Y;
+            p->position.x = field->center_x + (side_multiplier * 15.0f);
+            p->position.y = field->center_y;
             ball->possessor = p;
             ball->last_team = p->team;
         } else {
             // Others stay on their half, outside the center circle
-            Vec2 position = get_positions(p->team, p->kit);
+            Vec2 position = kickoff_position(scene, p);
             p->position.x = position.x;
             p->position.y = position.y;
         }
     }
 
     // Position Waiting Team
-    for (int i = 0; i < PLAYER_COUNT; i++) {
+    for (int i = 0; i < waiting_team->size; i++) {
         struct Player* p = waiting_team->players[i];
         if (!p) continue;
 
-        Vec2 position = get_positions(p->team, p->kit);
+        Vec2 position = kickoff_position(scene, p);
         p->position.x = position.x;
         p->position.y = position.y;
     }
+    perception_invalidate(&scene->perception);   // everyone was just placed
+
+    LOG(LOG_INFO, LOG_MATCH, "Team %d is about to kick-off", (kickoff_team == scene->first_team ? 1 : 2));
+}
+
+/**
+ * @brief Phase 1 of update_scene(): timers, set pieces and the match clock.
+ * @return true if the match is running and physics should be stepped this tick.
+ */
+bool advance_scene_clock(Scene* scene, const float dt) {
+    // --- State: RESTARTING (The short Delay before calling player to kick-off) ---
+    if (scene->state == STATE_RESTARTING) {
+        scene->wait_time -= dt;
+        if (scene->wait_time <= 0) {
+            scene->state = STATE_RUNNING;
+            LOG(LOG_INFO, LOG_MATCH, "the player should now kick-off / throw-in ...");
+            struct Ball* ball = scene->ball;
+            struct Player* player = ball->possessor;
+            player->shooting_logic(player, scene);
+            verify_shoot(ball, true, scene);
+            scene->ball->possessor = NULL;
+        }
+        return false; // Don't process physics yet
+    }
+
+    // --- State: OUT ---
+    if (scene->state == STATE_OUT) {
+        scene->wait_time -= dt;
+        if (scene->wait_time < 0) {
+            scene->wait_time = 2.0f;    // wait 2 more seconds before calling the player to throw in
+            set_piece_out(scene);       // Position players/ball
+            scene->state = STATE_RESTARTING;
+        }
+        return false;
+    }
+
+    // --- State: GOAL ---
+    if (scene->state == STATE_GOAL) {
+        scene->wait_time -= dt;
+        if (scene->wait_time < 0) {
+            scene->wait_time = 2.0f;    // wait 2 more seconds before calling the player to kick off
+            set_piece_goal(scene);      // Position players/ball
+            scene->state = STATE_RESTARTING;
+        }
+        return false;
+    }
+
+    if (scene->state != STATE_RUNNING) return false; // scene->state == STATE_TIMEOUT
+    scene->remaining_time -= dt;
+    // --- State: TIMEOUT ---
+    if (scene->remaining_time < 0.0f) {
+        LOG(LOG_INFO, LOG_MATCH, "Game Time has ended ...");
+        scene->state = STATE_TIMEOUT;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Phase 3 of update_scene(): switches the match state on a referee call.
+ * @param call A RefereeCode returned by referee().
+ */
+void apply_referee_call(Scene* scene, const int call) {
+    switch (call) {
+        case GOAL:
+            scene->state = STATE_GOAL;
+            scene->wait_time = 5.0f; // 5 second delay before kick-off
+            LOG(LOG_INFO, LOG_MATCH, "Goal scored! first team score: %u, second team score: %u",
+                scene->first_team->score, scene->second_team->score);
+            break;
+        case OUT:
+            scene->state = STATE_OUT;
+            scene->wait_time = 2.0f; // 2 second delay before set-piece
+            LOG(LOG_INFO, LOG_MATCH, "Ball out of bounds!");
+            break;
+        default:
+            break;  // no event, game continues
+    }
+}
+
+/**
+ * @brief Main logic dispatcher.
+ * * This function orchestrates the three phases of a frame:
+ * 1. Time Management (Is the game over?)
+ * 2. Scene Update (Physics & Movement)
+ * 3. Referee Check (Rules & Fouls)
+ */
+void update_scene(Scene* scene, const float dt) {
+    int call = PLAY_ON;
+
+    // ----------------------------- PHASE 1: state controll -----------------------------
+    if (advance_scene_clock(scene, dt)) {
+        // ----------------------------- PHASE 2: update the scene -----------------------------
+        update_and_verify_scene_states(scene, dt);
+
+        // ----------------------------- PHASE 3: call the referee -----------------------------
+        // after screen update, call the referee to check all the rules
+        call = referee(scene);
+        apply_referee_call(scene, call);
+    }
 
-    printf("Team %d is about to kick-off\n", (kickoff_team == scene->first_team ? 1 : 2));
+    // every tick is recorded, including the paused ones between set pieces
+    if (scene->recorder)
+        recorder_tick(scene->recorder, scene, call);
 }
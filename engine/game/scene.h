@@ -9,6 +9,15 @@
 #define ENGINE_GRAPHICS_SCENE_H
 
 #include "entities/field.h"
+#include <stdbool.h>
+#include "core/rng.h"
+#include "game/roster.h"
+#include "game/perception.h"
+#include "logic/violations.h"
+
+struct Recorder;
+struct CoachApi;
+struct Rollout;
 
 /**
  * @enum GameState
@@ -26,15 +35,74 @@ typedef struct Scene {
     struct Team* first_team;
     struct Team* second_team;
     struct Ball* ball;
-    Field field;
+    Field field;            /**< Pitch geometry; set before init_scene(), which fills in field_default() if it is zero. */
+    int team_size;          /**< Players per side; set before init_scene(), which uses DEFAULT_TEAM_SIZE if it is 0. */
+    bool body_collisions;   /**< Push overlapping players apart (roster_collide()); when off, they pass through each other. */
     GameState state;
     float wait_time;        /**< Secondary timer for "celebration" or "reset" delays. */
     float remaining_time;   /**< The main match countdown. */
+    struct Vec2 ball_from;  /**< Where the ball's straight path of the last move_scene() began... */
+    struct Vec2 ball_to;    /**< ...and ended, before any wall bounce; referee() sweeps it. */
+    int ball_contact;       /**< Roster index of the player the free ball ran into during that move, or -1... */
+    float ball_contact_time; /**< ...and the seconds into the move it did (0 without a contact). */
+    struct Rng rng;         /**< The match's own random stream; seed it with rng_seed() before init_scene(). */
+    struct Roster roster;   /**< SoA storage of every player; the teams point into roster.views. */
+    struct Recorder* recorder; /**< Optional; when set, every update_scene() tick is appended to it. */
+    struct Violations violations; /**< Referee corrections per player and rule, since init_scene(). */
+    struct Perception perception; /**< This tick's shared coach geometry; query it through perception.h. */
+    const struct CoachApi* coaches[2]; /**< Coach of team 1 and team 2; NULL plays the built-in one. Set before init_scene(). */
+    struct Rollout* rollout; /**< Lookahead scratch scene for the coaches, built on first scene_rollout(); NULL until then. */
 } Scene;
 
-void init_scene(Scene* scene);
+/**
+ * @brief Builds the teams, roster and per-player tables for `scene->team_size`
+ * players a side on `scene->field`, and sets up the first kick-off.
+ * @return 0 on success, -1 if `scene->team_size` is above MAX_TEAM_SIZE or an
+ * allocation failed (nothing is left allocated; do not destroy_scene() it).
+ */
+int init_scene(Scene* scene);
+
+/**
+ * @brief Frees the teams, the player roster and the per-player tables allocated by init_scene(),
+ * and the scene's rollout if a coach asked for one.
+ * The ball is owned by the caller and is left untouched.
+ */
+void destroy_scene(Scene* scene);
 void update_and_verify_scene_states(Scene* scene, const float dt);
+
+/**
+ * @name Tick phases
+ * @brief The pieces update_scene() is made of, for drivers that interleave
+ * many scenes (e.g. the lockstep stepper). Calling them in this order is
+ * exactly one update_scene() tick:
+ * `if (advance_scene_clock()) { think_scene(); move_scene(); apply_referee_call(referee()); }`
+ */
+///@{
+bool advance_scene_clock(Scene* scene, float dt);
+void think_scene(Scene* scene);
+void move_scene(Scene* scene, float dt);
+void apply_referee_call(Scene* scene, int call);
+///@}
+/** @brief The coach of `team` (1 or 2): scene->coaches[team - 1], or the built-in coach. */
+const struct CoachApi* scene_coach(const Scene* scene, int team);
+
+/**
+ * @brief Switches `team` to `coach` mid-match: every player's logic functions
+ * are taken from it. Talents stay as they were at init_scene(); kick-off
+ * positions follow the new coach from the next kick-off.
+ */
+void scene_rebind_coach(Scene* scene, int team, const struct CoachApi* coach);
+
 void set_piece_out(Scene* scene);
 void set_piece_goal(Scene* scene);
 
+/**
+ * @brief The core "Update" function called by the Main Loop.
+ * * Lives in the game layer so it can be driven without a window: the SDL
+ * viewer and the headless simulator both call it once per tick.
+ * @param dt Delta Time: the time (in seconds) passed since the last frame. 
+ * This ensures the game runs at the same speed regardless of FPS.
+ */
+void update_scene(Scene* scene, float dt);
+
 #endif /* ENGINE_GRAPHICS_SCENE_H */
@@ -0,0 +1,56 @@
+#include "timestep.h"
+#include "entities/ball.h"
+#include "entities/team.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+void timestep_init(struct FixedTimestep* step, float tick_rate, int max_steps) {
+    step->tick_rate = tick_rate > 0.0f ? tick_rate : DEFAULT_TICK_RATE;
+    step->dt = 1.0f / step->tick_rate;
+    step->accumulator = 0.0f;
+    step->max_steps = max_steps > 0 ? max_steps : DEFAULT_MAX_CATCH_UP_STEPS;
+}
+
+int timestep_advance(struct FixedTimestep* step, float frame_time) {
+    if (frame_time > 0.0f)
+        step->accumulator += frame_time;
+
+    int steps = (int)(step->accumulator / step->dt);
+    if (steps > step->max_steps) {
+        // We are too far behind (debugger, window drag, slow machine): drop the backlog.
+        steps = step->max_steps;
+        step->accumulator = 0.0f;
+        return steps;
+    }
+    step->accumulator -= (float)steps * step->dt;
+    if (step->accumulator < 0.0f)
+        step->accumulator = 0.0f;
+    return steps;
+}
+
+float timestep_alpha(const struct FixedTimestep* step) {
+    float alpha = step->accumulator / step->dt;
+    return alpha < 1.0f ? alpha : 1.0f;
+}
+
+int scene_capture(const Scene* scene, struct SceneSnapshot* snapshot) {
+    const int count = scene->roster.count;
+    if (snapshot->count != count) {
+        struct Vec2* players = realloc(snapshot->players, sizeof(struct Vec2) * (size_t)count);
+        if (!players)
+            return -1;
+        snapshot->players = players;
+        snapshot->count = count;
+    }
+    for (int i = 0; i < count; i++)
+        snapshot->players[i] = scene->roster.views[i].position;
+    snapshot->ball = scene->ball->position;
+    snapshot->state = scene->state;
+    return 0;
+}
+
+void scene_snapshot_free(struct SceneSnapshot* snapshot) {
+    free(snapshot->players);
+    memset(snapshot, 0, sizeof(*snapshot));
+}
@@ -0,0 +1,68 @@
+/**
+ * @file timestep.h
+ * @brief Fixed-timestep accumulator and render interpolation helpers.
+ * * The simulation always advances in steps of exactly 1 / tick_rate seconds,
+ * no matter how fast frames are drawn. Wall-clock frame time is banked in an
+ * accumulator and spent one tick at a time; whatever is left over becomes the
+ * interpolation factor the renderer uses to blend the last two physics states.
+ */
+
+#ifndef ENGINE_GAME_TIMESTEP_H
+#define ENGINE_GAME_TIMESTEP_H
+
+#include "core/vec2.h"
+#include "core/constants.h"
+#include "game/scene.h"
+
+/** @brief Default simulation rate, in ticks per game second. */
+#define DEFAULT_TICK_RATE 60.0f
+
+/** @brief Default cap on simulation steps run for a single rendered frame. */
+#define DEFAULT_MAX_CATCH_UP_STEPS 8
+
+/**
+ * @struct FixedTimestep
+ * @brief Accumulates frame time and hands it out as whole simulation ticks.
+ */
+struct FixedTimestep {
+    float tick_rate;    /**< Ticks per game second (e.g. 60, 120, 240). */
+    float dt;           /**< Length of one tick in seconds (1 / tick_rate). */
+    float accumulator;  /**< Frame time not yet simulated. */
+    int max_steps;      /**< Most ticks run per frame; the rest is dropped to avoid a spiral of death. */
+};
+
+/**
+ * @struct SceneSnapshot
+ * @brief Positions captured before a tick so the renderer can interpolate.
+ * Zero-initialize it before the first scene_capture(); free it with scene_snapshot_free().
+ */
+struct SceneSnapshot {
+    struct Vec2* players;   /**< Indexed like the roster: first team, then second team. */
+    int count;
+    struct Vec2 ball;
+    GameState state;    /**< A state change (e.g. a set piece) means "teleport, don't blend". */
+};
+
+void timestep_init(struct FixedTimestep* step, float tick_rate, int max_steps);
+
+/**
+ * @brief Banks `frame_time` seconds and returns how many ticks to simulate now.
+ */
+int timestep_advance(struct FixedTimestep* step, float frame_time);
+
+/**
+ * @brief Fraction of a tick left in the accumulator, in [0, 1).
+ * Use it to blend the previous snapshot (0) towards the current scene (1).
+ */
+float timestep_alpha(const struct FixedTimestep* step);
+
+/**
+ * @brief Copies every entity position of `scene` into `snapshot`, growing it to the roster size.
+ * @return 0 on success, -1 if the player array could not be allocated.
+ */
+int scene_capture(const Scene* scene, struct SceneSnapshot* snapshot);
+
+/** @brief Frees the player array of `snapshot` and zeroes it. */
+void scene_snapshot_free(struct SceneSnapshot* snapshot);
+
+#endif /* ENGINE_GAME_TIMESTEP_H */
@@ -0,0 +1,411 @@
+#define _POSIX_C_SOURCE 200112L // clock_gettime, posix_memalign
+#include "tournament.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+struct TournamentMatch* tournament_round_robin(int entries, int seeds, int* count) {
+    const int pairings = entries * (entries - 1) / 2;
+    struct TournamentMatch* matches = calloc((size_t)(pairings > 0 ? pairings : 1) * 2 * (size_t)seeds,
+                                             sizeof(*matches));
+    if (!matches)
+        return NULL;
+
+    int n = 0;
+    for (int a = 0; a < entries; a++) {
+        for (int b = a + 1; b < entries; b++) {
+            for (int s = 0; s < seeds; s++) {
+                matches[n++] = (struct TournamentMatch){ .round = 1, .home = a, .away = b, .seed_index = s };
+                matches[n++] = (struct TournamentMatch){ .round = 1, .home = b, .away = a, .seed_index = s };
+            }
+        }
+    }
+    *count = n;
+    return matches;
+}
+
+static void credit(struct Standing* line, unsigned int scored, unsigned int conceded) {
+    line->played++;
+    line->goals_for += (int)scored;
+    line->goals_against += (int)conceded;
+    if (scored > conceded) {
+        line->won++;
+        line->points += TOURNAMENT_WIN_POINTS;
+    } else if (scored == conceded) {
+        line->drawn++;
+        line->points += TOURNAMENT_DRAW_POINTS;
+    } else {
+        line->lost++;
+    }
+}
+
+static int compare_standings(const void* a, const void* b) {
+    const struct Standing* x = a;
+    const struct Standing* y = b;
+    if (x->points != y->points)
+        return y->points - x->points;
+    const int dx = x->goals_for - x->goals_against, dy = y->goals_for - y->goals_against;
+    if (dx != dy)
+        return dy - dx;
+    if (x->goals_for != y->goals_for)
+        return y->goals_for - x->goals_for;
+    return x->entry - y->entry;
+}
+
+void tournament_standings(const struct TournamentMatch* matches, int count, int entries,
+                          const int* byes, struct Standing* table) {
+    memset(table, 0, sizeof(*table) * (size_t)entries);
+    for (int e = 0; e < entries; e++) {
+        table[e].entry = e;
+        table[e].byes = byes ? byes[e] : 0;
+        table[e].points = table[e].byes * TOURNAMENT_WIN_POINTS;
+    }
+    for (int i = 0; i < count; i++) {
+        const struct TournamentMatch* m = &matches[i];
+        if (!m->done)
+            continue;
+        credit(&table[m->home], m->home_score, m->away_score);
+        credit(&table[m->away], m->away_score, m->home_score);
+    }
+    qsort(table, (size_t)entries, sizeof(*table), compare_standings);
+}
+
+/** @brief Search steps tournament_swiss_round() spends looking for a round without rematches. */
+#define SWISS_SEARCH_STEPS 1000000L
+
+/**
+ * @brief Pairs the unpaired entries of `table` so that nobody meets an
+ * opponent again, by backtracking: the best-placed entry left takes the
+ * best-placed opponent it has not met whose pairing lets the rest be paired.
+ * @param met    entries x entries, whether two entries have played.
+ * @param pairs  Receives the pairs as entry indices, two per pair, from `n`.
+ * @param steps  Search steps left; the search gives up when they run out.
+ * @return Whether every entry left was paired.
+ */
+static bool pair_fresh(const struct Standing* table, int entries, const bool* met, bool* paired,
+                       int* pairs, int n, long* steps) {
+    int i = 0;
+    while (i < entries && paired[table[i].entry])
+        i++;
+    if (i == entries)
+        return true;
+    const int a = table[i].entry;
+    paired[a] = true;
+    for (int j = i + 1; j < entries; j++) {
+        const int b = table[j].entry;
+        if (paired[b] || met[a * entries + b])
+            continue;
+        if (--*steps < 0)
+            break;
+        paired[b] = true;
+        pairs[n] = a;
+        pairs[n + 1] = b;
+        if (pair_fresh(table, entries, met, paired, pairs, n + 2, steps))
+            return true;
+        paired[b] = false;
+    }
+    paired[a] = false;
+    return false;
+}
+
+struct TournamentMatch* tournament_swiss_round(const struct TournamentMatch* played, int played_count,
+                                               int entries, int seeds, int round, int* byes,
+                                               int* bye, int* count) {
+    struct Standing* table = malloc(sizeof(*table) * (size_t)entries);
+    bool* paired = calloc((size_t)entries, sizeof(*paired));
+    bool* met = calloc((size_t)entries * (size_t)entries, sizeof(*met));
+    int* pairs = malloc(sizeof(*pairs) * (size_t)(entries > 0 ? entries : 1));
+    struct TournamentMatch* matches = calloc((size_t)(entries / 2 > 0 ? entries / 2 : 1) * 2 * (size_t)seeds,
+                                             sizeof(*matches));
+    if (!table || !paired || !met || !pairs || !matches) {
+        free(table);
+        free(paired);
+        free(met);
+        free(pairs);
+        free(matches);
+        return NULL;
+    }
+    tournament_standings(played, played_count, entries, byes, table);
+    for (int i = 0; i < played_count; i++) {
+        met[played[i].home * entries + played[i].away] = true;
+        met[played[i].away * entries + played[i].home] = true;
+    }
+
+    *bye = -1;
+    if (entries % 2) {
+        // from the bottom of the table, the first entry with the fewest byes sits out
+        int chosen = entries - 1;
+        for (int i = entries - 1; i >= 0; i--)
+            if (byes[table[i].entry] < byes[table[chosen].entry])
+                chosen = i;
+        *bye = table[chosen].entry;
+        paired[*bye] = true;
+        byes[*bye]++;
+    }
+
+    const int pair_count = entries / 2;
+    long steps = SWISS_SEARCH_STEPS;
+    if (!pair_fresh(table, entries, met, paired, pairs, 0, &steps)) {
+        // no round without a rematch (or none found in time): pair down the
+        // table with the best-placed opponent not met yet, else the next one
+        for (int i = 0; i < entries; i++)
+            paired[table[i].entry] = table[i].entry == *bye;
+        int n = 0;
+        for (int i = 0; i < entries; i++) {
+            const int a = table[i].entry;
+            if (paired[a])
+                continue;
+            int opponent = -1;
+            for (int j = i + 1; j < entries; j++) {
+                const int b = table[j].entry;
+                if (paired[b])
+                    continue;
+                if (opponent < 0)
+                    opponent = b;
+                if (!met[a * entries + b]) {
+                    opponent = b;
+                    break;
+                }
+            }
+            if (opponent < 0)
+                break;
+            paired[a] = paired[opponent] = true;
+            pairs[n++] = a;
+            pairs[n++] = opponent;
+        }
+    }
+
+    int n = 0;
+    for (int k = 0; k < pair_count; k++) {
+        const int a = pairs[2 * k], b = pairs[2 * k + 1];
+        for (int s = 0; s < seeds; s++) {
+            matches[n++] = (struct TournamentMatch){ .round = round, .home = a, .away = b, .seed_index = s };
+            matches[n++] = (struct TournamentMatch){ .round = round, .home = b, .away = a, .seed_index = s };
+        }
+    }
+
+    free(table);
+    free(paired);
+    free(met);
+    free(pairs);
+    *count = n;
+    return matches;
+}
+
+/* -------------------------------------------------------------------------
+ * Work-stealing pool
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @struct PoolQueue
+ * @brief One worker's share of the matches, largest first.
+ * The owner takes from the head, thieves from the tail; both under `lock`.
+ */
+struct PoolQueue {
+    int* jobs;              /**< Match indices. */
+    int head;
+    int tail;               /**< One past the last job. */
+    pthread_mutex_t lock;
+    pthread_t thread;
+    int cpu;                /**< CPU to pin to, or -1. */
+    int index;
+    struct Pool* pool;
+};
+
+struct Pool {
+    struct TournamentMatch* matches;
+    const struct TournamentConfig* config;
+    struct PoolQueue* queues;   /**< Cache-line strided, see queue_at(). */
+    size_t stride;
+    int workers;
+    TournamentDoneFn done;
+    void* context;
+    pthread_mutex_t done_lock;  /**< Serializes `done` and guards `failed`. */
+    int failed;
+};
+
+static struct PoolQueue* queue_at(const struct Pool* pool, int i) {
+    return (struct PoolQueue*)((char*)pool->queues + pool->stride * (size_t)i);
+}
+
+static int take_own(struct PoolQueue* queue) {
+    int job = -1;
+    pthread_mutex_lock(&queue->lock);
+    if (queue->head < queue->tail)
+        job = queue->jobs[queue->head++];
+    pthread_mutex_unlock(&queue->lock);
+    return job;
+}
+
+static int steal(struct Pool* pool, int thief) {
+    for (int k = 1; k < pool->workers; k++) {
+        struct PoolQueue* victim = queue_at(pool, (thief + k) % pool->workers);
+        int job = -1;
+        pthread_mutex_lock(&victim->lock);
+        if (victim->head < victim->tail)
+            job = victim->jobs[--victim->tail];
+        pthread_mutex_unlock(&victim->lock);
+        if (job >= 0)
+            return job;
+    }
+    return -1;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void* pool_worker(void* arg) {
+    struct PoolQueue* queue = arg;
+    struct Pool* pool = queue->pool;
+    const struct TournamentConfig* config = pool->config;
+
+    if (queue->cpu >= 0)
+        batch_pin_current_thread(queue->cpu);
+
+    // nothing is queued after the start, so once every queue is empty the round is done
+    for (;;) {
+        int job = take_own(queue);
+        if (job < 0)
+            job = steal(pool, queue->index);
+        if (job < 0)
+            break;
+
+        struct TournamentMatch* match = &pool->matches[job];
+        struct MatchSpec spec = {
+            .seed = config->seed,
+            .stream = (uint64_t)match->seed_index,
+            .length = config->length,
+            .tick_rate = config->tick_rate,
+            .record_path = NULL,
+            .coaches = { config->coaches[match->home], config->coaches[match->away] },
+            .team_size = config->team_size,
+            .field = config->field
+        };
+        struct MatchResult result = { 0 };
+        const double start = now_seconds();
+        const int status = run_match(&spec, &result);
+        match->seconds = now_seconds() - start;
+
+        pthread_mutex_lock(&pool->done_lock);
+        if (status != 0) {
+            pool->failed = 1;
+        } else {
+            match->home_score = result.first_score;
+            match->away_score = result.second_score;
+            match->ticks = result.ticks;
+            match->done = true;
+            if (pool->done)
+                pool->done(match, pool->context);
+        }
+        pthread_mutex_unlock(&pool->done_lock);
+        match_result_free(&result);
+    }
+    return NULL;
+}
+
+/**
+ * @struct PendingMatch
+ * @brief A match still to play, keyed for the longest-first sort.
+ */
+struct PendingMatch {
+    double cost;
+    int index;              /**< Into the matches array. */
+};
+
+static int by_cost_descending(const void* a, const void* b) {
+    const struct PendingMatch* x = a;
+    const struct PendingMatch* y = b;
+    if (x->cost != y->cost)
+        return x->cost < y->cost ? 1 : -1;
+    return x->index - y->index;
+}
+
+int tournament_play(struct TournamentMatch* matches, int count, const struct TournamentConfig* config,
+                    int threads, bool pin, TournamentDoneFn done, void* context) {
+    int pending = 0;
+    struct PendingMatch* order = malloc(sizeof(*order) * (size_t)(count > 0 ? count : 1));
+    if (!order)
+        return -1;
+    for (int i = 0; i < count; i++)
+        if (!matches[i].done)
+            order[pending++] = (struct PendingMatch){ .cost = matches[i].cost, .index = i };
+    if (pending == 0) {
+        free(order);
+        return 0;
+    }
+
+    // longest first
+    qsort(order, (size_t)pending, sizeof(*order), by_cost_descending);
+
+    const int cpus = batch_cpu_count();
+    if (threads < 1)
+        threads = cpus;
+    if (threads > pending)
+        threads = pending;
+
+    struct Pool pool = {
+        .matches = matches,
+        .config = config,
+        .stride = (sizeof(struct PoolQueue) + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE,
+        .workers = threads,
+        .done = done,
+        .context = context,
+        .failed = 0
+    };
+    void* storage = NULL;
+    if (posix_memalign(&storage, CACHE_LINE_SIZE, pool.stride * (size_t)threads) != 0) {
+        free(order);
+        return -1;
+    }
+    memset(storage, 0, pool.stride * (size_t)threads);
+    pool.queues = storage;
+    pthread_mutex_init(&pool.done_lock, NULL);
+
+    // deal the sorted list round-robin, so every queue starts with its share of the long matches
+    int* slots = malloc(sizeof(int) * (size_t)pending);
+    if (!slots) {
+        pthread_mutex_destroy(&pool.done_lock);
+        free(storage);
+        free(order);
+        return -1;
+    }
+    int offset = 0;
+    for (int w = 0; w < threads; w++) {
+        struct PoolQueue* queue = queue_at(&pool, w);
+        queue->jobs = slots + offset;
+        for (int i = w; i < pending; i += threads)
+            queue->jobs[queue->tail++] = order[i].index;
+        offset += queue->tail;
+        queue->cpu = pin ? (w % cpus) : -1;
+        queue->index = w;
+        queue->pool = &pool;
+        pthread_mutex_init(&queue->lock, NULL);
+    }
+
+    int started = 0;
+    for (int w = 0; w < threads; w++) {
+        struct PoolQueue* queue = queue_at(&pool, w);
+        if (pthread_create(&queue->thread, NULL, pool_worker, queue) != 0)
+            break;
+        started++;
+    }
+    // queues of workers that failed to start are drained by stealing
+    for (int w = 0; w < started; w++)
+        pthread_join(queue_at(&pool, w)->thread, NULL);
+
+    for (int w = 0; w < threads; w++)
+        pthread_mutex_destroy(&queue_at(&pool, w)->lock);
+    pthread_mutex_destroy(&pool.done_lock);
+    free(slots);
+    free(storage);
+    free(order);
+
+    if (started == 0 || pool.failed)
+        return -1;
+    return 0;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file tournament.h
+ * @brief Round-robin and Swiss pairings between coaches, and a work-stealing pool to play them.
+ * * Every pairing is played from both sides and over several seeds: entry A
+ * as team 1 against B as team 2, then B as team 1 against A, each with match
+ * streams 0 .. seeds-1 of the tournament seed. Both sides of a pairing see
+ * the same stream, so neither gets luckier dice.
+ *
+ * The pool gives each worker its own queue, dealt longest match first, and
+ * an idle worker steals from the short end of another's queue, so one slow
+ * coach does not leave the other cores waiting at the end of a round.
+ */
+
+#ifndef ENGINE_GAME_TOURNAMENT_H
+#define ENGINE_GAME_TOURNAMENT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "game/batch.h"
+
+struct CoachApi;
+
+/** @brief Points for a win and a draw. */
+#define TOURNAMENT_WIN_POINTS 3
+#define TOURNAMENT_DRAW_POINTS 1
+
+/**
+ * @struct TournamentMatch
+ * @brief One scheduled match and, once played, its outcome.
+ */
+struct TournamentMatch {
+    int round;              /**< 1-based; a round robin plays everything in round 1. */
+    int home;               /**< Entry playing team 1 (kicks off left to right). */
+    int away;               /**< Entry playing team 2. */
+    int seed_index;         /**< Match stream within the tournament seed. */
+    double cost;            /**< Estimated seconds to play; the pool starts with the largest. */
+    bool done;
+    unsigned int home_score;
+    unsigned int away_score;
+    unsigned long ticks;
+    double seconds;         /**< Wall time it took. */
+};
+
+/**
+ * @struct TournamentConfig
+ * @brief What every match of a tournament shares.
+ */
+struct TournamentConfig {
+    uint64_t seed;
+    float length;           /**< Match length in game seconds. */
+    float tick_rate;
+    const struct CoachApi* const* coaches;  /**< Per entry; NULL entries play the built-in coach. */
+    int team_size;          /**< Players per side; 0 plays DEFAULT_TEAM_SIZE. */
+    Field field;            /**< Pitch; all zero plays field_default(). */
+};
+
+/**
+ * @struct Standing
+ * @brief One entry's line in the table.
+ */
+struct Standing {
+    int entry;
+    int played, won, drawn, lost;
+    int goals_for, goals_against;
+    int byes;               /**< Swiss rounds sat out; each is worth a win. */
+    int points;
+};
+
+/**
+ * @brief Every pairing of `entries` coaches from both sides over `seeds` streams.
+ * @return The matches (free() them) and their count in `count`, or NULL on allocation failure.
+ */
+struct TournamentMatch* tournament_round_robin(int entries, int seeds, int* count);
+
+/**
+ * @brief Ranks entries by points, then goal difference, goals scored and entry index.
+ * Only played (done) matches count. `byes` (may be NULL) holds each entry's byes.
+ * @param table Receives `entries` lines, best first.
+ */
+void tournament_standings(const struct TournamentMatch* matches, int count, int entries,
+                          const int* byes, struct Standing* table);
+
+/**
+ * @brief Pairs round `round` of a Swiss tournament from the results so far.
+ * Entries are paired down the table, each with the best-placed opponent
+ * that still lets everyone below be paired without a rematch (a backtracking
+ * search). Only when no such round exists is anyone paired again with an
+ * opponent they have met: then each takes the best-placed opponent not met
+ * yet, else the next one down. With an odd count the lowest-placed entry
+ * with the fewest byes sits out and gets a bye.
+ * The outcome depends only on `played`, so a resumed run pairs identically.
+ * @param byes  Per-entry bye counts; the bye handed out is added to it.
+ * @param bye   Receives the entry sitting out, or -1.
+ * @return The round's matches (free() them) and their count, or NULL on allocation failure.
+ */
+struct TournamentMatch* tournament_swiss_round(const struct TournamentMatch* played, int played_count,
+                                               int entries, int seeds, int round, int* byes,
+                                               int* bye, int* count);
+
+/** @brief Called once per finished match, serialized across workers. */
+typedef void (*TournamentDoneFn)(struct TournamentMatch* match, void* context);
+
+/**
+ * @brief Plays every match that is not done yet on `threads` workers.
+ * @param threads Worker count; values < 1 use one worker per online CPU.
+ * @param pin     Pin worker i to CPU (i % CPUs) where the platform supports it.
+ * @return 0 on success, -1 if no worker could start or a match failed.
+ */
+int tournament_play(struct TournamentMatch* matches, int count, const struct TournamentConfig* config,
+                    int threads, bool pin, TournamentDoneFn done, void* context);
+
+#endif /* ENGINE_GAME_TOURNAMENT_H */
@@ -0,0 +1,114 @@
+#include "trajectory.h"
+#include "entities/ball.h"
+
+void ball_path_free(struct BallPath *path, struct Vec2 position, struct Vec2 velocity) {
+    path->origin = position;
+    path->velocity = velocity;
+    path->speed = hypotf(velocity.x, velocity.y);
+    path->carried = false;
+    if (path->speed > BALL_STOP_SPEED) {
+        path->rest_time = logf(path->speed / BALL_STOP_SPEED) / BALL_DECAY_RATE;
+        path->rest_travel = (1.0f - BALL_STOP_SPEED / path->speed) / BALL_DECAY_RATE;
+    } else {
+        path->rest_time = 0.0f;
+        path->rest_travel = 0.0f;
+    }
+}
+
+void ball_path(struct BallPath *path, const struct Ball *ball) {
+    ball_path_free(path, ball->position, ball->velocity);
+    if (ball->possessor) {
+        path->carried = true;
+        path->rest_time = (path->speed > 0.0f) ? INFINITY : 0.0f;
+        path->rest_travel = 0.0f;
+    }
+}
+
+struct Vec2 ball_position_at(const struct BallPath *path, float t) {
+    float travel;
+    if (path->carried)
+        travel = t;
+    else if (t >= path->rest_time)
+        travel = path->rest_travel;
+    else
+        travel = ball_travel(ball_decay(t));
+    struct Vec2 p = { path->origin.x + path->velocity.x * travel, path->origin.y + path->velocity.y * travel };
+    return p;
+}
+
+struct Vec2 ball_velocity_at(const struct BallPath *path, float t) {
+    struct Vec2 v = { 0.0f, 0.0f };
+    if (path->carried) {
+        v = path->velocity;
+    } else if (t < path->rest_time) {
+        const float decay = ball_decay(t);
+        v.x = path->velocity.x * decay;
+        v.y = path->velocity.y * decay;
+    }
+    return v;
+}
+
+struct Vec2 ball_rest_point(const struct BallPath *path) {
+    struct Vec2 p = { path->origin.x + path->velocity.x * path->rest_travel,
+                      path->origin.y + path->velocity.y * path->rest_travel };
+    return p;
+}
+
+/**
+ * @brief Earliest t >= 0 with |d + w t| <= reach + speed t, for a ball at
+ * offset d from the player moving at constant velocity w.
+ *
+ * Squaring gives a t^2 + 2 b t + c = 0 with a = w.w - speed^2,
+ * b = d.w - reach speed and c = d.d - reach^2, whose smaller non-negative
+ * root is c / (-b + sqrt(b^2 - a c)) whenever there is one: if the player is
+ * the faster (a < 0) there always is, otherwise the gap has to be closing.
+ */
+static float intercept_linear(float dx, float dy, float wx, float wy, float speed, float reach) {
+    const float c = dx * dx + dy * dy - reach * reach;
+    if (c <= 0.0f)
+        return 0.0f;
+    const float a = wx * wx + wy * wy - speed * speed;
+    const float b = dx * wx + dy * wy - reach * speed;
+    if (a >= 0.0f && b >= 0.0f)
+        return INFINITY;
+    const float disc = b * b - a * c;
+    if (disc < 0.0f)
+        return INFINITY;
+    return c / (-b + sqrtf(disc));
+}
+
+float ball_intercept_time(const struct BallPath *path, struct Vec2 from, float speed, float reach) {
+    const float dx = path->origin.x - from.x;
+    const float dy = path->origin.y - from.y;
+    if (path->carried)
+        return intercept_linear(dx, dy, path->velocity.x, path->velocity.y, speed, reach);
+
+    float t = 0.0f;
+    for (int step = 0; step < BALL_INTERCEPT_MAX_STEPS; step++) {
+        if (t >= path->rest_time) {
+            // it lies still from here on: the player just has to get there
+            const struct Vec2 rest = ball_rest_point(path);
+            const float still = intercept_linear(rest.x - from.x, rest.y - from.y, 0.0f, 0.0f, speed, reach);
+            return (still > t) ? still : t;
+        }
+        // ball_position_at() and ball_velocity_at() share the decay
+        const float decay = ball_decay(t);
+        const float travel = ball_travel(decay);
+        const float ox = dx + path->velocity.x * travel;
+        const float oy = dy + path->velocity.y * travel;
+        const float distance = sqrtf(ox * ox + oy * oy);
+        const float gap = distance - reach - speed * t;
+        if (gap <= BALL_INTERCEPT_TOLERANCE)
+            return t;
+        // if the ball cannot roll close enough before it stops, go straight to the rest point
+        const float rolls = (path->speed * decay - BALL_STOP_SPEED) / BALL_DECAY_RATE;
+        if (distance - rolls - reach - speed * path->rest_time > 0.0f) {
+            t = path->rest_time;
+            continue;
+        }
+        // the ball only ever comes towards the player slower from here on
+        const float closing = -(path->velocity.x * ox + path->velocity.y * oy) * decay / distance;
+        t += gap / ((closing > 0.0f ? closing : 0.0f) + speed);
+    }
+    return t;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file trajectory.h
+ * @brief Closed-form ball motion: where a ball will be, where it stops, and
+ * how soon a player can reach it.
+ * * A free ball's velocity decays exponentially, v(t) = v0 e^(-k t) with
+ * k = BALL_DECAY_RATE (FRICTION per 1/FRICTION_REFERENCE_RATE seconds), in a
+ * straight line, so it has covered v0 (1 - e^(-k t)) / k by time t. Once its
+ * speed falls to BALL_STOP_SPEED it stops dead, (|v0| - BALL_STOP_SPEED) / k
+ * from where it started. move_scene() steps the ball with exactly this
+ * model (ball_roll()), whatever the tick rate, so a prediction made from
+ * any tick is what the simulation will do as long as nobody touches the
+ * ball and it stays off the walls. A carried ball goes where its possessor
+ * goes; the model moves it on at its current velocity.
+ *
+ * Everything here is O(1) except ball_intercept_time(), which only has to
+ * iterate while a free ball is still rolling.
+ */
+
+#ifndef ENGINE_GAME_TRAJECTORY_H
+#define ENGINE_GAME_TRAJECTORY_H
+
+#include <math.h>
+#include <stdbool.h>
+
+#include "core/constants.h"
+#include "core/vec2.h"
+
+struct Ball;
+
+/** @brief Decay rate k of a free ball's speed, in 1/s: FRICTION per 1/FRICTION_REFERENCE_RATE s. */
+#define BALL_DECAY_RATE (-logf(FRICTION) * FRICTION_REFERENCE_RATE)
+
+/** @brief ball_intercept_time() stops once the player is within this many px of reaching the ball. */
+#define BALL_INTERCEPT_TOLERANCE 0.01f
+
+/** @brief Most steps ball_intercept_time() takes along a rolling ball's path. */
+#define BALL_INTERCEPT_MAX_STEPS 32
+
+/** @brief Factor a rolling ball's velocity is multiplied by over `dt` seconds. */
+static inline float ball_decay(float dt) {
+    return expf(-BALL_DECAY_RATE * dt);
+}
+
+/** @brief Distance a rolling ball covers over `dt` seconds per px/s of starting speed, given ball_decay(dt). */
+static inline float ball_travel(float decay) {
+    return (1.0f - decay) / BALL_DECAY_RATE;
+}
+
+/**
+ * @brief Rolls a free ball's velocity on by one tick.
+ * * The ball moves by its velocity (before the call) times the returned
+ * factor: ball_travel() normally, less if it comes to rest during the tick,
+ * in which case it moves exactly to its rest point and `velocity` is zeroed;
+ * otherwise `velocity` is multiplied by `decay`. A ball already slower than
+ * BALL_STOP_SPEED does not move. The lockstep kernels repeat these float
+ * operations in this order.
+ * @param decay ball_decay(dt).
+ * @param travel ball_travel(decay).
+ */
+static inline float ball_roll(struct Vec2 *velocity, float decay, float travel) {
+    const float speed2 = velocity->x * velocity->x + velocity->y * velocity->y;
+    const float vx = velocity->x * decay;
+    const float vy = velocity->y * decay;
+    if (vx * vx + vy * vy < BALL_STOP_SPEED * BALL_STOP_SPEED) {
+        // it reaches the stop speed this tick, that far along
+        const float rest = (1.0f - BALL_STOP_SPEED / sqrtf(speed2)) / BALL_DECAY_RATE;
+        velocity->x = 0.0f;
+        velocity->y = 0.0f;
+        return (rest > 0.0f) ? rest : 0.0f;
+    }
+    velocity->x = vx;
+    velocity->y = vy;
+    return travel;
+}
+
+/**
+ * @struct BallPath
+ * @brief A ball's motion from one moment on, as the model predicts it.
+ */
+struct BallPath {
+    struct Vec2 origin;     /**< Position at t = 0. */
+    struct Vec2 velocity;   /**< Velocity at t = 0. */
+    float speed;            /**< |velocity|. */
+    float rest_time;        /**< When it stops: 0 if it is not moving, INFINITY if carried. */
+    float rest_travel;      /**< Distance to the rest point per px/s of starting speed (as ball_travel()). */
+    bool carried;           /**< Moves on at `velocity` (with its possessor) instead of rolling. */
+};
+
+/** @brief The path of `ball` from where it is now. */
+void ball_path(struct BallPath *path, const struct Ball *ball);
+
+/** @brief The path of a free ball at `position` moving at `velocity`. */
+void ball_path_free(struct BallPath *path, struct Vec2 position, struct Vec2 velocity);
+
+/** @brief Where the ball is `t` seconds on (t >= 0). */
+struct Vec2 ball_position_at(const struct BallPath *path, float t);
+
+/** @brief The ball's velocity `t` seconds on. */
+struct Vec2 ball_velocity_at(const struct BallPath *path, float t);
+
+/** @brief Where a free ball comes to rest; for a carried one, where it is now. */
+struct Vec2 ball_rest_point(const struct BallPath *path);
+
+/**
+ * @brief Earliest time a player at `from` running at `speed` px/s gets
+ * within `reach` of the ball's centre (e.g. player plus ball radius).
+ * * 0 if they already are. For a carried ball, or a free one once it has
+ * stopped, the answer is the root of a quadratic. While a free ball still
+ * rolls, there is no closed form (the time sits inside the exponential), so
+ * the solver walks along the path: each step is the gap left to close over
+ * the fastest the gap can shrink (the player's speed plus how fast the ball
+ * comes towards them then, which on a straight, slowing path only drops).
+ * That can never step past the first moment the player
+ * reaches the ball, and it stops within BALL_INTERCEPT_TOLERANCE px of it.
+ * As soon as the ball cannot roll near enough before it stops, the walk
+ * jumps to the rest point. Most chases take two to four steps; after
+ * BALL_INTERCEPT_MAX_STEPS the time reached so far is returned.
+ * @return Seconds from now, or INFINITY if the player can never get there.
+ */
+float ball_intercept_time(const struct BallPath *path, struct Vec2 from, float speed, float reach);
+
+#endif /* ENGINE_GAME_TRAJECTORY_H */
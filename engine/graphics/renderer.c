@@ -1,12 +1,16 @@
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
 #include <SDL_image.h>
 
 #include "renderer.h"
 #include "core/constants.h"
-#include "logic/referee.h"
 #include "entities/team.h"
 #include "entities/ball.h"
+#include "core/profile.h"
+
+/** @brief Side of the cached disc sprite; circles up to this diameter stay sharp. */
+#define DISC_TEXTURE_SIZE 64
 
 // for scoreboard
 static void draw_filled_rect(SDL_Renderer* r, int x, int y, int w, int h, SDL_Color color) {
@@ -38,21 +42,30 @@ static void draw_net_texture(SDL_Renderer* r, SDL_Rect box) {
         SDL_RenderDrawLine(r, box.x, y, box.x + box.w, y);
 }
 
-static void draw_pitch_markings(SDL_Renderer* r) {
+static void draw_pitch_markings(SDL_Renderer* r, const Field* field) {
+    const int pitch_x = (int)field->pitch_x;
+    const int pitch_y = (int)field->pitch_y;
+    const int pitch_w = (int)field->pitch_w;
+    const int pitch_h = (int)field->pitch_h;
+    const int center_x = (int)field->center_x;
+    const int center_y = (int)field->center_y;
+    const int goal_width = (int)field->goal_width;
+    const int goal_height = (int)field->goal_height;
+
     // Draw Grass Stripes
-    int stripe_h = SCREEN_HEIGHT / GRASS_STRIPE_COUNT;
+    int stripe_h = ((int)field->height + GRASS_STRIPE_COUNT - 1) / GRASS_STRIPE_COUNT;
     for (int i = 0; i < GRASS_STRIPE_COUNT; i++) {
         if (i % 2 == 0) SDL_SetRenderDrawColor(r, 0, 145, 0, 255);
         else            SDL_SetRenderDrawColor(r, 0, 120, 0, 255);
-        SDL_Rect stripe = {0, i * stripe_h, SCREEN_WIDTH, stripe_h};
+        SDL_Rect stripe = {0, i * stripe_h, (int)field->width, stripe_h};
         SDL_RenderFillRect(r, &stripe);
     }
 
     // GOAL PARAMETERS
-    int goal_top_y = CENTER_Y - (GOAL_HEIGHT / 2);
+    int goal_top_y = center_y - (goal_height / 2);
 
-    SDL_Rect left_goal = { PITCH_X - GOAL_WIDTH, goal_top_y, GOAL_WIDTH, GOAL_HEIGHT };
-    SDL_Rect right_goal = { PITCH_X + PITCH_W, goal_top_y, GOAL_WIDTH, GOAL_HEIGHT };
+    SDL_Rect left_goal = { pitch_x - goal_width, goal_top_y, goal_width, goal_height };
+    SDL_Rect right_goal = { pitch_x + pitch_w, goal_top_y, goal_width, goal_height };
 
     // Draw Net Texture
     draw_net_texture(r, left_goal);
@@ -68,74 +81,130 @@ static void draw_pitch_markings(SDL_Renderer* r) {
     // "Erase" the Goal Mouths. Barely recognizable
     // Use the grass color to overwrite the white line facing the field
     SDL_SetRenderDrawColor(r, 0, 145, 0, 255); 
-    // SDL_RenderDrawLine(r, PITCH_X, goal_top_y + 1, PITCH_X, goal_top_y + GOAL_HEIGHT - 1);
-    // SDL_RenderDrawLine(r, PITCH_X + PITCH_W, goal_top_y + 1, PITCH_X + PITCH_W, goal_top_y + GOAL_HEIGHT - 1);
+    // SDL_RenderDrawLine(r, pitch_x, goal_top_y + 1, pitch_x, goal_top_y + goal_height - 1);
+    // SDL_RenderDrawLine(r, pitch_x + pitch_w, goal_top_y + 1, pitch_x + pitch_w, goal_top_y + goal_height - 1);
 
     // Draw Main Pitch Lines
     SDL_SetRenderDrawColor(r, 255, 255, 255, 255); 
 
     // Out Lines
-    SDL_Rect field_rect = { PITCH_X, PITCH_Y, PITCH_W, PITCH_H };
+    SDL_Rect field_rect = { pitch_x, pitch_y, pitch_w, pitch_h };
     SDL_RenderDrawRect(r, &field_rect);
 
     // Center Line & Circle
-    SDL_RenderDrawLine(r, CENTER_X, PITCH_Y, CENTER_X, PITCH_Y + PITCH_H);
-    draw_hollow_circle(r, CENTER_X, CENTER_Y, 90);
+    SDL_RenderDrawLine(r, center_x, pitch_y, center_x, pitch_y + pitch_h);
+    draw_hollow_circle(r, center_x, center_y, (int)CENTER_CIRCLE_RADIUS);
 
     // Penalty Areas
     int box_w = 80;
     int box_h = 200;
-    int box_top = CENTER_Y - (box_h / 2);
-    SDL_Rect left_box = { PITCH_X, box_top, box_w, box_h };
+    int box_top = center_y - (box_h / 2);
+    SDL_Rect left_box = { pitch_x, box_top, box_w, box_h };
     SDL_RenderDrawRect(r, &left_box);
-    SDL_Rect right_box = { PITCH_X + PITCH_W - box_w, box_top, box_w, box_h };
+    SDL_Rect right_box = { pitch_x + pitch_w - box_w, box_top, box_w, box_h };
     SDL_RenderDrawRect(r, &right_box);
 }
 
-static void render_text(SDL_Renderer* r, TTF_Font* font, const char* text, int x, int y, SDL_Color color) {
-    if (!font || !text) return;
-
-    SDL_Surface* surface = TTF_RenderText_Solid(font, text, color);
-    if (!surface) {
-        SDL_Log("TTF_RenderText_Solid failed: %s", TTF_GetError());
+/**
+ * @brief Draws the static pitch into r->pitch, creating the texture if needed.
+ * On failure the pitch texture is dropped and the markings are drawn every frame instead.
+ */
+static void build_pitch(struct Renderer* r) {
+    r->pitch_dirty = false;
+    if (!SDL_RenderTargetSupported(r->sdl_renderer))
+        return;
+    if (!r->pitch) {
+        r->pitch = SDL_CreateTexture(r->sdl_renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+                                     (int)r->field.width, (int)r->field.height);
+        if (!r->pitch) {
+            SDL_Log("Pitch texture creation failed: %s", SDL_GetError());
+            return;
+        }
+        SDL_SetTextureBlendMode(r->pitch, SDL_BLENDMODE_NONE);   // opaque background, plain copy
+    }
+    if (SDL_SetRenderTarget(r->sdl_renderer, r->pitch) != 0) {
+        SDL_Log("Pitch texture not drawable: %s", SDL_GetError());
+        SDL_DestroyTexture(r->pitch);
+        r->pitch = NULL;
         return;
     }
+    // the nets are translucent over the grass, as in the old per-frame drawing
+    SDL_SetRenderDrawBlendMode(r->sdl_renderer, SDL_BLENDMODE_BLEND);
+    draw_pitch_markings(r->sdl_renderer, &r->field);
+    SDL_SetRenderTarget(r->sdl_renderer, NULL);
+}
 
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(r, surface);
-    if (!texture) {
-        SDL_Log("SDL_CreateTextureFromSurface failed: %s", SDL_GetError());
+/**
+ * @brief Builds the disc sprite: white, with alpha = coverage of each pixel
+ * (4x4 samples), so scaled copies keep a smooth edge.
+ */
+static SDL_Texture* create_disc(SDL_Renderer* r) {
+    static Uint8 pixels[DISC_TEXTURE_SIZE * DISC_TEXTURE_SIZE * 4];
+    const float radius = DISC_TEXTURE_SIZE / 2.0f;
+
+    for (int y = 0; y < DISC_TEXTURE_SIZE; y++) {
+        for (int x = 0; x < DISC_TEXTURE_SIZE; x++) {
+            int covered = 0;
+            for (int sy = 0; sy < 4; sy++) {
+                for (int sx = 0; sx < 4; sx++) {
+                    const float dx = x + (sx + 0.5f) / 4.0f - radius;
+                    const float dy = y + (sy + 0.5f) / 4.0f - radius;
+                    covered += dx * dx + dy * dy <= radius * radius;
+                }
+            }
+            Uint8* p = &pixels[(y * DISC_TEXTURE_SIZE + x) * 4];
+            p[0] = p[1] = p[2] = 255;
+            p[3] = (Uint8)(covered * 255 / 16);
+        }
     }
 
-    // Set the destination rectangle for drawing
-    SDL_Rect dst = { x, y, surface->w, surface->h };
-    
-    // Draw the texture and clean up
-    if (texture) {
-        SDL_RenderCopy(r, texture, NULL, &dst);
-        SDL_DestroyTexture(texture);
+    SDL_Texture* disc = SDL_CreateTexture(r, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC,
+                                          DISC_TEXTURE_SIZE, DISC_TEXTURE_SIZE);
+    if (!disc) {
+        SDL_Log("Disc texture creation failed: %s", SDL_GetError());
+        return NULL;
     }
-    
-    SDL_FreeSurface(surface);
+    SDL_UpdateTexture(disc, NULL, pixels, DISC_TEXTURE_SIZE * 4);
+    SDL_SetTextureBlendMode(disc, SDL_BLENDMODE_BLEND);
+    return disc;
 }
 
-static void draw_circle(SDL_Renderer* r, int cx, int cy, int radius) {
-    for (int w = 0; w < radius * 2; w++) {
-        for (int h = 0; h < radius * 2; h++) {
-            const int dx = w - radius;
-            const int dy = h - radius;
-            if (dx * dx + dy * dy <= radius * radius) {
-                SDL_RenderDrawPoint(r, cx + dx, cy + dy);
-            }
-        }
+/**
+ * @brief Draws a filled circle: one tinted copy of the disc sprite, or one
+ * line per row if the sprite could not be created.
+ */
+static void draw_circle(struct Renderer* r, int cx, int cy, int radius, SDL_Color color) {
+    if (r->disc) {
+        SDL_SetTextureColorMod(r->disc, color.r, color.g, color.b);
+        SDL_SetTextureAlphaMod(r->disc, color.a);
+        const SDL_Rect dst = { cx - radius, cy - radius, radius * 2, radius * 2 };
+        SDL_RenderCopy(r->sdl_renderer, r->disc, NULL, &dst);
+        return;
     }
+    SDL_SetRenderDrawColor(r->sdl_renderer, color.r, color.g, color.b, color.a);
+    for (int dy = -radius; dy < radius; dy++) {
+        const int half = (int)sqrtf((float)(radius * radius - dy * dy));
+        SDL_RenderDrawLine(r->sdl_renderer, cx - half, cy + dy, cx + half - 1, cy + dy);
+    }
+}
+
+// blend the last two physics states for drawing
+static struct Vec2 interpolate(const struct Vec2* previous, const struct Vec2* current, float alpha) {
+    struct Vec2 v = {
+        previous->x + (current->x - previous->x) * alpha,
+        previous->y + (current->y - previous->y) * alpha
+    };
+    return v;
 }
 
 /**
  * @brief Initializes the SDL window and renderer.
  * @param r Pointer to Renderer struct to initialize.
+ * @param field Geometry of the scenes it will draw.
  * @return 0 on success.
  */
-int renderer_init(struct Renderer* r) {
+int renderer_init(struct Renderer* r, const Field* field) {
+    r->field = *field;
     if (SDL_Init(SDL_INIT_VIDEO) != 0) {
         SDL_Log("SDL_Init failed: %s", SDL_GetError());
         exit(1);
@@ -165,7 +234,7 @@ int renderer_init(struct Renderer* r) {
     r->window = SDL_CreateWindow(
         "Soccer Engine",
         SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-        SCREEN_WIDTH, SCREEN_HEIGHT, 0
+        (int)field->width, (int)field->height, 0
     );
 
     if (!r->window) {
@@ -174,7 +243,7 @@ int renderer_init(struct Renderer* r) {
         exit(1);
     }
 
-    r->sdl_renderer = SDL_CreateRenderer(r->window, -1, SDL_RENDERER_ACCELERATED);
+    r->sdl_renderer = SDL_CreateRenderer(r->window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE);
     if (!r->sdl_renderer) {
         SDL_Log("Renderer creation failed: %s", SDL_GetError());
         SDL_DestroyWindow(r->window);
@@ -210,7 +279,7 @@ int renderer_init(struct Renderer* r) {
     }
 
     // Load player textures
-    for (int i = 0; i < PLAYER_COUNT; i++) {
+    for (int i = 0; i < DEFAULT_TEAM_SIZE; i++) {
         char filename[512];
         char player_char = 'a' + i;
 
@@ -227,26 +296,62 @@ int renderer_init(struct Renderer* r) {
         }
     }
     #pragma GCC diagnostic pop
-    
+
+    r->pitch = NULL;
+    build_pitch(r);
+    r->disc = create_disc(r->sdl_renderer);
+    memset(&r->text, 0, sizeof(r->text));
+    digit_atlas_build(&r->digits, r->sdl_renderer, r->font);
     return 0;
 }
 
+void renderer_handle_event(struct Renderer* r, const SDL_Event* event) {
+    switch (event->type) {
+    case SDL_RENDER_DEVICE_RESET:
+        // every texture is gone with the device; make a new one
+        if (r->pitch)
+            SDL_DestroyTexture(r->pitch);
+        r->pitch = NULL;
+        r->pitch_dirty = true;
+        if (r->disc)
+            SDL_DestroyTexture(r->disc);
+        r->disc = create_disc(r->sdl_renderer);
+        text_cache_clear(&r->text);
+        digit_atlas_destroy(&r->digits);
+        digit_atlas_build(&r->digits, r->sdl_renderer, r->font);
+        break;
+    case SDL_RENDER_TARGETS_RESET:
+        r->pitch_dirty = true;
+        break;
+    case SDL_WINDOWEVENT:
+        if (event->window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+            r->pitch_dirty = true;
+        break;
+    default:
+        break;
+    }
+}
+
 
 /**
  * @brief Cleans up SDL renderer and window.
  * @param r Pointer to Renderer struct.
  */
 void renderer_destroy(struct Renderer* r) {
+    text_cache_clear(&r->text);
+    digit_atlas_destroy(&r->digits);
     if (r->font) TTF_CloseFont(r->font);
     TTF_Quit();
     IMG_Quit();
 
-    for (int i = 0; i < PLAYER_COUNT; i++) {
+    for (int i = 0; i < DEFAULT_TEAM_SIZE; i++) {
         if (r->red_icons[i])
             SDL_DestroyTexture(r->red_icons[i]);
         if (r->blue_icons[i])
             SDL_DestroyTexture(r->blue_icons[i]);
     }
+    if (r->pitch) SDL_DestroyTexture(r->pitch);
+    if (r->disc) SDL_DestroyTexture(r->disc);
     if (r->sdl_renderer) SDL_DestroyRenderer(r->sdl_renderer);
     if (r->window) SDL_DestroyWindow(r->window);
     SDL_Quit();
@@ -258,45 +363,66 @@ void renderer_destroy(struct Renderer* r) {
  * @param r Pointer to Renderer.
  * @param scene Pointer to Scene to render.
  */
-void renderer_draw_scene(struct Renderer* r, const Scene* scene) {
-
-    draw_pitch_markings(r->sdl_renderer);
-
-    for (int i = 0; i < PLAYER_COUNT; i++) {
+void renderer_draw_scene(struct Renderer* r, const Scene* scene,
+                         const struct SceneSnapshot* previous, float alpha) {
+
+    PROFILE_BEGIN(PROFILE_DRAW_PITCH);
+    if (r->pitch_dirty)
+        build_pitch(r);
+    if (r->pitch)
+        SDL_RenderCopy(r->sdl_renderer, r->pitch, NULL, NULL);
+    else
+        draw_pitch_markings(r->sdl_renderer, &r->field);
+    PROFILE_END(PROFILE_DRAW_PITCH);
+
+    // Don't blend across a state change: set pieces teleport players and ball.
+    const int team_size = scene->team_size;
+    if (previous && (previous->state != scene->state || previous->count != 2 * team_size))
+        previous = NULL;
+
+    PROFILE_BEGIN(PROFILE_DRAW_PLAYERS);
+    for (int i = 0; i < team_size; i++) {
         const Player *p1 = scene->first_team->players[i];
         const Player *p2 = scene->second_team->players[i];
+        const struct Vec2 pos1 = previous ? interpolate(&previous->players[i], &p1->position, alpha) : p1->position;
+        const struct Vec2 pos2 = previous ? interpolate(&previous->players[team_size + i], &p2->position, alpha) : p2->position;
+        SDL_Texture* red_icon = i < DEFAULT_TEAM_SIZE ? r->red_icons[i] : NULL;
+        SDL_Texture* blue_icon = i < DEFAULT_TEAM_SIZE ? r->blue_icons[i] : NULL;
 
         // Players icon rectangle (position + size)
         SDL_Rect dest_rect = {
-            (int)p1->position.x - p1->radius,
-            (int)p1->position.y - p1->radius,
+            (int)pos1.x - p1->radius,
+            (int)pos1.y - p1->radius,
             (int)p1->radius * 2,
             (int)p1->radius * 2
         };
-        if (r->red_icons[i]) {
-            SDL_RenderCopy(r->sdl_renderer, r->red_icons[i], NULL, &dest_rect);
+        if (red_icon) {
+            SDL_RenderCopy(r->sdl_renderer, red_icon, NULL, &dest_rect);
         } else { // Fallback to circle if texture failed to load
-            SDL_SetRenderDrawColor(r->sdl_renderer, 255, 0, 0, 255);
-            draw_circle(r->sdl_renderer, (int)p1->position.x, (int)p1->position.y, (int)p1->radius);
+            draw_circle(r, (int)pos1.x, (int)pos1.y, (int)p1->radius, (SDL_Color){255, 0, 0, 255});
         }
-        dest_rect.x = (int)p2->position.x - p2->radius;
-        dest_rect.y = (int)p2->position.y - p2->radius;
+        dest_rect.x = (int)pos2.x - p2->radius;
+        dest_rect.y = (int)pos2.y - p2->radius;
         
-        if (r->blue_icons[i]) {
-            SDL_RenderCopy(r->sdl_renderer, r->blue_icons[i], NULL, &dest_rect);
+        if (blue_icon) {
+            SDL_RenderCopy(r->sdl_renderer, blue_icon, NULL, &dest_rect);
         } else { // Fallback
-            SDL_SetRenderDrawColor(r->sdl_renderer, 0, 0, 255, 255);
-            draw_circle(r->sdl_renderer, (int)p2->position.x, (int)p2->position.y, (int)p2->radius);
+            draw_circle(r, (int)pos2.x, (int)pos2.y, (int)p2->radius, (SDL_Color){0, 0, 255, 255});
         }
     }
+    PROFILE_END(PROFILE_DRAW_PLAYERS);
 
-    SDL_SetRenderDrawColor(r->sdl_renderer, 255, 255, 255, 255);
-    draw_circle(r->sdl_renderer, (int)scene->ball->position.x, (int)scene->ball->position.y, (int)scene->ball->radius);
+    PROFILE_BEGIN(PROFILE_DRAW_BALL);
+    const struct Vec2 ball_pos = previous ? interpolate(&previous->ball, &scene->ball->position, alpha) : scene->ball->position;
+    draw_circle(r, (int)ball_pos.x, (int)ball_pos.y, (int)scene->ball->radius, (SDL_Color){255, 255, 255, 255});
+    PROFILE_END(PROFILE_DRAW_BALL);
 
     // DRAW SCOREBOARD
+    PROFILE_BEGIN(PROFILE_DRAW_HUD);
     int box_w = 150;
     int box_h = 50;
-    int box_x = (SCREEN_WIDTH - box_w) / 2;
+    const int screen_width = (int)r->field.width;
+    int box_x = (screen_width - box_w) / 2;
     int box_y = 5;
 
     // Background (semi-transparent black)
@@ -319,103 +445,35 @@ void renderer_draw_scene(struct Renderer* r, const Scene* scene) {
     char left_text[16];
     char right_text[16];
 
-    sprintf(left_text, "%d", left_score);
-    sprintf(right_text, "%d", right_score);
-
-    render_text(r->sdl_renderer, r->font,
-                left_text,
-                box_x + 25, box_y + 10,
-                left_color);
-
-    render_text(r->sdl_renderer, r->font,
-                right_text,
-                box_x + box_w - 40, box_y + 10,
-                right_color);
-
-    render_text(r->sdl_renderer, r->font,
-                "VS",
-                box_x + box_w / 2 - 15, box_y + 10,
-                (SDL_Color){255,255,255,255});
-
+    snprintf(left_text, sizeof(left_text), "%d", left_score);
+    snprintf(right_text, sizeof(right_text), "%d", right_score);
+
+    digit_atlas_draw(&r->digits, r->sdl_renderer,
+                     left_text,
+                     box_x + 25, box_y + 10,
+                     left_color);
+
+    digit_atlas_draw(&r->digits, r->sdl_renderer,
+                     right_text,
+                     box_x + box_w - 40, box_y + 10,
+                     right_color);
+
+    text_cache_draw(&r->text, r->sdl_renderer, r->font,
+                    "VS",
+                    box_x + box_w / 2 - 15, box_y + 10,
+                    (SDL_Color){255,255,255,255});
+
+    // Match clock under the box
+    const int seconds = scene->remaining_time > 0.0f ? (int)ceilf(scene->remaining_time) : 0;
+    char clock_text[16];
+    snprintf(clock_text, sizeof(clock_text), "%d:%02d", seconds / 60, seconds % 60);
+    digit_atlas_draw(&r->digits, r->sdl_renderer,
+                     clock_text,
+                     (screen_width - digit_atlas_width(&r->digits, clock_text)) / 2, box_y + box_h + 4,
+                     (SDL_Color){255,255,255,255});
+    PROFILE_END(PROFILE_DRAW_HUD);
+
+    PROFILE_BEGIN(PROFILE_PRESENT);
     SDL_RenderPresent(r->sdl_renderer);
-}
-
-
-/**
- * @brief Main logic dispatcher.
- * * This function orchestrates the three phases of a frame:
- * 1. Time Management (Is the game over?)
- * 2. Scene Update (Physics & Movement)
- * 3. Referee Check (Rules & Fouls)
- */
-void update_scene(Scene* scene, const float dt) {
-    // ----------------------------- PHASE 1: state controll -----------------------------
-    // --- State: RESTARTING (The short Delay before calling player to kick-off) ---
-    if (scene->state == STATE_RESTARTING) {
-        scene->wait_time -= dt;
-        if (scene->wait_time <= 0) {
-            scene->state = STATE_RUNNING;
-            printf("the player should now kick-off / throw-in ... \n");
-            struct Ball* ball = scene->ball;
-            struct Player* player = ball->possessor;
-            player->shooting_logic(player, scene);
-            verify_shoot(ball, true);
-            scene->ball->possessor = NULL;
-        }
-        return; // Don't process physics yet
-    }
-
-    // --- State: OUT ---
-    if (scene->state == STATE_OUT) {
-        scene->wait_time -= dt;
-        if (scene->wait_time < 0) {
-            scene->wait_time = 2.0f;    // wait 2 more seconds before calling the player to throw in
-            set_piece_out(scene);       // Position players/ball
-            scene->state = STATE_RESTARTING;
-        }
-        return;
-    }
-
-    // --- State: GOAL ---
-    if (scene->state == STATE_GOAL) {
-        scene->wait_time -= dt;
-        if (scene->wait_time < 0) {
-            scene->wait_time = 2.0f;    // wait 2 more seconds before calling the player to kick off
-            set_piece_goal(scene);      // Position players/ball
-            scene->state = STATE_RESTARTING;
-        }
-        return;
-    }
-
-    if (scene->state != STATE_RUNNING) return; // scene->state == STATE_TIMEOUT
-    scene->remaining_time -= dt;
-    // --- State: TIMEOUT ---
-    if (scene->remaining_time < 0.0f) {
-        printf("Game Time has ended ...\n");
-        scene->state = STATE_TIMEOUT;
-        return;
-    }
-
-    // ----------------------------- PHASE 2: update the scene -----------------------------
-    update_and_verify_scene_states(scene, dt);
-
-    // ----------------------------- PHASE 3: call the referee -----------------------------
-    // after screen update, call the referee to check all the rules
-    // --- referee check ---
-    switch (referee(scene)) {
-        case GOAL:
-            scene->state = STATE_GOAL;
-            scene->wait_time = 5.0f; // 5 second delay before kick-off
-            printf("Goal scored!\n");
-            printf("first team score: %d\n", scene->first_team->score);
-            printf("second team score: %d\n", scene->second_team->score);
-            break;
-        case OUT:
-            scene->state = STATE_OUT;
-            scene->wait_time = 2.0f; // 2 second delay before set-piece
-            printf("Ball out of bounds!\n");
-            break;
-        default:
-            break;  // no event, game continues
-    }
+    PROFILE_END(PROFILE_PRESENT);
 }
@@ -9,8 +9,11 @@
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
+#include <stdbool.h>
 #include "game/scene.h"
+#include "game/timestep.h"
 #include "core/constants.h"
+#include "graphics/text_cache.h"
 
 /**
  * @struct Renderer
@@ -20,24 +23,38 @@ struct Renderer {
     SDL_Window* window;
     SDL_Renderer* sdl_renderer;
     TTF_Font* font;
-    SDL_Texture* red_icons[PLAYER_COUNT];
-    SDL_Texture* blue_icons[PLAYER_COUNT];
+    Field field;            /**< Geometry the window and the pitch texture are sized for. */
+    SDL_Texture* red_icons[DEFAULT_TEAM_SIZE];  /**< Kits past these are drawn as plain discs. */
+    SDL_Texture* blue_icons[DEFAULT_TEAM_SIZE];
+    SDL_Texture* pitch;     /**< Grass, lines and nets drawn once; NULL if render targets are unsupported. */
+    bool pitch_dirty;       /**< The pitch texture lost its contents and is redrawn before the next frame. */
+    SDL_Texture* disc;      /**< White anti-aliased disc, tinted per draw for the ball and fallback players. */
+    struct TextCache text;  /**< Scoreboard labels, re-rasterized only when they change. */
+    struct DigitAtlas digits; /**< Glyphs for the scores and the match clock. */
 };
 
 /**
  * @brief Clears the screen and draws every entity in the Scene.
+ * * Entities are drawn at previous + (current - previous) * alpha, so motion
+ * stays smooth when the frame rate and the tick rate differ.
+ * @param previous Positions before the last tick, or NULL to draw the scene as is.
+ * @param alpha    Blend factor from timestep_alpha(), in [0, 1].
  */
-void renderer_draw_scene(struct Renderer* r, const struct Scene* scene);
+void renderer_draw_scene(struct Renderer* r, const struct Scene* scene,
+                         const struct SceneSnapshot* previous, float alpha);
 
 /**
- * @brief The core "Update" function called by the Main Loop.
- * * @param dt Delta Time: the time (in seconds) passed since the last frame. 
- * This ensures the game runs at the same speed regardless of FPS.
+ * @brief Lets the renderer react to window and device events.
+ * Call it for every polled event; a render target or device reset (or a
+ * resize) makes the cached pitch texture be rebuilt before the next frame,
+ * and a device reset also recreates the disc sprite and the text textures.
  */
-void update_scene(struct Scene* scene, float dt);
+void renderer_handle_event(struct Renderer* r, const SDL_Event* event);
 
-
-int renderer_init(struct Renderer* r);
+/**
+ * @brief Opens a window the size of `field`'s world and draws its pitch.
+ */
+int renderer_init(struct Renderer* r, const Field* field);
 void renderer_destroy(struct Renderer* r);
 
 #endif
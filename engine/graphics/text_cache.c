@@ -0,0 +1,129 @@
+#include <string.h>
+
+#include "text_cache.h"
+
+static SDL_Texture* rasterize(SDL_Renderer* r, TTF_Font* font, const char* text, SDL_Color color,
+                              int* w, int* h) {
+    SDL_Surface* surface = TTF_RenderText_Solid(font, text, color);
+    if (!surface) {
+        SDL_Log("TTF_RenderText_Solid failed: %s", TTF_GetError());
+        return NULL;
+    }
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(r, surface);
+    if (!texture)
+        SDL_Log("SDL_CreateTextureFromSurface failed: %s", SDL_GetError());
+    *w = surface->w;
+    *h = surface->h;
+    SDL_FreeSurface(surface);
+    return texture;
+}
+
+static int same_color(SDL_Color a, SDL_Color b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+void text_cache_draw(struct TextCache* cache, SDL_Renderer* r, TTF_Font* font,
+                     const char* text, int x, int y, SDL_Color color) {
+    if (!font || !text) return;
+
+    struct TextCacheEntry* hit = NULL;
+    struct TextCacheEntry* victim = &cache->entries[0];
+    for (int i = 0; i < TEXT_CACHE_SLOTS; i++) {
+        struct TextCacheEntry* entry = &cache->entries[i];
+        if (entry->texture && same_color(entry->color, color) &&
+            strncmp(entry->text, text, TEXT_CACHE_MAX_LENGTH - 1) == 0) {
+            hit = entry;
+            break;
+        }
+        if (!entry->texture || (victim->texture && entry->last_used < victim->last_used))
+            victim = entry;
+    }
+
+    if (!hit) {
+        hit = victim;
+        if (hit->texture)
+            SDL_DestroyTexture(hit->texture);
+        strncpy(hit->text, text, TEXT_CACHE_MAX_LENGTH - 1);
+        hit->text[TEXT_CACHE_MAX_LENGTH - 1] = '\0';
+        hit->color = color;
+        hit->texture = rasterize(r, font, hit->text, color, &hit->w, &hit->h);
+        if (!hit->texture)
+            return;
+    }
+
+    hit->last_used = ++cache->clock;
+    SDL_Rect dst = { x, y, hit->w, hit->h };
+    SDL_RenderCopy(r, hit->texture, NULL, &dst);
+}
+
+void text_cache_clear(struct TextCache* cache) {
+    for (int i = 0; i < TEXT_CACHE_SLOTS; i++) {
+        if (cache->entries[i].texture)
+            SDL_DestroyTexture(cache->entries[i].texture);
+    }
+    memset(cache, 0, sizeof(*cache));
+}
+
+int digit_atlas_build(struct DigitAtlas* atlas, SDL_Renderer* r, TTF_Font* font) {
+    memset(atlas, 0, sizeof(*atlas));
+    if (!font) return -1;
+
+    // glyph edges from the widths of growing prefixes, so kerning matches whole-string rendering
+    char prefix[DIGIT_ATLAS_COUNT + 1];
+    int left = 0;
+    for (int i = 0; i < DIGIT_ATLAS_COUNT; i++) {
+        memcpy(prefix, DIGIT_ATLAS_GLYPHS, (size_t)i + 1);
+        prefix[i + 1] = '\0';
+        int right, h;
+        if (TTF_SizeText(font, prefix, &right, &h) != 0)
+            return -1;
+        atlas->x[i] = left;
+        atlas->w[i] = right - left;
+        left = right;
+    }
+
+    int w;
+    atlas->texture = rasterize(r, font, DIGIT_ATLAS_GLYPHS, (SDL_Color){255, 255, 255, 255}, &w, &atlas->h);
+    if (!atlas->texture)
+        return -1;
+    SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+    return 0;
+}
+
+void digit_atlas_destroy(struct DigitAtlas* atlas) {
+    if (atlas->texture)
+        SDL_DestroyTexture(atlas->texture);
+    memset(atlas, 0, sizeof(*atlas));
+}
+
+static int glyph_index(char c) {
+    const char* found = strchr(DIGIT_ATLAS_GLYPHS, c);
+    return (c && found) ? (int)(found - DIGIT_ATLAS_GLYPHS) : -1;
+}
+
+int digit_atlas_width(const struct DigitAtlas* atlas, const char* text) {
+    int width = 0;
+    for (const char* c = text; *c; c++) {
+        const int g = glyph_index(*c);
+        if (g >= 0)
+            width += atlas->w[g];
+    }
+    return width;
+}
+
+void digit_atlas_draw(const struct DigitAtlas* atlas, SDL_Renderer* r, const char* text,
+                      int x, int y, SDL_Color color) {
+    if (!atlas->texture) return;
+
+    SDL_SetTextureColorMod(atlas->texture, color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(atlas->texture, color.a);
+    for (const char* c = text; *c; c++) {
+        const int g = glyph_index(*c);
+        if (g < 0)
+            continue;
+        const SDL_Rect src = { atlas->x[g], 0, atlas->w[g], atlas->h };
+        const SDL_Rect dst = { x, y, atlas->w[g], atlas->h };
+        SDL_RenderCopy(r, atlas->texture, &src, &dst);
+        x += atlas->w[g];
+    }
+}
@@ -0,0 +1,70 @@
+/**
+ * @file text_cache.h
+ * @brief Rasterized HUD text, kept as textures until the text changes.
+ * * TTF rasterization plus a texture upload costs far more than drawing, and
+ * the scoreboard text changes a few times per match. A TextCache keeps the
+ * last few strings (keyed on text and colour) as textures and only
+ * re-rasterizes on a miss; a DigitAtlas holds "0123456789:" in one white
+ * texture, so clocks and counters are drawn glyph by glyph with a colour
+ * modulation and never rasterize at all. Neither allocates once warm.
+ */
+#ifndef ENGINE_TEXT_CACHE_H
+#define ENGINE_TEXT_CACHE_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+/** @brief Strings kept at once; the least recently drawn one is replaced on a miss. */
+#define TEXT_CACHE_SLOTS 8
+/** @brief Longest cached string, including the terminator; longer text is truncated. */
+#define TEXT_CACHE_MAX_LENGTH 32
+
+/** @brief Glyphs of the digit atlas, in texture order. */
+#define DIGIT_ATLAS_GLYPHS "0123456789:"
+#define DIGIT_ATLAS_COUNT 11
+
+struct TextCacheEntry {
+    char text[TEXT_CACHE_MAX_LENGTH];
+    SDL_Color color;
+    SDL_Texture* texture;       /**< NULL: empty slot. */
+    int w, h;
+    unsigned long last_used;    /**< TextCache::clock when last drawn. */
+};
+
+struct TextCache {
+    struct TextCacheEntry entries[TEXT_CACHE_SLOTS];
+    unsigned long clock;
+};
+
+struct DigitAtlas {
+    SDL_Texture* texture;       /**< White glyphs; NULL until built (or if the font is missing). */
+    int x[DIGIT_ATLAS_COUNT];   /**< Left edge of each glyph in the texture. */
+    int w[DIGIT_ATLAS_COUNT];
+    int h;
+};
+
+/**
+ * @brief Draws `text` with its top-left corner at (x, y), rasterizing it only if it is not cached.
+ */
+void text_cache_draw(struct TextCache* cache, SDL_Renderer* r, TTF_Font* font,
+                     const char* text, int x, int y, SDL_Color color);
+
+/** @brief Drops every cached texture (e.g. after a render device reset). */
+void text_cache_clear(struct TextCache* cache);
+
+/**
+ * @brief Rasterizes the atlas glyphs once.
+ * @return 0 on success, -1 if the font or texture is unavailable.
+ */
+int digit_atlas_build(struct DigitAtlas* atlas, SDL_Renderer* r, TTF_Font* font);
+
+void digit_atlas_destroy(struct DigitAtlas* atlas);
+
+/** @brief Width `text` takes when drawn from the atlas (characters outside it are skipped). */
+int digit_atlas_width(const struct DigitAtlas* atlas, const char* text);
+
+/** @brief Draws digits and colons from the atlas, tinted `color`, starting at (x, y). */
+void digit_atlas_draw(const struct DigitAtlas* atlas, SDL_Renderer* r, const char* text,
+                      int x, int y, SDL_Color color);
+
+#endif
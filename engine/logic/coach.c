@@ -1,18 +1,20 @@
 #include "coach.h"
+#include "coach_plugin.h"
 #include "core/constants.h"
 #include "entities/ball.h"
 #include "entities/team.h"
 #include "game/scene.h"
+#include "game/perception.h"
 #include <assert.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
 #include <stdbool.h>
-#include <time.h>
 
 // Set to false to let the other team use their own logic (if you implement it)
 // Set to true to test your logic on both teams
-bool coach_both_teams = true;
+// Read-only at run time, so matches on different threads can share it.
+static const bool coach_both_teams = true;
 
 static float max_player_speed(const struct Player *self) {
     return ((float)self->talents.agility / MAX_TALENT_PER_SKILL) * MAX_PLAYER_VELOCITY;
@@ -22,11 +24,8 @@ static float max_ball_speed(const struct Player *self) {
     return ((float)self->talents.shooting / MAX_TALENT_PER_SKILL) * MAX_BALL_VELOCITY;
 }
 
-static void move_towards_target(struct Player *self, float target_x, float target_y, float motivation) {
-    float dx = target_x - self->position.x;
-    float dy = target_y - self->position.y;
-    float d = hypotf(dx, dy);
-
+/** @brief Runs at `motivation` of top speed along (dx, dy), which is `d` long. */
+static void move_along(struct Player *self, float dx, float dy, float d, float motivation) {
     if (d <= 0.001f) {
         self->velocity.x = 0.0f;
         self->velocity.y = 0.0f;
@@ -38,27 +37,39 @@ static void move_towards_target(struct Player *self, float target_x, float targe
     self->velocity.y = (dy / d) * max_v;
 }
 
-static bool player_ball_colliding(const struct Player *p, const struct Ball *b) {
-    float dx = p->position.x - b->position.x;
-    float dy = p->position.y - b->position.y;
-    float rs = p->radius + b->radius;
-    return (dx * dx + dy * dy) <= (rs * rs);
+static void move_towards_target(struct Player *self, float target_x, float target_y, float motivation) {
+    float dx = target_x - self->position.x;
+    float dy = target_y - self->position.y;
+    move_along(self, dx, dy, hypotf(dx, dy), motivation);
 }
 
 void pressing_movement(struct Player *self, struct Scene *scene, float motivation) {
-    move_towards_target(self, scene->ball->position.x, scene->ball->position.y, motivation);
+    // head for where the ball will be by the time we can get to it
+    struct Vec2 target;
+    const float t = perception_intercept(scene, self, max_player_speed(self) * motivation, &target);
+    if (t > 0.0f && t < INFINITY) {
+        move_towards_target(self, target.x, target.y, motivation);
+        return;
+    }
+
+    // already touching it, or it cannot be caught: just chase it (offset and distance are shared this tick)
+    const struct Perception *perception = perception_ball(scene);
+    const int idx = perception_index(scene, self);
+    move_along(self, perception->to_ball[idx].x, perception->to_ball[idx].y,
+               perception->ball_distance[idx], motivation);
 }
 
 void attacking_movement(struct Player *self, struct Scene *scene, float motivation) {
-    float diff = (self->team == 1) ? (PITCH_W / 2.0f) : -(PITCH_W / 2.0f);
-    move_towards_target(self, CENTER_X + diff, CENTER_Y, motivation);
-    (void)scene;
+    const Field *field = &scene->field;
+    float diff = (self->team == 1) ? (field->pitch_w / 2.0f) : -(field->pitch_w / 2.0f);
+    move_towards_target(self, field->center_x + diff, field->center_y, motivation);
 }
 
 void gk_movement(struct Player *self, struct Scene *scene) {
-    float x_target = (self->team == 1) ? (PITCH_X + PLAYER_RADIUS) : (PITCH_X + PITCH_W - PLAYER_RADIUS);
-    float goal_top = CENTER_Y - GOAL_HEIGHT / 2.0f + BALL_RADIUS;
-    float goal_bottom = CENTER_Y + GOAL_HEIGHT / 2.0f - BALL_RADIUS;
+    const Field *field = &scene->field;
+    float x_target = (self->team == 1) ? (field->pitch_x + PLAYER_RADIUS) : (field->pitch_x + field->pitch_w - PLAYER_RADIUS);
+    float goal_top = field->center_y - field->goal_height / 2.0f + BALL_RADIUS;
+    float goal_bottom = field->center_y + field->goal_height / 2.0f - BALL_RADIUS;
     float y_target = self->position.y;
 
     if (scene->ball->position.y >= goal_top && scene->ball->position.y <= goal_bottom)
@@ -68,15 +79,10 @@ void gk_movement(struct Player *self, struct Scene *scene) {
 }
 
 void shoot(struct Player *self, struct Scene *scene, float x) {
-    static bool seeded = false;
-    if (!seeded) {
-        srand((unsigned int)time(NULL));
-        seeded = true;
-    }
-
-    float min_y = CENTER_Y - GOAL_HEIGHT / 2.0f + BALL_RADIUS;
-    float max_y = CENTER_Y + GOAL_HEIGHT / 2.0f - BALL_RADIUS;
-    float y_selection = min_y + ((float)rand() / (float)RAND_MAX) * (max_y - min_y);
+    const Field *field = &scene->field;
+    float min_y = field->center_y - field->goal_height / 2.0f + BALL_RADIUS;
+    float max_y = field->center_y + field->goal_height / 2.0f - BALL_RADIUS;
+    float y_selection = min_y + rng_float(&scene->rng) * (max_y - min_y);
 
     float dx = x - self->position.x;
     float dy = y_selection - self->position.y;
@@ -112,44 +118,40 @@ void pass(struct Player *self, struct Player *receiver, struct Scene *scene) {
 void decide_kick(struct Player *self, struct Scene *scene) {
     struct Team *current_team = (self->team == 1) ? scene->first_team : scene->second_team;
     struct Player *leader = self;
+    const Field *field = &scene->field;
+    const float goal_x = (self->team == 1) ? (field->pitch_x + field->pitch_w) : field->pitch_x;
 
     bool can_shoot = (self->team == 1)
-        ? (self->position.x > CENTER_X + PITCH_W / 6.0f)
-        : (self->position.x < CENTER_X - PITCH_W / 6.0f);
+        ? (self->position.x > field->center_x + field->pitch_w / 6.0f)
+        : (self->position.x < field->center_x - field->pitch_w / 6.0f);
 
     if (can_shoot) {
-        shoot(self, scene, (self->team == 1) ? (PITCH_X + PITCH_W) : PITCH_X);
+        shoot(self, scene, goal_x);
         return;
     }
 
-    for (int i = 0; i < PLAYER_COUNT; i++) {
-        struct Player *candidate = current_team->players[i];
-        if (!candidate || candidate == self)
-            continue;
-
-        bool better = (self->team == 1)
-            ? (candidate->position.x > leader->position.x)
-            : (candidate->position.x < leader->position.x);
-
-        if (better)
-            leader = candidate;
-    }
+    struct Player *candidate = perception_most_advanced(scene, self->team, self);
+    bool better = candidate && ((self->team == 1)
+        ? (candidate->position.x > self->position.x)
+        : (candidate->position.x < self->position.x));
+    if (better)
+        leader = candidate;
 
     if (leader != self) {
         pass(self, leader, scene);
         return;
     }
 
-    int random = rand() % PLAYER_COUNT;
+    int random = (int)rng_range(&scene->rng, (uint32_t)current_team->size);
     if (current_team->players[random] && current_team->players[random] != self)
         pass(self, current_team->players[random], scene);
     else
-        shoot(self, scene, (self->team == 1) ? (PITCH_X + PITCH_W) : PITCH_X);
+        shoot(self, scene, goal_x);
 }
 
 void change_stater(struct Player *self, struct Scene *scene) {
     self->state = MOVING;
-    if (player_ball_colliding(self, scene->ball))
+    if (perception_touches_ball(scene, self))
         self->state = INTERCEPTING;
     if (scene->ball->possessor == self)
         self->state = SHOOTING;
@@ -185,9 +187,9 @@ void change_stater(struct Player *self, struct Scene *scene) {
 void movement_logic_1_0(struct Player *self, struct Scene *scene) {
     if (scene->ball->possessor && scene->ball->possessor->team != self->team) {
         if (self->team == 1)
-            (scene->ball->position.x > CENTER_X) ? pressing_movement(self, scene, 1.0f) : pressing_movement(self, scene, 0.4f);
+            (scene->ball->position.x > scene->field.center_x) ? pressing_movement(self, scene, 1.0f) : pressing_movement(self, scene, 0.4f);
         else
-            (scene->ball->position.x < CENTER_X) ? pressing_movement(self, scene, 1.0f) : pressing_movement(self, scene, 0.4f);
+            (scene->ball->position.x < scene->field.center_x) ? pressing_movement(self, scene, 1.0f) : pressing_movement(self, scene, 0.4f);
     } else {
         attacking_movement(self, scene, 1.0f);
     }
@@ -203,9 +205,9 @@ void movement_logic_1_1(struct Player *self, struct Scene *scene) {
 void movement_logic_1_2(struct Player *self, struct Scene *scene) {
     if (scene->ball->possessor && scene->ball->possessor->team != self->team) {
         if (self->team == 1)
-            (scene->ball->position.x < CENTER_X) ? pressing_movement(self, scene, 1.0f) : pressing_movement(self, scene, 0.25f);
+            (scene->ball->position.x < scene->field.center_x) ? pressing_movement(self, scene, 1.0f) : pressing_movement(self, scene, 0.25f);
         else
-            (scene->ball->position.x > CENTER_X) ? pressing_movement(self, scene, 1.0f) : pressing_movement(self, scene, 0.25f);
+            (scene->ball->position.x > scene->field.center_x) ? pressing_movement(self, scene, 1.0f) : pressing_movement(self, scene, 0.25f);
     } else {
         attacking_movement(self, scene, 0.5f);
     }
@@ -311,17 +313,30 @@ static PlayerLogicFn team2_change_state[6] = {
 /* -------------------------------------------------------------------------
  * Factory functions
  * ------------------------------------------------------------------------- */
+
+/** @brief Outfield roles handed out, in turn, to kits past the six in the tables. */
+static const int extra_roles[] = { 1, 2, 4, 5, 0 };
+#define EXTRA_ROLE_COUNT ((int)(sizeof(extra_roles) / sizeof(extra_roles[0])))
+
+/** @brief The table row kit `kit` plays; kits 0-5 are their own row. */
+static int role_of(int kit) {
+    return kit < 6 ? kit : extra_roles[(kit - 6) % EXTRA_ROLE_COUNT];
+}
+
 PlayerLogicFn get_movement_logic(int team, int kit) {
+    kit = role_of(kit);
     if (coach_both_teams) return team1_movement[kit];
     return (team == 1) ? team1_movement[kit] : team2_movement[kit];
 }
 
 PlayerLogicFn get_shooting_logic(int team, int kit) {
+    kit = role_of(kit);
     if (coach_both_teams) return team1_shooting[kit];
     return (team == 1) ? team1_shooting[kit] : team2_shooting[kit];
 }
 
 PlayerLogicFn get_change_state_logic(int team, int kit) {
+    kit = role_of(kit);
     if (coach_both_teams) return team1_change_state[kit];
     return (team == 1) ? team1_change_state[kit] : team2_change_state[kit];
 }
@@ -351,6 +366,7 @@ static struct Talents team2_talents[6] = {
 };
 
 struct Talents get_talents(int team, int kit) {
+    kit = role_of(kit);
     if (coach_both_teams) return team1_talents[kit];
     return (team == 1) ? team1_talents[kit] : team2_talents[kit];
 }
@@ -363,27 +379,53 @@ struct Talents get_talents(int team, int kit) {
  *        Keep in mind that the kick-off team's first player will automatically
  *             be placed at the center of the pitch.
  * ------------------------------------------------------------------------- */
-/* Team 1: CF, CM, CB, GK, CB, CM */
+/* Team 1: CF, CM, CB, GK, CB, CM
+ * x is on the default 1000 x 700 layout, y is relative to the centre spot. */
 static struct Vec2 team1_positions[6] = {
-    {300, CENTER_Y},
-    {250, CENTER_Y-150},
-    {200, CENTER_Y-75},
-    {PITCH_X+PLAYER_RADIUS, CENTER_Y},
-    {200, CENTER_Y+75},
-    {250, CENTER_Y+150},
+    {300, 0},
+    {250, -150},
+    {200, -75},
+    {PITCH_MARGIN+PLAYER_RADIUS, 0},
+    {200, +75},
+    {250, +150},
 };
 
 /* Team 2 */
 static struct Vec2 team2_positions[6] = {
-    {750, CENTER_Y},
-    {800, CENTER_Y-150},
-    {850, CENTER_Y-75},
-    {PITCH_X+PITCH_W-PLAYER_RADIUS, CENTER_Y},
-    {850, CENTER_Y+75},
-    {800, CENTER_Y+150},
+    {750, 0},
+    {800, -150},
+    {850, -75},
+    {DEFAULT_SCREEN_WIDTH-PITCH_MARGIN-PLAYER_RADIUS, 0},
+    {850, +75},
+    {800, +150},
 };
 
+/** @brief Vertical gap between a role's first player and each extra one sharing it. */
+#define EXTRA_KIT_SPACING 37.5f
 
 struct Vec2 get_positions(int team, int kit) {
-    return (team == 1) ? team1_positions[kit] : team2_positions[kit];
+    const Field reference = field_default();
+    struct Vec2 position = (team == 1) ? team1_positions[role_of(kit)] : team2_positions[role_of(kit)];
+    if (kit >= 6) {
+        // extra players fan out above and below their role's spot, alternating
+        const int layer = (kit - 6) / EXTRA_ROLE_COUNT + 1;
+        const float offset = EXTRA_KIT_SPACING * (float)((layer + 1) / 2);
+        position.y += (layer % 2) ? offset : -offset;
+    }
+    position.y += reference.center_y;
+    const float top = reference.pitch_y + PLAYER_RADIUS;
+    const float bottom = reference.pitch_y + reference.pitch_h - PLAYER_RADIUS;
+    position.y = position.y < top ? top : (position.y > bottom ? bottom : position.y);
+    return position;
+}
+
+
+/* -------------------------------------------------------------------------
+ * The factory above as a coach table, used whenever a team has no plugin
+ * ------------------------------------------------------------------------- */
+static const struct CoachApi builtin_api = COACH_API_INIT("builtin",
+    get_movement_logic, get_shooting_logic, get_change_state_logic, get_talents, get_positions);
+
+const struct CoachApi *coach_builtin(void) {
+    return &builtin_api;
 }
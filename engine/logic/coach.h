@@ -21,7 +21,8 @@ typedef void (*PlayerLogicFn)(struct Player *self, struct Scene *scene);
  * @name Logic Factory Functions
  * @brief Use these to retrieve the specific function pointer for a player.
  * @param team 1 (Red) or 2 (Blue).
- * @param kit The player's ID number (0 to PLAYER_COUNT-1).
+ * @param kit The player's ID number (0 to the scene's team_size - 1).
+ * Kits past the six in the tables below reuse an outfield role.
  */
 ///@{
 PlayerLogicFn get_movement_logic(int team, int kit);
@@ -35,7 +36,7 @@ PlayerLogicFn get_change_state_logic(int team, int kit);
 struct Talents get_talents(int team, int kit);
 
 /**
- * @brief Returns the position of the player at kick-off.
+ * @brief Returns the position of the player at kick-off, on the default pitch.
  */
 struct Vec2 get_positions(int team, int kit);
 
@@ -0,0 +1,138 @@
+#define _POSIX_C_SOURCE 200809L // mkstemp, st_mtim
+#include "coach_loader.h"
+#include "core/log.h"
+
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** @brief Reads the file state reload detection compares; false if the file is gone. */
+static bool stat_file(const char *path, int64_t *mtime_ns, int64_t *size) {
+    struct stat st;
+    if (stat(path, &st) != 0)
+        return false;
+    *mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+    *size = (int64_t)st.st_size;
+    return true;
+}
+
+/**
+ * @brief Copies `path` to a fresh temporary file and writes its name to `copy`.
+ * dlopen() hands back the already-loaded object for a name it has seen, so
+ * every load goes through a name of its own.
+ */
+static int private_copy(const char *path, char *copy, size_t copy_size) {
+    const char *dir = getenv("TMPDIR");
+    snprintf(copy, copy_size, "%s/soccer_coach_XXXXXX", dir && *dir ? dir : "/tmp");
+    const int fd = mkstemp(copy);
+    if (fd < 0)
+        return -1;
+
+    FILE *in = fopen(path, "rb");
+    FILE *out = fdopen(fd, "wb");
+    int status = (in && out) ? 0 : -1;
+    char buffer[16384];
+    size_t n;
+    while (status == 0 && (n = fread(buffer, 1, sizeof(buffer), in)) > 0)
+        if (fwrite(buffer, 1, n, out) != n)
+            status = -1;
+    if (in && ferror(in))
+        status = -1;
+
+    if (in)
+        fclose(in);
+    if (out) {
+        if (fclose(out) != 0)
+            status = -1;
+    } else {
+        close(fd);
+    }
+    if (status != 0)
+        unlink(copy);
+    return status;
+}
+
+/** @brief Everything a table needs before the engine may call into it. */
+static const char *check_api(const struct CoachApi *api) {
+    if (!api)
+        return "the entry point returned NULL";
+    if (api->abi_version != COACH_ABI_VERSION)
+        return "built for another coach ABI version";
+    if (api->scene_size != sizeof(struct Scene) || api->player_size != sizeof(struct Player))
+        return "built against different engine headers (struct sizes differ)";
+    if (!api->movement_logic || !api->shooting_logic || !api->change_state_logic ||
+        !api->talents || !api->positions)
+        return "its table has empty entries";
+    return NULL;
+}
+
+int coach_plugin_load(struct CoachPlugin *plugin, const char *path) {
+    memset(plugin, 0, sizeof(*plugin));
+    int64_t mtime_ns, size;
+    if (!stat_file(path, &mtime_ns, &size)) {
+        LOG(LOG_ERROR, LOG_ENGINE, "coach %s: no such file", path);
+        return -1;
+    }
+
+    char copy[4096];
+    if (private_copy(path, copy, sizeof(copy)) != 0) {
+        LOG(LOG_ERROR, LOG_ENGINE, "coach %s: could not make a private copy to load", path);
+        return -1;
+    }
+    void *handle = dlopen(copy, RTLD_NOW | RTLD_LOCAL);
+    unlink(copy);   // the mapping stays valid; nothing is left behind in TMPDIR
+    if (!handle) {
+        LOG(LOG_ERROR, LOG_ENGINE, "coach %s: %s", path, dlerror());
+        return -1;
+    }
+
+    // ISO C has no cast from object to function pointer; copy the bytes instead
+    CoachEntryFn entry = NULL;
+    void *symbol = dlsym(handle, COACH_ENTRY_SYMBOL);
+    if (symbol)
+        memcpy(&entry, &symbol, sizeof(entry));
+    const struct CoachApi *api = entry ? entry() : NULL;
+    const char *problem = entry ? check_api(api) : "no " COACH_ENTRY_SYMBOL "() exported";
+    if (problem) {
+        LOG(LOG_ERROR, LOG_ENGINE, "coach %s: %s", path, problem);
+        dlclose(handle);
+        return -1;
+    }
+
+    plugin->path = malloc(strlen(path) + 1);
+    if (!plugin->path) {
+        dlclose(handle);
+        return -1;
+    }
+    strcpy(plugin->path, path);
+    plugin->api = api;
+    plugin->handle = handle;
+    plugin->mtime_ns = mtime_ns;
+    plugin->size = size;
+    LOG(LOG_INFO, LOG_ENGINE, "coach %s: loaded \"%s\"", path, api->name ? api->name : "unnamed");
+    return 0;
+}
+
+void coach_plugin_unload(struct CoachPlugin *plugin) {
+    if (plugin->handle)
+        dlclose(plugin->handle);
+    free(plugin->path);
+    memset(plugin, 0, sizeof(*plugin));
+}
+
+bool coach_plugin_changed(const struct CoachPlugin *plugin) {
+    int64_t mtime_ns, size;
+    if (!stat_file(plugin->path, &mtime_ns, &size))
+        return false;   // mid-rebuild, most likely: wait for the new file to appear
+    return mtime_ns != plugin->mtime_ns || size != plugin->size;
+}
+
+int coach_plugin_reload(struct CoachPlugin *plugin, struct CoachPlugin *fresh) {
+    if (coach_plugin_load(fresh, plugin->path) == 0)
+        return 0;
+    stat_file(plugin->path, &plugin->mtime_ns, &plugin->size);
+    return -1;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file coach_loader.h
+ * @brief Loads coach plugins (see coach_plugin.h) with dlopen, and reloads them when their file changes.
+ * * Every load dlopens a private copy of the file, so the same plugin can be
+ * loaded twice (each copy with its own statics), and a reload can open the
+ * new build before the old one is closed: if the new build is broken the
+ * old one simply stays in use.
+ */
+
+#ifndef ENGINE_LOGIC_COACH_LOADER_H
+#define ENGINE_LOGIC_COACH_LOADER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "logic/coach_plugin.h"
+
+/**
+ * @struct CoachPlugin
+ * @brief One loaded plugin and what its file looked like when it was loaded.
+ */
+struct CoachPlugin {
+    const struct CoachApi *api;
+    void *handle;               /**< dlopen handle of the private copy. */
+    char *path;                 /**< The file as given, watched for changes. */
+    int64_t mtime_ns;
+    int64_t size;
+};
+
+/**
+ * @brief dlopens `path` and checks its ABI version, struct sizes and table.
+ * @return 0 on success, -1 (with the reason logged) otherwise; `plugin` is then left empty.
+ */
+int coach_plugin_load(struct CoachPlugin *plugin, const char *path);
+
+/** @brief Closes the plugin. Nothing may still point into it (see scene_rebind_coach()). */
+void coach_plugin_unload(struct CoachPlugin *plugin);
+
+/** @brief True if the file was modified or replaced since it was (re)loaded (not while it is missing). */
+bool coach_plugin_changed(const struct CoachPlugin *plugin);
+
+/**
+ * @brief Loads the file again into `fresh`, leaving `plugin` as it is.
+ * The caller rebinds everything that uses plugin->api to fresh->api, then
+ * unloads `plugin`. Also records the new file state in `plugin` when the new
+ * build is rejected, so a broken build is not retried until it changes again.
+ * @return 0 on success, -1 if the new build could not be loaded.
+ */
+int coach_plugin_reload(struct CoachPlugin *plugin, struct CoachPlugin *fresh);
+
+#endif /* ENGINE_LOGIC_COACH_LOADER_H */
@@ -0,0 +1,60 @@
+/**
+ * @file coach_plugin.h
+ * @brief The coach ABI: the factory surface of coach.c, as a table a shared object can export.
+ * * A coach plugin is a `.so` built against the engine headers that defines
+ *
+ *     const struct CoachApi *soccer_coach_api(void);
+ *
+ * returning a static table (fill it with COACH_API_INIT so the version and
+ * layout checks are right). The host binary exports the engine, so plugin
+ * code calls rng_float(), the perception queries and so on exactly as
+ * coach.c does. Every function must be reentrant: batch runs call one
+ * plugin from many threads at once, each with its own scene.
+ *
+ * The `team` argument is the side the coach plays this match (1 left,
+ * 2 right), so the same plugin can be paired against any other on either side.
+ * `kit` runs from 0 to the scene's team_size - 1, which is set per match, so
+ * every function must accept any kit >= 0. Logic reads the pitch from
+ * `scene->field`; `positions` are given on field_default() and the engine
+ * scales them onto the match's pitch.
+ */
+
+#ifndef ENGINE_LOGIC_COACH_PLUGIN_H
+#define ENGINE_LOGIC_COACH_PLUGIN_H
+
+#include <stdint.h>
+
+#include "logic/coach.h"
+#include "game/scene.h"
+
+/** @brief Bumped whenever CoachApi or the structs coaches see change incompatibly. */
+#define COACH_ABI_VERSION 2
+
+/** @brief Name of the function every plugin exports. */
+#define COACH_ENTRY_SYMBOL "soccer_coach_api"
+
+struct CoachApi {
+    uint32_t abi_version;       /**< COACH_ABI_VERSION the plugin was built with. */
+    uint32_t scene_size;        /**< sizeof(struct Scene) in the plugin's build. */
+    uint32_t player_size;       /**< sizeof(struct Player) in the plugin's build. */
+    const char *name;           /**< Shown in logs and results. */
+
+    PlayerLogicFn (*movement_logic)(int team, int kit);
+    PlayerLogicFn (*shooting_logic)(int team, int kit);
+    PlayerLogicFn (*change_state_logic)(int team, int kit);
+    struct Talents (*talents)(int team, int kit);
+    struct Vec2 (*positions)(int team, int kit);
+};
+
+/** @brief Initializer for a plugin's table, e.g. `static const struct CoachApi api = COACH_API_INIT("mine", move, shoot, state, talents, positions);` */
+#define COACH_API_INIT(name, movement, shooting, change_state, talents, positions)              \
+    { COACH_ABI_VERSION, (uint32_t)sizeof(struct Scene), (uint32_t)sizeof(struct Player), (name), \
+      (movement), (shooting), (change_state), (talents), (positions) }
+
+/** @brief The type of the plugin entry point. */
+typedef const struct CoachApi *(*CoachEntryFn)(void);
+
+/** @brief The coach compiled into the engine (coach.c). */
+const struct CoachApi *coach_builtin(void);
+
+#endif /* ENGINE_LOGIC_COACH_PLUGIN_H */
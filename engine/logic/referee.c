@@ -5,6 +5,8 @@
 #include "referee.h"
 #include "game/possession.h"
 #include "entities/team.h"
+#include "core/log.h"
+#include "core/profile.h"
 
 /**
  * @brief Determines whether a goal has been scored.
@@ -18,30 +20,27 @@
  * - The ball must be vertically contained between the goal posts.
  * - The right goal corresponds to Team 1 scoring.
  * - The left goal corresponds to Team 2 scoring.
+ * - It has no side effects, so vectorized drivers can evaluate it per lane.
  * @return
  * - 1 if Team 1 scores,
  * - 2 if Team 2 scores,
  * - 0 if no goal has occurred.
  */
-static int goal(float x, float y) {
-    float left_line = PITCH_X;
-    float right_line = PITCH_X + PITCH_W;
-    float goal_top = CENTER_Y - GOAL_HEIGHT / 2.0f;
-    float goal_bottom = CENTER_Y + GOAL_HEIGHT / 2.0f;
+int referee_goal(const Field* field, float x, float y) {
+    float left_line = field->pitch_x;
+    float right_line = field->pitch_x + field->pitch_w;
+    float goal_top = field->center_y - field->goal_height / 2.0f;
+    float goal_bottom = field->center_y + field->goal_height / 2.0f;
 
     bool inside_goal_mouth =
         (y - BALL_RADIUS >= goal_top) &&
         (y + BALL_RADIUS <= goal_bottom);
 
-    if (inside_goal_mouth && (x - BALL_RADIUS > right_line)) {
-        printf("GOAL! Right net hit at x:%.2f, y=%.2f\n", x, y);
+    if (inside_goal_mouth && (x - BALL_RADIUS > right_line))
         return 1;
-    }
 
-    if (inside_goal_mouth && (x + BALL_RADIUS < left_line)) {
-        printf("GOAL! Left net hit at x:%.2f, y=%.2f\n", x, y);
+    if (inside_goal_mouth && (x + BALL_RADIUS < left_line))
         return 2;
-    }
 
     return 0;
 }
@@ -56,25 +55,67 @@ static int goal(float x, float y) {
  * - Use BALL_RADIUS to ensure the whole ball has crossed a boundary.
  * - All four pitch sides (left, right, top, bottom) must be considered.
  * - This function does not handle goals; goal detection is performed separately.
+ * - Like referee_goal(), it only inspects the position.
  * @return true if the ball is fully out of bounds, false otherwise.
  */
-static bool out(float x, float y) {
-    float left_line = PITCH_X;
-    float right_line = PITCH_X + PITCH_W;
-    float top_line = PITCH_Y;
-    float bottom_line = PITCH_Y + PITCH_H;
+bool referee_out(const Field* field, float x, float y) {
+    float left_line = field->pitch_x;
+    float right_line = field->pitch_x + field->pitch_w;
+    float top_line = field->pitch_y;
+    float bottom_line = field->pitch_y + field->pitch_h;
 
     bool out_left = x + BALL_RADIUS < left_line;
     bool out_right = x - BALL_RADIUS > right_line;
     bool out_top = y + BALL_RADIUS < top_line;
     bool out_bottom = y - BALL_RADIUS > bottom_line;
 
-    if (out_left || out_right || out_top || out_bottom) {
-        printf("Ball is out: x=%.2f, y=%.2f\n", x, y);
-        return true;
-    }
+    return out_left || out_right || out_top || out_bottom;
+}
 
-    return false;
+/**
+ * @brief Swept version of referee_goal() and referee_out().
+ *
+ * Each line the end point lies past was crossed on the way, at the fraction
+ * where the ball's far edge passed it. Only the goal line crossings need
+ * that fraction for something: where the ball was then decides the goal.
+ * A ball that first crossed a touchline cannot be inside a goal mouth when
+ * it crosses the goal line, so the mouth test also sorts out corners.
+ * The fractions are clamped to [0, 1]: rounding must not move a crossing
+ * out of the tick, and a ball that started past a line (a division by zero
+ * when it stood still) crossed it at 0.
+ */
+float referee_sweep(const Field* field, float x0, float y0, float x1, float y1, int* scored, bool* is_out) {
+    float left_line = field->pitch_x;
+    float right_line = field->pitch_x + field->pitch_w;
+    float top_line = field->pitch_y;
+    float bottom_line = field->pitch_y + field->pitch_h;
+    float goal_top = field->center_y - field->goal_height / 2.0f;
+    float goal_bottom = field->center_y + field->goal_height / 2.0f;
+    const float dx = x1 - x0;
+    const float dy = y1 - y0;
+    float first = 2.0f;
+
+    *scored = 0;
+    if (x1 - BALL_RADIUS > right_line || x1 + BALL_RADIUS < left_line) {
+        const bool right = x1 - BALL_RADIUS > right_line;
+        const float line = right ? right_line + BALL_RADIUS : left_line - BALL_RADIUS;
+        float s = (line - x0) / dx;
+        s = (s > 0.0f) ? s : 0.0f;
+        s = (s < 1.0f) ? s : 1.0f;
+        const float y = y0 + dy * s;
+        if ((y - BALL_RADIUS >= goal_top) && (y + BALL_RADIUS <= goal_bottom))
+            *scored = right ? 1 : 2;
+        first = s;
+    }
+    if (y1 - BALL_RADIUS > bottom_line || y1 + BALL_RADIUS < top_line) {
+        const float line = (y1 - BALL_RADIUS > bottom_line) ? bottom_line + BALL_RADIUS : top_line - BALL_RADIUS;
+        float s = (line - y0) / dy;
+        s = (s > 0.0f) ? s : 0.0f;
+        s = (s < 1.0f) ? s : 1.0f;
+        first = (s < first) ? s : first;
+    }
+    *is_out = first < 2.0f;
+    return first;
 }
 
 /**
@@ -100,21 +141,45 @@ static bool out(float x, float y) {
  * - 0 if no event occurred.
  */
 int referee(struct Scene* scene) {
+    PROFILE_BEGIN(PROFILE_REFEREE);
+    int scored;
+    bool is_out;
+    referee_sweep(&scene->field, scene->ball_from.x, scene->ball_from.y, scene->ball_to.x, scene->ball_to.y,
+                  &scored, &is_out);
+
+    const int call = referee_decide(scene, scored, is_out);
+    PROFILE_END(PROFILE_REFEREE);
+    return call;
+}
+
+/**
+ * @brief Turns the raw goal/out checks into a referee call.
+ *
+ * Reports the event, updates the score and returns the RefereeCode.
+ * A goal takes precedence over the ball being out.
+ *
+ * @param scored 1 or 2 for the scoring team (see referee_goal()), 0 otherwise.
+ * @param is_out Result of referee_out() for the same position.
+ */
+int referee_decide(struct Scene* scene, int scored, bool is_out) {
     float x = scene->ball->position.x;
     float y = scene->ball->position.y;
 
-    int scored = goal(x, y);
     if (scored == 1) {
+        LOG(LOG_INFO, LOG_MATCH, "GOAL! Right net hit at x:%.2f, y=%.2f", x, y);
         scene->first_team->score += 1;
         return GOAL;
     }
     if (scored == 2) {
+        LOG(LOG_INFO, LOG_MATCH, "GOAL! Left net hit at x:%.2f, y=%.2f", x, y);
         scene->second_team->score += 1;
         return GOAL;
     }
 
-    if (out(x, y))
+    if (is_out) {
+        LOG(LOG_INFO, LOG_MATCH, "Ball is out: x=%.2f, y=%.2f", x, y);
         return OUT;
+    }
 
     return PLAY_ON;
 }
@@ -132,9 +197,11 @@ int referee(struct Scene* scene) {
  * - The sum of all skills must not exceed MAX_TALENT_PER_PLAYER.
  * - Invalid configurations should be reported as errors.
  *
- * @param talents The talent structure to validate.
+ * @param player The player whose talents are validated.
+ * @param scene  The scene whose violation tallies count the breach.
  */
-void verify_talents(struct Talents talents) {
+void verify_talents(struct Player *player, struct Scene *scene) {
+    const struct Talents talents = player->talents;
     int sum = talents.defence + talents.agility + talents.dribbling + talents.shooting;
 
     bool invalid =
@@ -145,8 +212,14 @@ void verify_talents(struct Talents talents) {
         sum > MAX_TALENT_PER_PLAYER;
 
     if (invalid) {
-        printf("ERROR: Invalid talents! Values: defence=%d, agility=%d, dribbling=%d, shooting=%d, sum=%d\n",
+        LOG(LOG_ERROR, LOG_RULES, "Invalid talents! Values: defence=%d, agility=%d, dribbling=%d, shooting=%d, sum=%d",
             talents.defence, talents.agility, talents.dribbling, talents.shooting, sum);
+        // excess: points over the budget plus every point outside a skill's range
+        const int skills[4] = { talents.defence, talents.agility, talents.dribbling, talents.shooting };
+        int excess = sum > MAX_TALENT_PER_PLAYER ? sum - MAX_TALENT_PER_PLAYER : 0;
+        for (int i = 0; i < 4; i++)
+            excess += skills[i] < 1 ? 1 - skills[i] : skills[i] > MAX_TALENT_PER_SKILL ? skills[i] - MAX_TALENT_PER_SKILL : 0;
+        violations_add(&scene->violations, roster_handle(&scene->roster, player), RULE_TALENTS, (float)excess);
     }
 }
 
@@ -167,8 +240,9 @@ void verify_talents(struct Talents talents) {
  */
 void verify_state(struct Player *player, struct Scene *scene) {
     if (scene->ball->possessor != player && player->state == SHOOTING) {
-        printf(" ERROR: the ball is not yours, you can't shoot! (team %d, player %d)\n",
+        LOG(LOG_WARN, LOG_RULES, "the ball is not yours, you can't shoot! (team %d, player %d)",
                 player->team, player->kit);
+        violations_add(&scene->violations, roster_handle(&scene->roster, player), RULE_SHOOT_WITHOUT_BALL, 0.0f);
         player->state = MOVING;
     }
 }
@@ -185,17 +259,20 @@ void verify_state(struct Player *player, struct Scene *scene) {
  * - If a component exceeds the limit, it must be clamped.
  *
  * @param player Pointer to the player whose movement is being verified.
+ * @param scene  The scene whose violation tallies count the breach.
  */
-void verify_movement(struct Player *player) {
+void verify_movement(struct Player *player, struct Scene *scene) {
     float max = ((float)player->talents.agility / MAX_TALENT_PER_SKILL) * MAX_PLAYER_VELOCITY;
 
     if (fabsf(player->velocity.x) > max) {
-        printf(" ERROR: Demanding to run too fast in dimension x! (team %d, player %d)\n", player->team, player->kit);
+        LOG(LOG_WARN, LOG_RULES, "Demanding to run too fast in dimension x! (team %d, player %d)", player->team, player->kit);
+        violations_add(&scene->violations, roster_handle(&scene->roster, player), RULE_RUN_SPEED_X, fabsf(player->velocity.x) - max);
         player->velocity.x = (player->velocity.x > 0.0f) ? max : -max;
     }
 
     if (fabsf(player->velocity.y) > max) {
-        printf(" ERROR: Demanding to run too fast in dimension y! (team %d, player %d)\n", player->team, player->kit);
+        LOG(LOG_WARN, LOG_RULES, "Demanding to run too fast in dimension y! (team %d, player %d)", player->team, player->kit);
+        violations_add(&scene->violations, roster_handle(&scene->roster, player), RULE_RUN_SPEED_Y, fabsf(player->velocity.y) - max);
         player->velocity.y = (player->velocity.y > 0.0f) ? max : -max;
     }
 }
@@ -215,8 +292,9 @@ void verify_movement(struct Player *player) {
  *
  * @param ball    Pointer to the ball being shot.
  * @param kickoff True if the shot occurs during kickoff.
+ * @param scene   The scene whose violation tallies count the breach.
  */
-void verify_shoot(struct Ball *ball, bool kickoff) {
+void verify_shoot(struct Ball *ball, bool kickoff, struct Scene *scene) {
     struct Player *player = ball->possessor;
     if (!player)
         return;
@@ -224,19 +302,23 @@ void verify_shoot(struct Ball *ball, bool kickoff) {
     float max = MAX_BALL_VELOCITY * ((float)player->talents.shooting / MAX_TALENT_PER_SKILL);
 
     if (fabsf(ball->velocity.x) > max) {
-        printf(" ERROR: Demanding to shoot too fast in dimension x! (team %d, player %d)\n", player->team, player->kit);
+        LOG(LOG_WARN, LOG_RULES, "Demanding to shoot too fast in dimension x! (team %d, player %d)", player->team, player->kit);
+        violations_add(&scene->violations, roster_handle(&scene->roster, player), RULE_SHOOT_SPEED_X, fabsf(ball->velocity.x) - max);
         ball->velocity.x = (ball->velocity.x > 0.0f) ? max : -max;
     }
 
     if (fabsf(ball->velocity.y) > max) {
-        printf(" ERROR: Demanding to shoot too fast in dimension y! (team %d, player %d)\n", player->team, player->kit);
+        LOG(LOG_WARN, LOG_RULES, "Demanding to shoot too fast in dimension y! (team %d, player %d)", player->team, player->kit);
+        violations_add(&scene->violations, roster_handle(&scene->roster, player), RULE_SHOOT_SPEED_Y, fabsf(ball->velocity.y) - max);
         ball->velocity.y = (ball->velocity.y > 0.0f) ? max : -max;
     }
 
     if (kickoff) {
         bool invalid_team1 = (player->team == 1) && (ball->velocity.x > 0.0f);
         bool invalid_team2 = (player->team == 2) && (ball->velocity.x < 0.0f);
-        if (invalid_team1 || invalid_team2)
-            printf(" ERROR: You must pass to your own half! (team %d, player %d)\n", player->team, player->kit);
+        if (invalid_team1 || invalid_team2) {
+            LOG(LOG_WARN, LOG_RULES, "You must pass to your own half! (team %d, player %d)", player->team, player->kit);
+            violations_add(&scene->violations, roster_handle(&scene->roster, player), RULE_KICKOFF_HALF, fabsf(ball->velocity.x));
+        }
     }
 }
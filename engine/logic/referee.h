@@ -25,15 +25,50 @@ enum RefereeCode {
 
 /**
  * @brief The main rule-checker called every frame.
- * Checks for goals, out-of-bounds, and ball possession updates.
+ * Checks for goals and out-of-bounds along the path the ball took in the
+ * last move_scene() (see referee_sweep()).
  */
 int referee(struct Scene* scene);
 
+/**
+ * @brief Side-effect free goal check for a ball centred at (x, y) on `field`.
+ * @return 1 if Team 1 scored, 2 if Team 2 scored, 0 otherwise.
+ */
+int referee_goal(const Field* field, float x, float y);
+
+/**
+ * @brief Side-effect free check: is a ball centred at (x, y) fully off `field`'s pitch?
+ */
+bool referee_out(const Field* field, float x, float y);
+
+/**
+ * @brief Swept goal/out check for a ball that moved in a straight line from (x0, y0) to (x1, y1).
+ * * Moving in a straight line, the ball is fully off the pitch somewhere on
+ * the way exactly when it is at the end, so `is_out` is referee_out() of the
+ * end point. A goal is decided at the moment the ball has fully crossed a
+ * goal line: it must be inside the goal mouth then, wherever it ends up.
+ * Big timesteps can carry the ball across a goal line and past the posts'
+ * height within one tick, which sampling the end point alone gets wrong.
+ * @param scored Set to 1 if Team 1 scored, 2 if Team 2 scored, 0 otherwise.
+ * @param is_out Set to true if the ball ends fully off the pitch.
+ * @return Fraction of the way at which the ball first lay fully off the
+ * pitch, in [0, 1], or 2 if it never did.
+ */
+float referee_sweep(const Field* field, float x0, float y0, float x1, float y1, int* scored, bool* is_out);
+
+/**
+ * @brief Reports and scores the outcome of referee_sweep() (or referee_goal()/referee_out()).
+ * referee() is referee_decide() of referee_sweep() over the ball's last path.
+ * @return GOAL, OUT or PLAY_ON.
+ */
+int referee_decide(struct Scene* scene, int scored, bool is_out);
+
 /**
  * @brief Validates that a player's skills are within the allowed budget.
  * Prevents "Super-Players" that break the game balance.
+ * Every rule check below also counts its corrections in scene->violations.
  */
-void verify_talents(struct Talents talents);
+void verify_talents(struct Player *player, struct Scene *scene);
 
 /**
  * @brief Corrects illegal player states (e.g., if a player tries to shoot 
@@ -45,7 +80,7 @@ void verify_state(struct Player *player, struct Scene *scene);
  * @brief Enforces speed limits. If a player's velocity exceeds their Agility talent,
  * this function caps it at the maximum allowed.
  */
-void verify_movement(struct Player *player);
+void verify_movement(struct Player *player, struct Scene *scene);
 
 /**
  * @brief Enforces physics limits on the ball after a kick.
@@ -53,6 +88,6 @@ void verify_movement(struct Player *player);
  * player's 'Shooting' talent allows. Also checks player passes to its
  * own half at restart kick-off.
  */
-void verify_shoot(struct Ball *ball, bool kickoff);
+void verify_shoot(struct Ball *ball, bool kickoff, struct Scene *scene);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "violations.h"
+
+static const char *const rule_names[RULE_COUNT] = {
+    "talents",
+    "shoot_without_ball",
+    "run_speed_x",
+    "run_speed_y",
+    "shoot_speed_x",
+    "shoot_speed_y",
+    "kickoff_half",
+};
+
+const char *rule_name(enum Rule rule) {
+    return ((int)rule >= 0 && (int)rule < RULE_COUNT) ? rule_names[rule] : "unknown";
+}
+
+int violations_init(struct Violations *violations, int team_size) {
+    violations->players = calloc((size_t)team_size * 2, sizeof(*violations->players));
+    violations->team_size = violations->players ? team_size : 0;
+    return violations->players ? 0 : -1;
+}
+
+void violations_free(struct Violations *violations) {
+    free(violations->players);
+    violations->players = NULL;
+    violations->team_size = 0;
+}
+
+bool violations_equal(const struct Violations *a, const struct Violations *b) {
+    if (a->team_size != b->team_size)
+        return false;
+    return a->team_size == 0 ||
+           memcmp(a->players, b->players, sizeof(*a->players) * 2 * (size_t)a->team_size) == 0;
+}
+
+void violations_write_csv_header(FILE *out) {
+    fprintf(out, "seed,stream,team,kit,rule,count,total_excess,max_excess\n");
+}
+
+void violations_write_csv(FILE *out, const struct Violations *violations, uint64_t seed, uint64_t stream) {
+    const int team_size = violations->team_size;
+    for (int p = 0; p < 2 * team_size; p++) {
+        for (int r = 0; r < RULE_COUNT; r++) {
+            const struct RuleTally *tally = &violations->players[p][r];
+            if (!tally->count)
+                continue;
+            fprintf(out, "%" PRIu64 ",%" PRIu64 ",%d,%d,%s,%" PRIu32 ",%.3f,%.3f\n",
+                    seed, stream, p / team_size + 1, p % team_size, rule_names[r],
+                    tally->count, tally->total_excess, tally->max_excess);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/**
+ * @file violations.h
+ * @brief Per-player tallies of the referee's rule corrections.
+ * * Every verify_*() correction in referee.c is counted against the player it
+ * concerns, together with how far past the limit the coach asked to go. The
+ * tallies live in the Scene, cost a few adds per correction, and are written
+ * at match end as CSV rows that can be aggregated without parsing any logs.
+ */
+
+#ifndef ENGINE_LOGIC_VIOLATIONS_H
+#define ENGINE_LOGIC_VIOLATIONS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @enum Rule
+ * @brief The rules the referee enforces, one counter each per player.
+ */
+enum Rule {
+    RULE_TALENTS,           /**< Talent budget broken; excess in talent points. */
+    RULE_SHOOT_WITHOUT_BALL,/**< SHOOTING without the ball; no magnitude. */
+    RULE_RUN_SPEED_X,       /**< Excess in px/s over the agility limit. */
+    RULE_RUN_SPEED_Y,
+    RULE_SHOOT_SPEED_X,     /**< Excess in px/s over the shooting limit. */
+    RULE_SHOOT_SPEED_Y,
+    RULE_KICKOFF_HALF,      /**< Kick-off played into the other half; magnitude is |vx|. */
+    RULE_COUNT
+};
+
+/**
+ * @struct RuleTally
+ * @brief How often one player broke one rule, and by how much.
+ */
+struct RuleTally {
+    uint32_t count;
+    float total_excess;
+    float max_excess;
+};
+
+/**
+ * @struct Violations
+ * @brief Tallies for every player, indexed like the roster (team 1 kits, then team 2 kits).
+ */
+struct Violations {
+    int team_size;
+    struct RuleTally (*players)[RULE_COUNT];   /**< 2 * team_size rows, all zero to start with. */
+};
+
+/**
+ * @brief Allocates zeroed tallies for two teams of `team_size` players.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int violations_init(struct Violations *violations, int team_size);
+
+/** @brief Frees the tallies; freeing an empty (zeroed) Violations is a no-op. */
+void violations_free(struct Violations *violations);
+
+/** @brief True if both hold the same team size and identical tallies. */
+bool violations_equal(const struct Violations *a, const struct Violations *b);
+
+/** @brief Counts one violation of `rule` by roster index `player`. */
+static inline void violations_add(struct Violations *violations, int player, enum Rule rule, float excess) {
+    struct RuleTally *tally = &violations->players[player][rule];
+    tally->count++;
+    tally->total_excess += excess;
+    if (excess > tally->max_excess)
+        tally->max_excess = excess;
+}
+
+/** @brief Short snake_case name of a rule, as used in the CSV. */
+const char *rule_name(enum Rule rule);
+
+void violations_write_csv_header(FILE *out);
+
+/**
+ * @brief One row per player and rule that was broken at least once:
+ * seed,stream,team,kit,rule,count,total_excess,max_excess.
+ */
+void violations_write_csv(FILE *out, const struct Violations *violations, uint64_t seed, uint64_t stream);
+
+#endif
@@ -0,0 +1,263 @@
+/**
+ * @file format.h
+ * @brief On-disk layout of a recorded match (.srpl file).
+ * * A file is a fixed header, one ReplayEntityInfo per player, the ball's
+ * kick-off position, the pitch it was played on, a byte stream with one
+ * record per tick (and a keyframe every keyframe_interval ticks), then the index:
+ *
+ *   [ReplayHeader][ReplayEntityInfo x player_count][ball x,y][ReplayField]
+ *   [tick records and keyframes...][REPLAY_TAG_END trailer]
+ *   [ReplayKeyframe x keyframe_count][ReplayEvent x event_count][ReplayFooter]
+ *
+ * The footer sits at the very end of the file, so tools can list keyframes and
+ * events (goals, outs, possession changes) without decoding a single tick, and
+ * a player can seek by loading the nearest keyframe before the target tick.
+ *
+ * Positions and velocities are stored as integers in units of pos_quantum /
+ * vel_quantum pixels. Every tick the decoder predicts each entity from its
+ * previous state, and the stream only carries the residual when the real value
+ * is further than the dead-band from that prediction:
+ *  - a player's velocity is predicted to repeat the one from two ticks ago
+ *    (steering toward a target that is already reached alternates direction
+ *    every tick, and a steady run repeats either way); so is a held ball's,
+ *    which follows whoever won the last tackle;
+ *  - a free ball's velocity is predicted to decay by ball_decay per tick;
+ *  - while the match is running, position += velocity * dt, carried with
+ *    REPLAY_SUBUNIT_BITS of fraction so rounding never drifts;
+ *  - the ball holder is predicted to be the one of two ticks ago (a tackle
+ *    duel hands the ball back and forth every tick).
+ * Ticks where nothing leaves its dead-band are collapsed into one run-length
+ * record.
+ *
+ * The header, entity table, keyframe and event tables, footer and the
+ * remaining-time field of tick records are stored in the byte order of the
+ * host that wrote them, naturally aligned, so they can be read in place from
+ * an mmap'd file; the varints and bytes of the tick stream are byte-order
+ * neutral. Readers reject a file whose version reads byte-swapped
+ * (replay_version_swapped()) instead of misreading it.
+ */
+
+#ifndef ENGINE_REPLAY_FORMAT_H
+#define ENGINE_REPLAY_FORMAT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define REPLAY_MAGIC "SRPL"
+#define REPLAY_INDEX_MAGIC "SIDX"
+/**
+ * @brief Version 2 added keyframes and the index, version 3 the ReplayField.
+ * Older files are still read: version 1 sequentially, both on the default pitch.
+ */
+#define REPLAY_VERSION 3
+
+/**
+ * @brief Whether a stored version field reads byte-swapped, i.e. the file was
+ * written on a host of the other byte order (versions stay below 256).
+ */
+static inline bool replay_version_swapped(uint16_t version) {
+    return version > 0xff && (version & 0xff) == 0;
+}
+
+/** @brief Largest entity count (players + ball) a reader has to support. */
+#define REPLAY_MAX_ENTITIES 64
+/** @brief Largest team size a recording can hold (both teams and the ball fit in REPLAY_MAX_ENTITIES). */
+#define REPLAY_MAX_TEAM_SIZE ((REPLAY_MAX_ENTITIES - 1) / 2)
+
+/** @brief Default quantization: 1/8 px positions, 1/4 px/s velocities. */
+#define REPLAY_POS_QUANTUM 0.125f
+#define REPLAY_VEL_QUANTUM 0.25f
+/** @brief Default dead-bands, in quanta: 0.5 px and 2 px/s. */
+#define REPLAY_POS_DEADBAND 4
+#define REPLAY_VEL_DEADBAND 8
+
+/** @brief Default game time between keyframes. */
+#define REPLAY_KEYFRAME_SECONDS 10.0f
+
+/** @brief A new player counts as a possession change once nobody else touches the ball for this long. */
+#define REPLAY_POSSESSION_SECONDS 0.25f
+
+/**
+ * @struct ReplayHeader
+ * @brief First 64 bytes of every recording.
+ */
+struct ReplayHeader {
+    char magic[4];              /**< REPLAY_MAGIC, not NUL-terminated. */
+    uint16_t version;           /**< REPLAY_VERSION. */
+    uint16_t player_count;      /**< Players of both teams; entity player_count is the ball. */
+    uint32_t data_offset;       /**< File offset of the first tick record. */
+    uint32_t keyframe_interval; /**< Ticks between keyframes; 0 in version 1 files. */
+    uint64_t seed;              /**< MatchSpec seed. */
+    uint64_t stream;            /**< MatchSpec stream. */
+    float tick_rate;            /**< Ticks per game second; dt = 1 / tick_rate. */
+    float match_length;         /**< Match length in game seconds. */
+    float pos_quantum;          /**< Pixels per stored position unit. */
+    float vel_quantum;          /**< Pixels per second per stored velocity unit. */
+    uint16_t pos_deadband;      /**< Largest position error (in units) left uncorrected. */
+    uint16_t vel_deadband;      /**< Largest velocity error (in units) left uncorrected. */
+    uint8_t initial_state;      /**< GameState right after init_scene(). */
+    uint8_t initial_possessor;  /**< Player index holding the ball, or REPLAY_NO_POSSESSOR. */
+    uint16_t reserved1;
+    float ball_decay;           /**< Ball velocity factor per running tick (friction). */
+    uint32_t reserved2;
+};
+
+/**
+ * @struct ReplayEntityInfo
+ * @brief Who a player is and where they kick off, one per roster index.
+ */
+struct ReplayEntityInfo {
+    uint8_t team;               /**< 1 or 2. */
+    uint8_t kit;
+    uint8_t talents[4];         /**< defence, agility, dribbling, shooting. */
+    uint16_t reserved;
+    int32_t x;                  /**< Kick-off position, in pos_quantum units. */
+    int32_t y;
+};
+
+/**
+ * @struct ReplayField
+ * @brief The scene's Field, member for member (version 3 and later).
+ */
+struct ReplayField {
+    float width;
+    float height;
+    float pitch_x;
+    float pitch_y;
+    float pitch_w;
+    float pitch_h;
+    float center_x;
+    float center_y;
+    float goal_width;
+    float goal_height;
+};
+
+/** @brief Possessor byte meaning "nobody holds the ball". */
+#define REPLAY_NO_POSSESSOR 0xFF
+
+/**
+ * @name Tick record tags
+ * @brief The first byte of every record. A non-zero tag below REPLAY_TAG_END is
+ * one tick whose payload is the OR of the REPLAY_HAS_* sections, in bit order.
+ */
+///@{
+#define REPLAY_TAG_SKIP 0x00        /**< varint n: n ticks that only follow the prediction. */
+#define REPLAY_HAS_MOTION 0x01      /**< varint entity mask, packed channel nibbles, zigzag varint residuals. */
+#define REPLAY_HAS_STATE 0x02       /**< u8 GameState. */
+#define REPLAY_HAS_POSSESSOR 0x04   /**< u8 player index or REPLAY_NO_POSSESSOR, when not the holder of two ticks ago. */
+#define REPLAY_HAS_EVENT 0x08       /**< u8 RefereeCode, varint first score, varint second score. */
+#define REPLAY_TAG_KEYFRAME 0xFE    /**< Full decoder state after a tick; carries no time (see below). */
+#define REPLAY_TAG_END 0xFF         /**< varint tick count, varint first score, varint second score. */
+///@}
+
+/*
+ * Keyframe payload: varint tick, u8 state, u8 possessor, u8 possessor of the
+ * tick before, varint first score, varint second score, u32 remaining-time
+ * float bits, then per entity zigzag varints of x, y (in sub-units), vx, vy
+ * and the two velocities of the tick before. Loading it gives a decoder exactly
+ * the state it would have reached by decoding every tick up to there.
+ */
+
+/**
+ * @struct ReplayKeyframe
+ * @brief Index entry: the keyframe written after `tick` starts at `offset`.
+ */
+struct ReplayKeyframe {
+    uint32_t tick;
+    uint32_t offset;
+};
+
+/** @brief ReplayEvent kinds; GOAL and OUT match the RefereeCode values. */
+enum ReplayEventKind {
+    REPLAY_EVENT_GOAL = 1,
+    REPLAY_EVENT_OUT = 2,
+    REPLAY_EVENT_POSSESSION = 3
+};
+
+/**
+ * @struct ReplayEvent
+ * @brief Index entry for something worth jumping to.
+ */
+struct ReplayEvent {
+    uint32_t tick;              /**< Tick the event happened on (a possession starts there). */
+    uint8_t kind;               /**< ReplayEventKind. */
+    uint8_t subject;            /**< GOAL: scoring team; OUT: team that last touched; POSSESSION: player index. */
+    uint16_t reserved;
+    uint16_t first_score;       /**< Score when the event was indexed (a possession: REPLAY_POSSESSION_SECONDS later). */
+    uint16_t second_score;
+};
+
+/**
+ * @struct ReplayFooter
+ * @brief Last 24 bytes of a version 2 file; the tables it points at are 4-byte aligned.
+ */
+struct ReplayFooter {
+    uint32_t keyframe_offset;
+    uint32_t keyframe_count;
+    uint32_t event_offset;
+    uint32_t event_count;
+    uint32_t ticks;             /**< Ticks in the match. */
+    char magic[4];              /**< REPLAY_INDEX_MAGIC. */
+};
+
+/**
+ * @name Motion channels
+ * @brief Bits of the per-entity channel nibble. The nibbles of the entities in
+ * the mask are packed two per byte (first entity in the low nibble); then come
+ * the residuals, entity by entity, in channel bit order. Velocities come first
+ * because the position prediction uses the new velocity.
+ */
+///@{
+#define REPLAY_CH_VX 0x01
+#define REPLAY_CH_VY 0x02
+#define REPLAY_CH_PX 0x04
+#define REPLAY_CH_PY 0x08
+///@}
+
+/** @brief Maps signed residuals to unsigned so small magnitudes get short varints. */
+static inline uint32_t replay_zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t replay_unzigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+/** @brief Fraction bits of the predicted positions both sides keep (not stored in the file). */
+#define REPLAY_SUBUNIT_BITS 8
+#define REPLAY_SUBUNIT (1 << REPLAY_SUBUNIT_BITS)
+
+/** @brief Rounds half away from zero, the same way on every platform. */
+static inline int32_t replay_round(float value) {
+    return (int32_t)(value < 0.0f ? value - 0.5f : value + 0.5f);
+}
+
+/** @brief Sub-unit position to whole pos_quantum units, rounding half away from zero. */
+static inline int32_t replay_units(int32_t subunits) {
+    return (subunits >= 0 ? subunits + REPLAY_SUBUNIT / 2 : subunits - REPLAY_SUBUNIT / 2) / REPLAY_SUBUNIT;
+}
+
+/**
+ * @brief The velocity prediction both sides use (see the file comment).
+ * @param last        Reconstructed velocity of the previous tick.
+ * @param before_last Reconstructed velocity of the tick before that.
+ * @param free_ball   The entity is the ball and nobody held it after the previous tick.
+ */
+static inline int32_t replay_predict_velocity(int32_t last, int32_t before_last, bool free_ball,
+                                              bool running, float ball_decay) {
+    if (!free_ball)
+        return before_last;
+    return running ? replay_round((float)last * ball_decay) : last;
+}
+
+/**
+ * @brief The position prediction both sides use: advanced by one tick of velocity.
+ * Kept in one place so encoder and decoder round identically.
+ * @param subunits            Position in pos_quantum / REPLAY_SUBUNIT units.
+ * @param vel_to_pos_per_tick Velocity units to position units per tick.
+ */
+static inline int32_t replay_predict(int32_t subunits, int32_t vel, float vel_to_pos_per_tick) {
+    return subunits + replay_round((float)vel * vel_to_pos_per_tick * (float)REPLAY_SUBUNIT);
+}
+
+#endif /* ENGINE_REPLAY_FORMAT_H */
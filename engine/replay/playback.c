@@ -0,0 +1,97 @@
+#include "playback.h"
+#include "entities/ball.h"
+#include "entities/team.h"
+
+#include <math.h>
+
+/** @brief Copies a decoded frame into the scene the renderer draws. */
+static void apply_frame(const struct ReplayFrame* frame, Scene* scene) {
+    const int players = frame->entities - 1;
+    for (int i = 0; i < players; i++) {
+        struct Player* p = &scene->roster.views[i];
+        p->position.x = frame->x[i];
+        p->position.y = frame->y[i];
+        p->velocity.x = frame->vx[i];
+        p->velocity.y = frame->vy[i];
+    }
+    struct Ball* ball = scene->ball;
+    ball->position.x = frame->x[players];
+    ball->position.y = frame->y[players];
+    ball->velocity.x = frame->vx[players];
+    ball->velocity.y = frame->vy[players];
+    ball->possessor = frame->possessor >= 0 ? &scene->roster.views[frame->possessor] : NULL;
+    scene->state = (GameState)frame->state;
+    scene->remaining_time = frame->remaining_time;
+    scene->first_team->score = frame->first_score;
+    scene->second_team->score = frame->second_score;
+}
+
+int playback_open(struct Playback* playback, const char* path, Scene* scene) {
+    if (replay_open(&playback->replay, path) != 0)
+        return -1;
+    const struct ReplayHeader* header = playback->replay.header;
+
+    rng_seed(&scene->rng, header->seed, header->stream);
+    scene->team_size = header->player_count / 2;
+    const struct ReplayField* field = playback->replay.field;
+    if (field) {
+        scene->field = (Field){
+            field->width, field->height, field->pitch_x, field->pitch_y, field->pitch_w, field->pitch_h,
+            field->center_x, field->center_y, field->goal_width, field->goal_height
+        };
+    } else {
+        scene->field = field_default();
+    }
+    if (init_scene(scene) != 0) {
+        replay_close(&playback->replay);
+        return -1;
+    }
+    if (scene->roster.count != header->player_count) {
+        destroy_scene(scene);
+        replay_close(&playback->replay);
+        return -1;
+    }
+
+    replay_rewind(&playback->cursor, &playback->replay, &playback->frame);
+    playback->ended = false;
+    apply_frame(&playback->frame, scene);
+    return 0;
+}
+
+void playback_close(struct Playback* playback) {
+    replay_close(&playback->replay);
+}
+
+int playback_step(struct Playback* playback, Scene* scene) {
+    if (playback->ended)
+        return 0;
+    const int status = replay_next(&playback->cursor, &playback->frame);
+    if (status == 1)
+        apply_frame(&playback->frame, scene);
+    else if (status == 0)
+        playback->ended = true;
+    return status;
+}
+
+int playback_seek(struct Playback* playback, Scene* scene, unsigned long tick) {
+    const int status = replay_seek(&playback->cursor, &playback->replay, tick, &playback->frame);
+    if (status < 0)
+        return -1;
+    playback->ended = status == 0;
+    apply_frame(&playback->frame, scene);
+    return 0;
+}
+
+long playback_next_goal(const struct Playback* playback) {
+    const struct Replay* replay = &playback->replay;
+    if (!replay->footer)
+        return -1;
+    for (size_t i = replay_find_event(replay, playback->frame.tick + 1); i < replay->footer->event_count; i++)
+        if (replay->events[i].kind == REPLAY_EVENT_GOAL)
+            return (long)replay->events[i].tick;
+    return -1;
+}
+
+unsigned long playback_ticks(const struct Playback* playback, float seconds) {
+    return (unsigned long)lrintf(seconds * playback->replay.header->tick_rate);
+}
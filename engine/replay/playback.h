@@ -0,0 +1,60 @@
+/**
+ * @file playback.h
+ * @brief Plays a recording back into a live Scene, for the viewer.
+ * * The scene is built exactly like the recorded one (same seed, same
+ * init_scene()), then every decoded frame overwrites its positions, ball,
+ * state, clock and score. Nothing is simulated, so the renderer and the
+ * fixed-timestep loop work unchanged. Seeking goes through the keyframe
+ * index, so jumping anywhere in a match costs at most one keyframe interval
+ * of decoding.
+ */
+
+#ifndef ENGINE_REPLAY_PLAYBACK_H
+#define ENGINE_REPLAY_PLAYBACK_H
+
+#include <stdbool.h>
+
+#include "game/scene.h"
+#include "replay/reader.h"
+
+/**
+ * @struct Playback
+ * @brief A mapped recording and the cursor walking it.
+ */
+struct Playback {
+    struct Replay replay;
+    struct ReplayCursor cursor;
+    struct ReplayFrame frame;       /**< The tick currently shown. */
+    bool ended;                     /**< The last tick has been shown. */
+};
+
+/**
+ * @brief Opens `path` and builds `scene` the way the recorded match started,
+ * with the recording's roster size and pitch. `scene->ball` must be set, as for init_scene().
+ * @return 0 on success, -1 if the file is unreadable or its roster cannot be rebuilt.
+ */
+int playback_open(struct Playback* playback, const char* path, Scene* scene);
+
+void playback_close(struct Playback* playback);
+
+/**
+ * @brief Shows the next tick.
+ * @return 1 if the scene advanced, 0 at the end of the match, -1 on a corrupt stream.
+ */
+int playback_step(struct Playback* playback, Scene* scene);
+
+/**
+ * @brief Jumps to `tick` (clamped to the match) and shows it.
+ * @return 0 on success, -1 on a corrupt stream.
+ */
+int playback_seek(struct Playback* playback, Scene* scene, unsigned long tick);
+
+/**
+ * @brief Tick of the first goal after the one shown, or -1 if none is left (or the file has no index).
+ */
+long playback_next_goal(const struct Playback* playback);
+
+/** @brief Converts game seconds to ticks at the recording's tick rate. */
+unsigned long playback_ticks(const struct Playback* playback, float seconds);
+
+#endif /* ENGINE_REPLAY_PLAYBACK_H */
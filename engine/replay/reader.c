@@ -0,0 +1,416 @@
+#define _POSIX_C_SOURCE 200112L // mmap, fstat
+#include "reader.h"
+#include "game/scene.h"
+#include "logic/referee.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** @brief Locates and bounds-checks the keyframe and event tables named by the footer. */
+static int open_index(struct Replay* replay) {
+    const struct ReplayHeader* header = replay->header;
+    if (replay->size < header->data_offset + sizeof(struct ReplayFooter) || header->keyframe_interval == 0)
+        return -1;
+    const size_t footer_offset = replay->size - sizeof(struct ReplayFooter);
+    if (footer_offset % 4 != 0)
+        return -1;
+    const struct ReplayFooter* footer = (const struct ReplayFooter*)(replay->data + footer_offset);
+    const size_t keyframes_end = footer->keyframe_offset + (size_t)footer->keyframe_count * sizeof(struct ReplayKeyframe);
+    const size_t events_end = footer->event_offset + (size_t)footer->event_count * sizeof(struct ReplayEvent);
+    if (memcmp(footer->magic, REPLAY_INDEX_MAGIC, 4) != 0 ||
+        footer->keyframe_offset % 4 != 0 || footer->keyframe_offset < header->data_offset ||
+        keyframes_end > footer->event_offset || footer->event_offset % 4 != 0 || events_end > footer_offset)
+        return -1;
+
+    const struct ReplayKeyframe* keyframes = (const struct ReplayKeyframe*)(replay->data + footer->keyframe_offset);
+    for (uint32_t k = 0; k < footer->keyframe_count; k++)
+        if (keyframes[k].offset < header->data_offset || keyframes[k].offset >= footer->keyframe_offset ||
+            (k > 0 && keyframes[k].tick <= keyframes[k - 1].tick))
+            return -1;
+
+    replay->footer = footer;
+    replay->keyframes = keyframes;
+    replay->events = (const struct ReplayEvent*)(replay->data + footer->event_offset);
+    return 0;
+}
+
+int replay_open(struct Replay* replay, const char* path) {
+    memset(replay, 0, sizeof(*replay));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return -1;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(struct ReplayHeader)) {
+        close(fd);
+        return -1;
+    }
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // the mapping keeps the file alive
+    if (data == MAP_FAILED)
+        return -1;
+
+    replay->data = data;
+    replay->size = (size_t)st.st_size;
+    replay->header = data;
+
+    const struct ReplayHeader* header = replay->header;
+    if (replay_version_swapped(header->version)) {
+        replay_close(replay);   // written on a host of the other byte order
+        return -1;
+    }
+    const size_t tables = sizeof(struct ReplayHeader)
+                        + sizeof(struct ReplayEntityInfo) * header->player_count + 2 * sizeof(int32_t)
+                        + (header->version >= 3 ? sizeof(struct ReplayField) : 0);
+    if (memcmp(header->magic, REPLAY_MAGIC, 4) != 0 || header->version < 1 || header->version > REPLAY_VERSION ||
+        !(header->ball_decay > 0.0f && header->ball_decay <= 1.0f) ||
+        header->player_count + 1 > REPLAY_MAX_ENTITIES || header->tick_rate <= 0.0f ||
+        header->pos_quantum <= 0.0f || header->vel_quantum <= 0.0f ||
+        header->data_offset < tables || header->data_offset > replay->size) {
+        replay_close(replay);
+        return -1;
+    }
+
+    replay->players = (const struct ReplayEntityInfo*)(replay->data + sizeof(struct ReplayHeader));
+    replay->ball_kickoff = (const int32_t*)(replay->players + header->player_count);
+    if (header->version >= 3)
+        replay->field = (const struct ReplayField*)(replay->ball_kickoff + 2);
+    if (header->version >= 2 && open_index(replay) != 0) {
+        replay_close(replay);
+        return -1;
+    }
+    return 0;
+}
+
+void replay_close(struct Replay* replay) {
+    if (replay->data)
+        munmap((void*)replay->data, replay->size);
+    memset(replay, 0, sizeof(*replay));
+}
+
+static void fill_frame(const struct ReplayCursor* cursor, struct ReplayFrame* frame, int event) {
+    const struct ReplayHeader* header = cursor->replay->header;
+    const int entities = header->player_count + 1;
+
+    frame->tick = cursor->tick;
+    frame->entities = entities;
+    for (int e = 0; e < entities; e++) {
+        frame->x[e] = (float)cursor->px[e] / REPLAY_SUBUNIT * header->pos_quantum;
+        frame->y[e] = (float)cursor->py[e] / REPLAY_SUBUNIT * header->pos_quantum;
+        frame->vx[e] = (float)cursor->vx[e] * header->vel_quantum;
+        frame->vy[e] = (float)cursor->vy[e] * header->vel_quantum;
+    }
+    frame->state = cursor->state;
+    frame->possessor = cursor->possessor == REPLAY_NO_POSSESSOR ? -1 : cursor->possessor;
+    frame->event = event;
+    frame->first_score = cursor->first_score;
+    frame->second_score = cursor->second_score;
+    frame->remaining_time = cursor->remaining_time;
+}
+
+void replay_rewind(struct ReplayCursor* cursor, const struct Replay* replay, struct ReplayFrame* frame) {
+    const struct ReplayHeader* header = replay->header;
+    const int players = header->player_count;
+
+    memset(cursor, 0, sizeof(*cursor));
+    cursor->replay = replay;
+    cursor->offset = header->data_offset;
+    cursor->vel_to_pos = header->vel_quantum / header->tick_rate / header->pos_quantum;
+    cursor->dt = 1.0f / header->tick_rate;
+    cursor->remaining_time = header->match_length;
+    for (int i = 0; i < players; i++) {
+        cursor->px[i] = replay->players[i].x * REPLAY_SUBUNIT;
+        cursor->py[i] = replay->players[i].y * REPLAY_SUBUNIT;
+    }
+    cursor->px[players] = replay->ball_kickoff[0] * REPLAY_SUBUNIT;
+    cursor->py[players] = replay->ball_kickoff[1] * REPLAY_SUBUNIT;
+    cursor->state = header->initial_state;
+    cursor->possessor = header->initial_possessor;
+    cursor->possessor2 = header->initial_possessor;
+
+    if (frame)
+        fill_frame(cursor, frame, PLAY_ON);
+}
+
+static bool get_u8(struct ReplayCursor* cursor, unsigned* value) {
+    if (cursor->offset >= cursor->replay->size)
+        return false;
+    *value = cursor->replay->data[cursor->offset++];
+    return true;
+}
+
+static bool get_varint(struct ReplayCursor* cursor, uint64_t* value) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        unsigned byte;
+        if (!get_u8(cursor, &byte))
+            return false;
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool get_residual(struct ReplayCursor* cursor, int32_t* value) {
+    uint64_t raw;
+    if (!get_varint(cursor, &raw) || raw > UINT32_MAX)
+        return false;
+    *value = replay_unzigzag((uint32_t)raw);
+    return true;
+}
+
+/** @brief Replaces entity e's velocity by this tick's prediction. */
+static void predict_velocity(struct ReplayCursor* cursor, int e, bool is_ball, bool moving) {
+    const float decay = cursor->replay->header->ball_decay;
+    const bool free_ball = is_ball && cursor->possessor == REPLAY_NO_POSSESSOR;
+    const int32_t vx = replay_predict_velocity(cursor->vx[e], cursor->vx2[e], free_ball, moving, decay);
+    const int32_t vy = replay_predict_velocity(cursor->vy[e], cursor->vy2[e], free_ball, moving, decay);
+    cursor->vx2[e] = cursor->vx[e];
+    cursor->vy2[e] = cursor->vy[e];
+    cursor->vx[e] = vx;
+    cursor->vy[e] = vy;
+}
+
+/** @brief Runs the match clock the way advance_scene_clock() does, before the tick's state change. */
+static void advance_clock(struct ReplayCursor* cursor) {
+    if (cursor->state == STATE_RUNNING)
+        cursor->remaining_time -= cursor->dt;
+}
+
+/** @brief Applies this tick's prediction to every entity (what an empty tick means). */
+static void predict(struct ReplayCursor* cursor, int entities) {
+    const bool moving = cursor->state == STATE_RUNNING;
+    for (int e = 0; e < entities; e++) {
+        predict_velocity(cursor, e, e == entities - 1, moving);
+        if (moving) {
+            cursor->px[e] = replay_predict(cursor->px[e], cursor->vx[e], cursor->vel_to_pos);
+            cursor->py[e] = replay_predict(cursor->py[e], cursor->vy[e], cursor->vel_to_pos);
+        }
+    }
+}
+
+static bool decode_motion(struct ReplayCursor* cursor, int entities) {
+    const bool moving = cursor->state == STATE_RUNNING;
+    uint64_t mask;
+    if (!get_varint(cursor, &mask) || (entities < 64 && (mask >> entities) != 0))
+        return false;
+
+    unsigned char channels[REPLAY_MAX_ENTITIES];
+    unsigned packed = 0;
+    int nibbles = 0;
+    for (int e = 0; e < entities; e++) {
+        channels[e] = 0;
+        if (!((mask >> e) & 1))
+            continue;
+        if (nibbles % 2 == 0 && !get_u8(cursor, &packed))
+            return false;
+        channels[e] = (unsigned char)((packed >> (4 * (nibbles & 1))) & 0x0F);
+        if (channels[e] == 0)
+            return false;
+        nibbles++;
+    }
+
+    for (int e = 0; e < entities; e++) {
+        const unsigned ch = channels[e];
+        predict_velocity(cursor, e, e == entities - 1, moving);
+        int32_t residual;
+        if (ch & REPLAY_CH_VX) {
+            if (!get_residual(cursor, &residual))
+                return false;
+            cursor->vx[e] += residual;
+        }
+        if (ch & REPLAY_CH_VY) {
+            if (!get_residual(cursor, &residual))
+                return false;
+            cursor->vy[e] += residual;
+        }
+        if (moving) {
+            cursor->px[e] = replay_predict(cursor->px[e], cursor->vx[e], cursor->vel_to_pos);
+            cursor->py[e] = replay_predict(cursor->py[e], cursor->vy[e], cursor->vel_to_pos);
+        }
+        if (ch & REPLAY_CH_PX) {
+            if (!get_residual(cursor, &residual))
+                return false;
+            cursor->px[e] = (replay_units(cursor->px[e]) + residual) * REPLAY_SUBUNIT;
+        }
+        if (ch & REPLAY_CH_PY) {
+            if (!get_residual(cursor, &residual))
+                return false;
+            cursor->py[e] = (replay_units(cursor->py[e]) + residual) * REPLAY_SUBUNIT;
+        }
+    }
+    return true;
+}
+
+/** @brief Loads the full decoder state of a keyframe whose tag was just read. */
+static bool load_keyframe(struct ReplayCursor* cursor) {
+    const int entities = cursor->replay->header->player_count + 1;
+    uint64_t tick, first, second;
+    unsigned state, possessor, possessor2;
+    if (!get_varint(cursor, &tick) || !get_u8(cursor, &state) || !get_u8(cursor, &possessor) ||
+        !get_u8(cursor, &possessor2) || !get_varint(cursor, &first) || !get_varint(cursor, &second))
+        return false;
+    if ((possessor >= (unsigned)(entities - 1) && possessor != REPLAY_NO_POSSESSOR) ||
+        (possessor2 >= (unsigned)(entities - 1) && possessor2 != REPLAY_NO_POSSESSOR))
+        return false;
+
+    uint32_t remaining_bits = 0;
+    for (int i = 0; i < 4; i++) {
+        unsigned byte;
+        if (!get_u8(cursor, &byte))
+            return false;
+        remaining_bits |= (uint32_t)byte << (8 * i);
+    }
+
+    for (int e = 0; e < entities; e++) {
+        if (!get_residual(cursor, &cursor->px[e]) || !get_residual(cursor, &cursor->py[e]) ||
+            !get_residual(cursor, &cursor->vx[e]) || !get_residual(cursor, &cursor->vy[e]) ||
+            !get_residual(cursor, &cursor->vx2[e]) || !get_residual(cursor, &cursor->vy2[e]))
+            return false;
+    }
+    cursor->tick = (unsigned long)tick;
+    cursor->state = (int)state;
+    cursor->possessor = (int)possessor;
+    cursor->possessor2 = (int)possessor2;
+    cursor->first_score = (unsigned)first;
+    cursor->second_score = (unsigned)second;
+    memcpy(&cursor->remaining_time, &remaining_bits, sizeof(remaining_bits));
+    return true;
+}
+
+int replay_next(struct ReplayCursor* cursor, struct ReplayFrame* frame) {
+    const int entities = cursor->replay->header->player_count + 1;
+    if (cursor->ended)
+        return 0;
+
+    if (cursor->skip_left == 0) {
+        unsigned tag;
+        if (!get_u8(cursor, &tag))
+            return -1;
+        // decoding straight through, a keyframe repeats the state we already hold
+        while (tag == REPLAY_TAG_KEYFRAME) {
+            const unsigned long tick = cursor->tick;
+            if (!load_keyframe(cursor) || cursor->tick != tick || !get_u8(cursor, &tag))
+                return -1;
+        }
+
+        if (tag == REPLAY_TAG_SKIP) {
+            uint64_t count;
+            if (!get_varint(cursor, &count) || count == 0)
+                return -1;
+            cursor->skip_left = (unsigned long)count;
+        } else if (tag == REPLAY_TAG_END) {
+            uint64_t ticks, first, second;
+            if (!get_varint(cursor, &ticks) || !get_varint(cursor, &first) || !get_varint(cursor, &second) ||
+                ticks != cursor->tick)
+                return -1;
+            cursor->first_score = (unsigned)first;
+            cursor->second_score = (unsigned)second;
+            cursor->ended = true;
+            return 0;
+        } else if (tag > 0x0F) {
+            return -1;
+        } else {
+            int event = PLAY_ON;
+            advance_clock(cursor);
+            if (tag & REPLAY_HAS_MOTION) {
+                if (!decode_motion(cursor, entities))
+                    return -1;
+            } else {
+                predict(cursor, entities);
+            }
+            unsigned byte;
+            if (tag & REPLAY_HAS_STATE) {
+                if (!get_u8(cursor, &byte))
+                    return -1;
+                cursor->state = (int)byte;
+            }
+            int holder = cursor->possessor2;
+            if (tag & REPLAY_HAS_POSSESSOR) {
+                if (!get_u8(cursor, &byte) || (byte >= (unsigned)(entities - 1) && byte != REPLAY_NO_POSSESSOR))
+                    return -1;
+                holder = (int)byte;
+            }
+            cursor->possessor2 = cursor->possessor;
+            cursor->possessor = holder;
+            if (tag & REPLAY_HAS_EVENT) {
+                uint64_t first, second;
+                if (!get_u8(cursor, &byte) || !get_varint(cursor, &first) || !get_varint(cursor, &second))
+                    return -1;
+                event = (int)byte;
+                cursor->first_score = (unsigned)first;
+                cursor->second_score = (unsigned)second;
+            }
+            cursor->tick++;
+            if (frame)
+                fill_frame(cursor, frame, event);
+            return 1;
+        }
+    }
+
+    // one tick of a skip run: everything follows the prediction
+    advance_clock(cursor);
+    predict(cursor, entities);
+    const int holder = cursor->possessor2;
+    cursor->possessor2 = cursor->possessor;
+    cursor->possessor = holder;
+    cursor->skip_left--;
+    cursor->tick++;
+    if (frame)
+        fill_frame(cursor, frame, PLAY_ON);
+    return 1;
+}
+
+int replay_seek(struct ReplayCursor* cursor, const struct Replay* replay, unsigned long tick,
+                struct ReplayFrame* frame) {
+    replay_rewind(cursor, replay, NULL);
+    if (replay->footer) {
+        // last keyframe at or before the target
+        size_t lo = 0, hi = replay->footer->keyframe_count;
+        while (lo < hi) {
+            const size_t mid = lo + (hi - lo) / 2;
+            if (replay->keyframes[mid].tick <= tick)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        if (lo > 0) {
+            const struct ReplayKeyframe* keyframe = &replay->keyframes[lo - 1];
+            unsigned tag;
+            cursor->offset = keyframe->offset;
+            if (!get_u8(cursor, &tag) || tag != REPLAY_TAG_KEYFRAME || !load_keyframe(cursor) ||
+                cursor->tick != keyframe->tick)
+                return -1;
+        }
+    }
+
+    bool decoded = false;
+    int status = 1;
+    while (cursor->tick < tick && (status = replay_next(cursor, frame)) == 1)
+        decoded = true;
+    if (status < 0)
+        return -1;
+    if (frame && (!decoded || status == 0))
+        fill_frame(cursor, frame, PLAY_ON);
+    return status;
+}
+
+size_t replay_find_event(const struct Replay* replay, unsigned long tick) {
+    if (!replay->footer)
+        return 0;
+    size_t lo = 0, hi = replay->footer->event_count;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (replay->events[mid].tick < tick)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
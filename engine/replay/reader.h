@@ -0,0 +1,116 @@
+/**
+ * @file reader.h
+ * @brief Maps a .srpl recording and decodes it tick by tick.
+ * * replay_open() mmaps the file read-only; the header and entity table are
+ * used in place, and a ReplayCursor walks the tick records forward without
+ * copying the file. Many cursors may share one Replay. Version 2 files also
+ * carry a keyframe and event index, which replay_seek() and the query tools
+ * read straight from the mapping.
+ */
+
+#ifndef ENGINE_REPLAY_READER_H
+#define ENGINE_REPLAY_READER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "replay/format.h"
+
+/**
+ * @struct Replay
+ * @brief A mapped, validated recording.
+ */
+struct Replay {
+    const unsigned char* data;
+    size_t size;
+    const struct ReplayHeader* header;
+    const struct ReplayEntityInfo* players;     /**< header->player_count entries. */
+    const int32_t* ball_kickoff;                /**< Ball x, y in pos_quantum units. */
+    const struct ReplayField* field;            /**< NULL before version 3 (played on field_default()). */
+    const struct ReplayFooter* footer;          /**< NULL in version 1 files (no index). */
+    const struct ReplayKeyframe* keyframes;     /**< footer->keyframe_count entries, by tick. */
+    const struct ReplayEvent* events;           /**< footer->event_count entries, by tick. */
+};
+
+/**
+ * @struct ReplayFrame
+ * @brief The decoded state after one tick.
+ */
+struct ReplayFrame {
+    unsigned long tick;             /**< 1 for the first update_scene() call; 0 is kick-off. */
+    int entities;                   /**< Players plus the ball (last index). */
+    float x[REPLAY_MAX_ENTITIES];
+    float y[REPLAY_MAX_ENTITIES];
+    float vx[REPLAY_MAX_ENTITIES];
+    float vy[REPLAY_MAX_ENTITIES];
+    int state;                      /**< GameState. */
+    int possessor;                  /**< Player index, or -1. */
+    int event;                      /**< RefereeCode raised this tick (PLAY_ON if none). */
+    unsigned first_score;
+    unsigned second_score;
+    float remaining_time;           /**< Match clock, in game seconds. */
+};
+
+/**
+ * @struct ReplayCursor
+ * @brief Decoder position inside a Replay, holding the same integer state the recorder kept.
+ */
+struct ReplayCursor {
+    const struct Replay* replay;
+    size_t offset;                  /**< Next record to read. */
+    unsigned long tick;
+    unsigned long skip_left;        /**< Ticks left in the current REPLAY_TAG_SKIP run. */
+    float vel_to_pos;
+    int32_t px[REPLAY_MAX_ENTITIES];    /**< In pos_quantum / REPLAY_SUBUNIT units. */
+    int32_t py[REPLAY_MAX_ENTITIES];
+    int32_t vx[REPLAY_MAX_ENTITIES];
+    int32_t vy[REPLAY_MAX_ENTITIES];
+    int32_t vx2[REPLAY_MAX_ENTITIES];   /**< Velocities of the tick before. */
+    int32_t vy2[REPLAY_MAX_ENTITIES];
+    int state;
+    int possessor;                  /**< Player index or REPLAY_NO_POSSESSOR. */
+    int possessor2;                 /**< Holder of the tick before. */
+    unsigned first_score;
+    unsigned second_score;
+    float dt;
+    float remaining_time;
+    bool ended;
+};
+
+/**
+ * @brief Maps `path` and checks its header.
+ * @return 0 on success, -1 if the file cannot be mapped or is not a supported
+ * recording, including one written on a host of the other byte order.
+ */
+int replay_open(struct Replay* replay, const char* path);
+
+void replay_close(struct Replay* replay);
+
+/**
+ * @brief Positions a cursor at kick-off (tick 0) and fills `frame` with that state.
+ */
+void replay_rewind(struct ReplayCursor* cursor, const struct Replay* replay, struct ReplayFrame* frame);
+
+/**
+ * @brief Decodes the next tick into `frame`.
+ * @return 1 if a tick was decoded, 0 at the end of the match, -1 on a corrupt stream.
+ */
+int replay_next(struct ReplayCursor* cursor, struct ReplayFrame* frame);
+
+/**
+ * @brief Moves a cursor to `tick` and fills `frame` with that tick's state.
+ * Loads the last keyframe at or before `tick` and decodes forward from there;
+ * without an index (version 1) it decodes from kick-off. A tick past the end
+ * stops at the last one.
+ * @return 1 if the cursor is at `tick`, 0 if the match ended before it, -1 on a corrupt stream.
+ */
+int replay_seek(struct ReplayCursor* cursor, const struct Replay* replay, unsigned long tick,
+                struct ReplayFrame* frame);
+
+/**
+ * @brief Index of the first event at or after `tick`, or event_count if there is none.
+ */
+size_t replay_find_event(const struct Replay* replay, unsigned long tick);
+
+#endif /* ENGINE_REPLAY_READER_H */
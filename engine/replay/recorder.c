@@ -0,0 +1,441 @@
+#include "recorder.h"
+#include "game/scene.h"
+#include "entities/ball.h"
+#include "entities/team.h"
+#include "game/trajectory.h"
+#include "logic/referee.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The header and entity table are copied byte for byte; keep their sizes pinned.
+typedef char replay_header_is_64_bytes[sizeof(struct ReplayHeader) == 64 ? 1 : -1];
+typedef char replay_entity_is_16_bytes[sizeof(struct ReplayEntityInfo) == 16 ? 1 : -1];
+typedef char replay_event_is_12_bytes[sizeof(struct ReplayEvent) == 12 ? 1 : -1];
+typedef char replay_footer_is_24_bytes[sizeof(struct ReplayFooter) == 24 ? 1 : -1];
+
+static bool reserve(struct Recorder* rec, size_t extra) {
+    if (rec->failed)
+        return false;
+    if (rec->size + extra <= rec->capacity)
+        return true;
+
+    size_t capacity = rec->capacity ? rec->capacity : 4096;
+    while (capacity < rec->size + extra)
+        capacity *= 2;
+    unsigned char* data = realloc(rec->data, capacity);
+    if (!data) {
+        rec->failed = true;
+        return false;
+    }
+    rec->data = data;
+    rec->capacity = capacity;
+    return true;
+}
+
+static void put_bytes(struct Recorder* rec, const void* bytes, size_t count) {
+    if (!reserve(rec, count))
+        return;
+    memcpy(rec->data + rec->size, bytes, count);
+    rec->size += count;
+}
+
+/**
+ * @brief Makes room for one more element in a growable index table.
+ */
+static bool grow(struct Recorder* rec, void** items, size_t* capacity, size_t count, size_t item_size) {
+    if (rec->failed)
+        return false;
+    if (count < *capacity)
+        return true;
+    const size_t new_capacity = *capacity ? *capacity * 2 : 16;
+    void* grown = realloc(*items, new_capacity * item_size);
+    if (!grown) {
+        rec->failed = true;
+        return false;
+    }
+    *items = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+static void put_u8(struct Recorder* rec, unsigned value) {
+    unsigned char byte = (unsigned char)value;
+    put_bytes(rec, &byte, 1);
+}
+
+// LEB128: 7 bits per byte, high bit set on every byte but the last.
+static void put_varint(struct Recorder* rec, uint64_t value) {
+    unsigned char bytes[10];
+    size_t n = 0;
+    do {
+        bytes[n] = (unsigned char)(value & 0x7F);
+        value >>= 7;
+        if (value)
+            bytes[n] |= 0x80;
+        n++;
+    } while (value);
+    put_bytes(rec, bytes, n);
+}
+
+static int32_t quantize(float value, float scale) {
+    return (int32_t)lrintf(value * scale);
+}
+
+static int possessor_index(const struct Scene* scene) {
+    const struct Player* possessor = scene->ball->possessor;
+    return possessor ? (int)(possessor - scene->roster.views) : REPLAY_NO_POSSESSOR;
+}
+
+int recorder_begin(struct Recorder* rec, const struct Scene* scene,
+                   uint64_t seed, uint64_t stream, float tick_rate) {
+    const int players = scene->roster.count;
+    memset(rec, 0, sizeof(*rec));
+    if (players + 1 > REPLAY_MAX_ENTITIES || players >= REPLAY_NO_POSSESSOR || tick_rate <= 0.0f)
+        return -1;
+
+    rec->entities = players + 1;
+    rec->pos_scale = 1.0f / REPLAY_POS_QUANTUM;
+    rec->vel_scale = 1.0f / REPLAY_VEL_QUANTUM;
+    rec->vel_to_pos = REPLAY_VEL_QUANTUM / tick_rate / REPLAY_POS_QUANTUM;
+    rec->pos_deadband = REPLAY_POS_DEADBAND;
+    rec->vel_deadband = REPLAY_VEL_DEADBAND;
+    rec->ball_decay = ball_decay(1.0f / tick_rate);  // same factor as ball_roll() in move_scene()
+    rec->state = scene->state;
+    rec->possessor = possessor_index(scene);
+    rec->possessor2 = rec->possessor;
+    rec->dt = 1.0f / tick_rate;
+    rec->remaining_time = scene->remaining_time;
+    rec->first_score = scene->first_team->score;
+    rec->second_score = scene->second_team->score;
+    rec->keyframe_interval = (unsigned long)lrintf(REPLAY_KEYFRAME_SECONDS * tick_rate);
+    if (rec->keyframe_interval == 0)
+        rec->keyframe_interval = 1;
+    rec->possession_ticks = (unsigned long)ceilf(REPLAY_POSSESSION_SECONDS * tick_rate);
+    rec->holder = rec->possessor;
+    rec->owner = REPLAY_NO_POSSESSOR;
+
+    struct ReplayHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, REPLAY_MAGIC, 4);
+    header.version = REPLAY_VERSION;
+    header.player_count = (uint16_t)players;
+    header.data_offset = (uint32_t)(sizeof(header) + sizeof(struct ReplayEntityInfo) * (size_t)players
+                                    + 2 * sizeof(int32_t) + sizeof(struct ReplayField));
+    header.keyframe_interval = (uint32_t)rec->keyframe_interval;
+    header.seed = seed;
+    header.stream = stream;
+    header.tick_rate = tick_rate;
+    header.match_length = scene->remaining_time;
+    header.pos_quantum = REPLAY_POS_QUANTUM;
+    header.vel_quantum = REPLAY_VEL_QUANTUM;
+    header.pos_deadband = REPLAY_POS_DEADBAND;
+    header.vel_deadband = REPLAY_VEL_DEADBAND;
+    header.initial_state = (uint8_t)scene->state;
+    header.initial_possessor = (uint8_t)rec->possessor;
+    header.ball_decay = rec->ball_decay;
+    put_bytes(rec, &header, sizeof(header));
+
+    for (int i = 0; i < players; i++) {
+        const struct Player* p = &scene->roster.views[i];
+        struct ReplayEntityInfo info;
+        memset(&info, 0, sizeof(info));
+        info.team = (uint8_t)p->team;
+        info.kit = (uint8_t)p->kit;
+        info.talents[0] = (uint8_t)p->talents.defence;
+        info.talents[1] = (uint8_t)p->talents.agility;
+        info.talents[2] = (uint8_t)p->talents.dribbling;
+        info.talents[3] = (uint8_t)p->talents.shooting;
+        info.x = quantize(p->position.x, rec->pos_scale);
+        info.y = quantize(p->position.y, rec->pos_scale);
+        put_bytes(rec, &info, sizeof(info));
+
+        rec->px[i] = info.x * REPLAY_SUBUNIT;
+        rec->py[i] = info.y * REPLAY_SUBUNIT;
+    }
+
+    const struct Ball* ball = scene->ball;
+    const int32_t ball_xy[2] = { quantize(ball->position.x, rec->pos_scale),
+                                 quantize(ball->position.y, rec->pos_scale) };
+    put_bytes(rec, ball_xy, sizeof(ball_xy));
+    rec->px[players] = ball_xy[0] * REPLAY_SUBUNIT;
+    rec->py[players] = ball_xy[1] * REPLAY_SUBUNIT;
+
+    const Field* field = &scene->field;
+    const struct ReplayField pitch = {
+        field->width, field->height, field->pitch_x, field->pitch_y, field->pitch_w, field->pitch_h,
+        field->center_x, field->center_y, field->goal_width, field->goal_height
+    };
+    put_bytes(rec, &pitch, sizeof(pitch));
+
+    // Decoders start every velocity at zero (init_scene() leaves everyone still);
+    // anything else simply shows up as a residual in the first tick.
+    return rec->failed ? -1 : 0;
+}
+
+/**
+ * @brief Decides what one channel costs this tick.
+ * @return true (and the residual) if the real value is outside the dead-band around the prediction.
+ */
+static bool encode_channel(int32_t actual, int32_t predicted, int32_t deadband,
+                           int32_t* reconstructed, int32_t* residual) {
+    const int32_t diff = actual - predicted;
+    if (diff >= -deadband && diff <= deadband) {
+        *reconstructed = predicted;
+        return false;
+    }
+    *reconstructed = actual;
+    *residual = diff;
+    return true;
+}
+
+/**
+ * @brief encode_channel() for a position: the prediction carries sub-units, the file whole units.
+ */
+static bool encode_position(int32_t actual, int32_t predicted, int32_t deadband,
+                            int32_t* reconstructed, int32_t* residual) {
+    const int32_t diff = actual - replay_units(predicted);
+    if (diff >= -deadband && diff <= deadband) {
+        *reconstructed = predicted;
+        return false;
+    }
+    *reconstructed = actual * REPLAY_SUBUNIT;
+    *residual = diff;
+    return true;
+}
+
+static void flush_skip(struct Recorder* rec) {
+    if (rec->skipped) {
+        put_u8(rec, REPLAY_TAG_SKIP);
+        put_varint(rec, rec->skipped);
+        rec->skipped = 0;
+    }
+}
+
+static void add_event(struct Recorder* rec, unsigned long tick, int kind, int subject) {
+    if (!grow(rec, (void**)&rec->events, &rec->event_capacity, rec->event_count, sizeof(struct ReplayEvent)))
+        return;
+    struct ReplayEvent* event = &rec->events[rec->event_count++];
+    memset(event, 0, sizeof(*event));
+    event->tick = (uint32_t)tick;
+    event->kind = (uint8_t)kind;
+    event->subject = (uint8_t)subject;
+    event->first_score = (uint16_t)rec->first_score;
+    event->second_score = (uint16_t)rec->second_score;
+}
+
+/**
+ * @brief Adds a possession event once a new player has been the last to touch the
+ * ball for possession_ticks. Dribbling releases the ball every other tick, so free
+ * ticks keep the toucher; tackle duels swap it every tick and never count.
+ */
+static void track_possession(struct Recorder* rec, int possessor) {
+    if (possessor != REPLAY_NO_POSSESSOR && possessor != rec->holder) {
+        rec->holder = possessor;
+        rec->holder_since = rec->ticks;
+    }
+    if (rec->holder != REPLAY_NO_POSSESSOR && rec->holder != rec->owner &&
+        rec->ticks - rec->holder_since + 1 >= rec->possession_ticks) {
+        rec->owner = rec->holder;
+        add_event(rec, rec->holder_since, REPLAY_EVENT_POSSESSION, rec->holder);
+    }
+}
+
+/** @brief Writes the decoder state after the current tick as a keyframe and indexes it. */
+static void put_keyframe(struct Recorder* rec) {
+    flush_skip(rec);
+    if (!grow(rec, (void**)&rec->keyframes, &rec->keyframe_capacity, rec->keyframe_count,
+              sizeof(struct ReplayKeyframe)))
+        return;
+    struct ReplayKeyframe* keyframe = &rec->keyframes[rec->keyframe_count++];
+    keyframe->tick = (uint32_t)rec->ticks;
+    keyframe->offset = (uint32_t)rec->size;
+
+    uint32_t remaining_bits;
+    memcpy(&remaining_bits, &rec->remaining_time, sizeof(remaining_bits));
+
+    put_u8(rec, REPLAY_TAG_KEYFRAME);
+    put_varint(rec, rec->ticks);
+    put_u8(rec, (unsigned)rec->state);
+    put_u8(rec, (unsigned)rec->possessor);
+    put_u8(rec, (unsigned)rec->possessor2);
+    put_varint(rec, rec->first_score);
+    put_varint(rec, rec->second_score);
+    put_bytes(rec, &remaining_bits, sizeof(remaining_bits));
+    for (int e = 0; e < rec->entities; e++) {
+        put_varint(rec, replay_zigzag(rec->px[e]));
+        put_varint(rec, replay_zigzag(rec->py[e]));
+        put_varint(rec, replay_zigzag(rec->vx[e]));
+        put_varint(rec, replay_zigzag(rec->vy[e]));
+        put_varint(rec, replay_zigzag(rec->vx2[e]));
+        put_varint(rec, replay_zigzag(rec->vy2[e]));
+    }
+}
+
+static void put_tick(struct Recorder* rec, const struct Scene* scene, unsigned flags, uint64_t mask,
+                     const unsigned char* channels, int32_t (*residuals)[4], int possessor, int call) {
+    put_u8(rec, flags);
+    if (flags & REPLAY_HAS_MOTION) {
+        put_varint(rec, mask);
+        unsigned packed = 0;
+        int nibbles = 0;
+        for (int e = 0; e < rec->entities; e++) {
+            if (!channels[e])
+                continue;
+            packed |= (unsigned)channels[e] << (4 * (nibbles & 1));
+            if (++nibbles % 2 == 0) {
+                put_u8(rec, packed);
+                packed = 0;
+            }
+        }
+        if (nibbles % 2)
+            put_u8(rec, packed);
+
+        for (int e = 0; e < rec->entities; e++)
+            for (int k = 0; k < 4; k++)
+                if (channels[e] & (1u << k))
+                    put_varint(rec, replay_zigzag(residuals[e][k]));
+    }
+    if (flags & REPLAY_HAS_STATE)
+        put_u8(rec, (unsigned)scene->state);
+    if (flags & REPLAY_HAS_POSSESSOR)
+        put_u8(rec, (unsigned)possessor);
+    if (flags & REPLAY_HAS_EVENT) {
+        put_u8(rec, (unsigned)call);
+        put_varint(rec, scene->first_team->score);
+        put_varint(rec, scene->second_team->score);
+    }
+}
+
+void recorder_tick(struct Recorder* rec, const struct Scene* scene, int call) {
+    if (rec->failed)
+        return;
+
+    // physics only moved things (and the clock only ran) if the previous tick left the match running
+    const bool moving = rec->state == STATE_RUNNING;
+    if (moving)
+        rec->remaining_time -= rec->dt;
+    const int players = rec->entities - 1;
+    unsigned char channels[REPLAY_MAX_ENTITIES];
+    int32_t residuals[REPLAY_MAX_ENTITIES][4];
+    uint64_t mask = 0;
+
+    for (int e = 0; e < rec->entities; e++) {
+        float x, y, vx, vy;
+        if (e < players) {
+            const struct Player* p = &scene->roster.views[e];
+            x = p->position.x;  y = p->position.y;
+            vx = p->velocity.x; vy = p->velocity.y;
+        } else {
+            const struct Ball* ball = scene->ball;
+            x = ball->position.x;  y = ball->position.y;
+            vx = ball->velocity.x; vy = ball->velocity.y;
+        }
+
+        // velocities first: the position prediction uses the reconstructed new velocity
+        const bool free_ball = e == players && rec->possessor == REPLAY_NO_POSSESSOR;
+        const int32_t pred_vx = replay_predict_velocity(rec->vx[e], rec->vx2[e], free_ball, moving, rec->ball_decay);
+        const int32_t pred_vy = replay_predict_velocity(rec->vy[e], rec->vy2[e], free_ball, moving, rec->ball_decay);
+        rec->vx2[e] = rec->vx[e];
+        rec->vy2[e] = rec->vy[e];
+
+        int32_t* res = residuals[e];
+        unsigned char ch = 0;
+        if (encode_channel(quantize(vx, rec->vel_scale), pred_vx, rec->vel_deadband, &rec->vx[e], res))
+            ch |= REPLAY_CH_VX;
+        if (encode_channel(quantize(vy, rec->vel_scale), pred_vy, rec->vel_deadband, &rec->vy[e], res + 1))
+            ch |= REPLAY_CH_VY;
+
+        const int32_t pred_x = moving ? replay_predict(rec->px[e], rec->vx[e], rec->vel_to_pos) : rec->px[e];
+        const int32_t pred_y = moving ? replay_predict(rec->py[e], rec->vy[e], rec->vel_to_pos) : rec->py[e];
+        if (encode_position(quantize(x, rec->pos_scale), pred_x, rec->pos_deadband, &rec->px[e], res + 2))
+            ch |= REPLAY_CH_PX;
+        if (encode_position(quantize(y, rec->pos_scale), pred_y, rec->pos_deadband, &rec->py[e], res + 3))
+            ch |= REPLAY_CH_PY;
+
+        channels[e] = ch;
+        if (ch)
+            mask |= (uint64_t)1 << e;
+    }
+
+    const int possessor = possessor_index(scene);
+    unsigned flags = 0;
+    if (mask)
+        flags |= REPLAY_HAS_MOTION;
+    if ((int)scene->state != rec->state)
+        flags |= REPLAY_HAS_STATE;
+    if (possessor != rec->possessor2)
+        flags |= REPLAY_HAS_POSSESSOR;
+    if (call != PLAY_ON)
+        flags |= REPLAY_HAS_EVENT;
+
+    rec->ticks++;
+    if (flags == 0) {
+        rec->skipped++;
+    } else {
+        flush_skip(rec);
+        put_tick(rec, scene, flags, mask, channels, residuals, possessor, call);
+    }
+    rec->state = scene->state;
+    rec->possessor2 = rec->possessor;
+    rec->possessor = possessor;
+
+    track_possession(rec, possessor);
+    const int scorer = scene->first_team->score != rec->first_score ? 1 : 2;
+    rec->first_score = scene->first_team->score;
+    rec->second_score = scene->second_team->score;
+    if (call == GOAL) {
+        add_event(rec, rec->ticks, REPLAY_EVENT_GOAL, scorer);
+    } else if (call == OUT) {
+        add_event(rec, rec->ticks, REPLAY_EVENT_OUT, scene->ball->last_team);
+    }
+    if (rec->ticks % rec->keyframe_interval == 0)
+        put_keyframe(rec);
+}
+
+int recorder_end(struct Recorder* rec, const struct Scene* scene) {
+    flush_skip(rec);
+    put_u8(rec, REPLAY_TAG_END);
+    put_varint(rec, rec->ticks);
+    put_varint(rec, scene->first_team->score);
+    put_varint(rec, scene->second_team->score);
+
+    // index: 4-byte aligned tables, then the footer at the very end
+    static const unsigned char zeros[4] = {0};
+    put_bytes(rec, zeros, (4 - rec->size % 4) % 4);
+
+    struct ReplayFooter footer;
+    memset(&footer, 0, sizeof(footer));
+    footer.keyframe_offset = (uint32_t)rec->size;
+    footer.keyframe_count = (uint32_t)rec->keyframe_count;
+    put_bytes(rec, rec->keyframes, sizeof(struct ReplayKeyframe) * rec->keyframe_count);
+    footer.event_offset = (uint32_t)rec->size;
+    footer.event_count = (uint32_t)rec->event_count;
+    put_bytes(rec, rec->events, sizeof(struct ReplayEvent) * rec->event_count);
+    footer.ticks = (uint32_t)rec->ticks;
+    memcpy(footer.magic, REPLAY_INDEX_MAGIC, 4);
+    put_bytes(rec, &footer, sizeof(footer));
+    return rec->failed ? -1 : 0;
+}
+
+int recorder_save(const struct Recorder* rec, const char* path) {
+    if (rec->failed)
+        return -1;
+    FILE* file = fopen(path, "wb");
+    if (!file)
+        return -1;
+    const bool ok = fwrite(rec->data, 1, rec->size, file) == rec->size;
+    return (fclose(file) == 0 && ok) ? 0 : -1;
+}
+
+void recorder_free(struct Recorder* rec) {
+    free(rec->data);
+    free(rec->keyframes);
+    free(rec->events);
+    rec->keyframes = NULL;
+    rec->events = NULL;
+    rec->data = NULL;
+    rec->size = rec->capacity = 0;
+}
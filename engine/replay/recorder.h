@@ -0,0 +1,101 @@
+/**
+ * @file recorder.h
+ * @brief Records a match into the compact .srpl format (see replay/format.h).
+ * * Attach a started Recorder to Scene::recorder and update_scene() appends
+ * one tick record per call. The encoder keeps the exact state the decoder
+ * will reconstruct, so dead-band errors never accumulate: whenever the
+ * prediction drifts past the dead-band the real value is written again.
+ * Every keyframe_interval ticks that state is also written out in full as a
+ * keyframe, and recorder_end() appends the keyframe and event index.
+ * The whole file is built in memory (tens of KB per match) and written once.
+ */
+
+#ifndef ENGINE_REPLAY_RECORDER_H
+#define ENGINE_REPLAY_RECORDER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "replay/format.h"
+
+struct Scene;
+
+/**
+ * @struct Recorder
+ * @brief Output buffer plus the decoder-side view of every entity.
+ */
+struct Recorder {
+    unsigned char* data;
+    size_t size;
+    size_t capacity;
+    bool failed;                    /**< An allocation failed; the recording is unusable. */
+
+    int entities;                   /**< Players plus the ball (last index). */
+    float pos_scale;                /**< 1 / pos_quantum. */
+    float vel_scale;                /**< 1 / vel_quantum. */
+    float vel_to_pos;               /**< Velocity units to position units per tick. */
+    int32_t pos_deadband;
+    int32_t vel_deadband;
+
+    int32_t px[REPLAY_MAX_ENTITIES];    /**< What a decoder holds after the last tick (positions in sub-units). */
+    int32_t py[REPLAY_MAX_ENTITIES];
+    int32_t vx[REPLAY_MAX_ENTITIES];
+    int32_t vy[REPLAY_MAX_ENTITIES];
+    int32_t vx2[REPLAY_MAX_ENTITIES];   /**< Velocities of the tick before, for the player prediction. */
+    int32_t vy2[REPLAY_MAX_ENTITIES];
+    float ball_decay;
+    int state;
+    int possessor;                  /**< Player index or REPLAY_NO_POSSESSOR. */
+    int possessor2;                 /**< Holder of the tick before. */
+    float dt;
+    float remaining_time;           /**< The match clock, advanced exactly like advance_scene_clock(). */
+    unsigned first_score;
+    unsigned second_score;
+
+    unsigned long ticks;            /**< Ticks recorded so far. */
+    unsigned long skipped;          /**< Empty ticks waiting to be written as one REPLAY_TAG_SKIP. */
+
+    unsigned long keyframe_interval;
+    struct ReplayKeyframe* keyframes;
+    size_t keyframe_count;
+    size_t keyframe_capacity;
+
+    struct ReplayEvent* events;
+    size_t event_count;
+    size_t event_capacity;
+    unsigned long possession_ticks; /**< REPLAY_POSSESSION_SECONDS in ticks. */
+    int holder;                     /**< Last player to touch the ball, since holder_since (or REPLAY_NO_POSSESSOR). */
+    unsigned long holder_since;
+    int owner;                      /**< Player of the last possession event. */
+};
+
+/**
+ * @brief Starts a recording of a scene fresh out of init_scene().
+ * Writes the header: seed, talents and kick-off positions.
+ * @return 0 on success, -1 on allocation failure or a roster too large for the format.
+ */
+int recorder_begin(struct Recorder* recorder, const struct Scene* scene,
+                   uint64_t seed, uint64_t stream, float tick_rate);
+
+/**
+ * @brief Appends the tick update_scene() just played.
+ * @param call The RefereeCode of the tick (PLAY_ON if the referee was not consulted).
+ */
+void recorder_tick(struct Recorder* recorder, const struct Scene* scene, int call);
+
+/**
+ * @brief Writes the trailer (tick count and final score) and the keyframe and event index.
+ * @return 0 on success, -1 if the recording failed at any point.
+ */
+int recorder_end(struct Recorder* recorder, const struct Scene* scene);
+
+/**
+ * @brief Writes a finished recording to `path`.
+ * @return 0 on success, -1 on I/O error.
+ */
+int recorder_save(const struct Recorder* recorder, const char* path);
+
+void recorder_free(struct Recorder* recorder);
+
+#endif /* ENGINE_REPLAY_RECORDER_H */
@@ -1,50 +1,260 @@
 #define SDL_MAIN_HANDLED
 #include <SDL2/SDL.h>
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
+#include "engine/core/profile.h"
 #include "engine/entities/ball.h"
 #include "engine/entities/team.h"
+#include "engine/game/timestep.h"
 #include "engine/graphics/renderer.h"
+#include "engine/logic/coach_loader.h"
+#include "engine/replay/playback.h"
 
-int main(void) {
-    srand((unsigned) time(NULL));
+/** @brief How far the arrow keys jump, and how much lead-up G leaves before a goal. */
+#define REPLAY_JUMP_SECONDS 5.0f
+#define REPLAY_GOAL_LEAD_SECONDS 3.0f
+/** @brief How often coach plugins are checked for a new build. */
+#define COACH_RELOAD_CHECK_MS 500
 
-    struct Renderer renderer;
-    if (renderer_init(&renderer) != 0)
-        return 1;
+static void print_usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [--seed N] [--tick-rate HZ] [--max-catch-up N] [--coach1 FILE] [--coach2 FILE]\n"
+            "          [--team-size N] [--pitch WxH] [--profile] [--trace FILE]\n"
+            "       %s --replay FILE [--from-tick N] [--max-catch-up N] [--profile] [--trace FILE]\n"
+            "  --seed N           match seed (default: current time)\n"
+            "  --tick-rate HZ     simulation ticks per game second (default %.0f)\n"
+            "  --max-catch-up N   most ticks simulated per rendered frame (default %d)\n"
+            "  --coach1 FILE      coach plugin (.so) for team 1, reloaded whenever the file changes\n"
+            "  --coach2 FILE      coach plugin (.so) for team 2, likewise\n"
+            "  --team-size N      players per side, 1 to %d (default %d)\n"
+            "  --pitch WxH        pitch size in px; the window grows with it (default %gx%g)\n"
+            "  --replay FILE      play a .srpl recording instead of a live match\n"
+            "  --from-tick N      start the replay at tick N\n"
+            "  --profile          time the tick and draw phases; p50/p99/max go to stderr at exit\n"
+            "  --trace FILE       also write every timed phase to FILE as Chrome trace JSON\n"
+            "replay keys: space pause, left/right -/+%.0f s, G %.0f s before the next goal, Home restart\n",
+            prog, prog, DEFAULT_TICK_RATE, DEFAULT_MAX_CATCH_UP_STEPS,
+            MAX_TEAM_SIZE, DEFAULT_TEAM_SIZE, field_default().pitch_w, field_default().pitch_h,
+            REPLAY_JUMP_SECONDS, REPLAY_GOAL_LEAD_SECONDS);
+}
+
+/** @brief Handles a replay key; returns true if the view jumped (so nothing should be blended). */
+static bool handle_replay_key(struct Playback *playback, Scene *scene, int key, bool *paused) {
+    const unsigned long tick = playback->frame.tick;
+    const unsigned long jump = playback_ticks(playback, REPLAY_JUMP_SECONDS);
+    long target;
+
+    switch (key) {
+    case SDLK_SPACE:
+        *paused = !*paused;
+        return false;
+    case SDLK_LEFT:
+        target = tick > jump ? (long)(tick - jump) : 0;
+        break;
+    case SDLK_RIGHT:
+        target = (long)(tick + jump);
+        break;
+    case SDLK_HOME:
+        target = 0;
+        break;
+    case SDLK_g: {
+        const long goal = playback_next_goal(playback);
+        if (goal < 0)
+            return false;
+        const long lead = (long)playback_ticks(playback, REPLAY_GOAL_LEAD_SECONDS);
+        // already inside the lead-up: go to the start of it anyway
+        target = goal > lead ? goal - lead : 0;
+        break;
+    }
+    default:
+        return false;
+    }
+    if (playback_seek(playback, scene, (unsigned long)target) != 0)
+        fprintf(stderr, "replay: corrupt recording around tick %ld\n", target);
+    return true;
+}
+
+/** @brief Swaps in the new build of every coach plugin whose file changed; a broken build keeps the old one. */
+static void reload_changed_coaches(struct CoachPlugin coaches[2], Scene *scene) {
+    for (int t = 0; t < 2; t++) {
+        if (!coaches[t].handle || !coach_plugin_changed(&coaches[t]))
+            continue;
+        struct CoachPlugin fresh;
+        if (coach_plugin_reload(&coaches[t], &fresh) != 0) {
+            fprintf(stderr, "%s: the new build does not load, keeping the running one\n", coaches[t].path);
+            continue;
+        }
+        // players must stop pointing into the old build before it is closed
+        scene_rebind_coach(scene, t + 1, fresh.api);
+        coach_plugin_unload(&coaches[t]);
+        coaches[t] = fresh;
+        printf("team %d: reloaded coach %s\n", t + 1, coaches[t].path);
+    }
+}
+
+int main(int argc, char **argv) {
+    unsigned long seed = (unsigned long) time(NULL);
+    float tick_rate = DEFAULT_TICK_RATE;
+    int max_catch_up = DEFAULT_MAX_CATCH_UP_STEPS;
+    const char *replay_path = NULL;
+    unsigned long from_tick = 0;
+    const char *coach_paths[2] = { NULL, NULL };
+    int team_size = DEFAULT_TEAM_SIZE;
+    Field field = field_default();
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--seed") == 0 && value) {
+            seed = strtoul(value, NULL, 10);
+            i++;
+        } else if (strcmp(arg, "--tick-rate") == 0 && value) {
+            tick_rate = strtof(value, NULL);
+            i++;
+        } else if (strcmp(arg, "--max-catch-up") == 0 && value) {
+            max_catch_up = atoi(value);
+            i++;
+        } else if (strcmp(arg, "--replay") == 0 && value) {
+            replay_path = value;
+            i++;
+        } else if (strcmp(arg, "--from-tick") == 0 && value) {
+            from_tick = strtoul(value, NULL, 10);
+            i++;
+        } else if (strcmp(arg, "--coach1") == 0 && value) {
+            coach_paths[0] = value;
+            i++;
+        } else if (strcmp(arg, "--coach2") == 0 && value) {
+            coach_paths[1] = value;
+            i++;
+        } else if (strcmp(arg, "--team-size") == 0 && value && atoi(value) > 0 && atoi(value) <= MAX_TEAM_SIZE) {
+            team_size = atoi(value);
+            i++;
+        } else if (strcmp(arg, "--pitch") == 0 && value && field_parse(value, &field) == 0) {
+            i++;
+        } else if (strcmp(arg, "--profile") == 0) {
+            profile_start(NULL);
+        } else if (strcmp(arg, "--trace") == 0 && value) {
+            profile_start(value);
+            i++;
+        } else {
+            print_usage(argv[0]);
+            return (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) ? 0 : 1;
+        }
+    }
+
+    // live matches only: a recording already holds every decision the coaches made
+    struct CoachPlugin coaches[2];
+    memset(coaches, 0, sizeof(coaches));
+    for (int t = 0; t < 2 && !replay_path; t++) {
+        if (coach_paths[t] && coach_plugin_load(&coaches[t], coach_paths[t]) != 0) {
+            fprintf(stderr, "%s: not a loadable coach plugin\n", coach_paths[t]);
+            coach_plugin_unload(&coaches[0]);
+            return 1;
+        }
+    }
 
+    // a replay brings its own roster and pitch
     Scene scene = {
-        .field = {1000, 700},
-        .first_team = make_team_ptr(),
-        .second_team = make_team_ptr(),
+        .field = field,
+        .team_size = team_size,
         .ball = make_ball_ptr(0, 0)
     };
 
-    init_scene(&scene);
+    struct Playback playback;
+    bool paused = false;
+    if (replay_path) {
+        if (playback_open(&playback, replay_path, &scene) != 0) {
+            fprintf(stderr, "%s: not a playable match recording\n", replay_path);
+            free(scene.ball);
+            return 1;
+        }
+        tick_rate = playback.replay.header->tick_rate;
+        if (from_tick && playback_seek(&playback, &scene, from_tick) != 0)
+            fprintf(stderr, "%s: corrupt recording around tick %lu\n", replay_path, from_tick);
+    } else {
+        rng_seed(&scene.rng, seed, 0);
+        scene.coaches[0] = coaches[0].api;
+        scene.coaches[1] = coaches[1].api;
+        if (init_scene(&scene) != 0) {
+            fprintf(stderr, "out of memory\n");
+            free(scene.ball);
+            return 1;
+        }
+    }
+
+    struct Renderer renderer;
+    if (renderer_init(&renderer, &scene.field) != 0)
+        return 1;
+
+    struct FixedTimestep step;
+    timestep_init(&step, tick_rate, max_catch_up);
+    if (replay_path)
+        printf("replaying %s (seed %" PRIu64 ", %g Hz)\n", replay_path, playback.replay.header->seed, step.tick_rate);
+    else
+        printf("match seed %lu (replay with: soccersim_headless --seed %lu --tick-rate %g --team-size %d --pitch %gx%g)\n",
+               seed, seed, step.tick_rate, scene.team_size, scene.field.pitch_w, scene.field.pitch_h);
+
+    struct SceneSnapshot previous = { 0 };
+    scene_capture(&scene, &previous);
 
     bool running = true;
     SDL_Event event;
     Uint32 last = SDL_GetTicks();
+    Uint32 last_coach_check = last;
 
     while (running) {
         while (SDL_PollEvent(&event)) {
+            renderer_handle_event(&renderer, &event);
             if (event.type == SDL_QUIT)
                 running = false;
+            else if (event.type == SDL_KEYDOWN && replay_path &&
+                     handle_replay_key(&playback, &scene, event.key.keysym.sym, &paused))
+                scene_capture(&scene, &previous);
         }
 
         const Uint32 now = SDL_GetTicks();
-        const float dt = (now - last) / 1000.0f;
+        const float frame_time = (now - last) / 1000.0f;
         last = now;
 
-        update_scene(&scene, dt);
-        renderer_draw_scene(&renderer, &scene);
+        if (now - last_coach_check >= COACH_RELOAD_CHECK_MS) {
+            reload_changed_coaches(coaches, &scene);
+            last_coach_check = now;
+        }
+
+        // Physics only ever sees step.dt, so results match headless runs at the same tick rate.
+        const int steps = timestep_advance(&step, frame_time);
+        for (int i = 0; i < steps; i++) {
+            if (replay_path && (paused || playback.ended)) {
+                scene_capture(&scene, &previous);   // hold the frame still
+                break;
+            }
+            scene_capture(&scene, &previous);
+            if (!replay_path)
+                update_scene(&scene, step.dt);
+            else if (playback_step(&playback, &scene) < 0) {
+                fprintf(stderr, "%s: corrupt recording after tick %lu\n", replay_path, playback.frame.tick);
+                playback.ended = true;
+            }
+        }
+
+        renderer_draw_scene(&renderer, &scene, &previous, timestep_alpha(&step));
 
         SDL_Delay(16);
     }
 
+    if (replay_path)
+        playback_close(&playback);
     renderer_destroy(&renderer);
+    scene_snapshot_free(&previous);
+    destroy_scene(&scene);
+    free(scene.ball);
+    coach_plugin_unload(&coaches[0]);
+    coach_plugin_unload(&coaches[1]);
     return 0;
 }
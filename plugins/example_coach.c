@@ -0,0 +1,166 @@
+/**
+ * @file example_coach.c
+ * @brief A small coach plugin: a template for writing your own as a `.so`.
+ * * Build it with the `coach_example` target and pass it to any tool with
+ * `--coach1 FILE` / `--coach2 FILE`. The viewer reloads it whenever the file
+ * changes, so you can rebuild while a match is running.
+ *
+ * The team keeps a shape that slides with the ball: the player nearest the
+ * ball presses it, the others hold their lane, and the keeper shadows the
+ * ball along the goal line. With the ball, shoot when close to goal,
+ * otherwise pass to the most advanced teammate if they are ahead and free.
+ * It only reads the scene, like any coach, and keeps no state of its own.
+ */
+#include <math.h>
+
+#include "core/constants.h"
+#include "entities/ball.h"
+#include "game/perception.h"
+#include "game/scene.h"
+#include "logic/coach_plugin.h"
+
+#define GOALKEEPER_KIT 3
+#define SHOOTING_RANGE 260.0f
+#define MARKING_DISTANCE 60.0f
+
+/** @brief Lanes as (depth, y offset); depth is from the own goal line, towards the other goal. */
+static const struct Vec2 lanes[DEFAULT_TEAM_SIZE] = {
+    {420, 0}, {300, -160}, {160, -90}, {0, 0}, {160, 90}, {300, 160},
+};
+
+/** @brief The lane (and talents row) of `kit`: bigger squads double up the outfield lanes. */
+static int lane_of(int kit) {
+    static const int outfield[] = { 0, 1, 2, 4, 5 };
+    return kit < DEFAULT_TEAM_SIZE ? kit : outfield[(kit - DEFAULT_TEAM_SIZE) % 5];
+}
+
+static float speed_of(const struct Player *self) {
+    return ((float)self->talents.agility / MAX_TALENT_PER_SKILL) * MAX_PLAYER_VELOCITY;
+}
+
+static float power_of(const struct Player *self) {
+    return ((float)self->talents.shooting / MAX_TALENT_PER_SKILL) * MAX_BALL_VELOCITY;
+}
+
+static void run_to(struct Player *self, float x, float y) {
+    const float dx = x - self->position.x;
+    const float dy = y - self->position.y;
+    const float d = hypotf(dx, dy);
+    if (d < 2.0f) {
+        self->velocity.x = 0.0f;
+        self->velocity.y = 0.0f;
+        return;
+    }
+    self->velocity.x = dx / d * speed_of(self);
+    self->velocity.y = dy / d * speed_of(self);
+}
+
+static void kick_to(struct Player *self, struct Scene *scene, float x, float y, float power) {
+    const float dx = x - self->position.x;
+    const float dy = y - self->position.y;
+    const float d = hypotf(dx, dy);
+    scene->ball->velocity.x = d > 0.001f ? dx / d * power : 0.0f;
+    scene->ball->velocity.y = d > 0.001f ? dy / d * power : 0.0f;
+}
+
+static void example_movement(struct Player *self, struct Scene *scene) {
+    const struct Ball *ball = scene->ball;
+    const Field *field = &scene->field;
+    const float own_goal_x = (self->team == 1) ? field->pitch_x : field->pitch_x + field->pitch_w;
+    const float forward = (self->team == 1) ? 1.0f : -1.0f;
+    const float center_y = field->center_y;
+
+    if (self->kit == GOALKEEPER_KIT) {
+        const float half = field->goal_height / 2.0f;
+        float y = ball->position.y;
+        y = y < center_y - half ? center_y - half : (y > center_y + half ? center_y + half : y);
+        run_to(self, own_goal_x + forward * PLAYER_RADIUS, y);
+        return;
+    }
+    if (perception_nearest_to_ball(scene, self->team) == self) {
+        run_to(self, ball->position.x, ball->position.y);
+        return;
+    }
+    // hold the lane, shifted halfway towards the ball
+    const struct Vec2 lane = lanes[lane_of(self->kit)];
+    const float x = own_goal_x + forward * lane.x + (ball->position.x - field->center_x) * 0.5f;
+    run_to(self, x, center_y + lane.y + (ball->position.y - center_y) * 0.3f);
+}
+
+static void example_shooting(struct Player *self, struct Scene *scene) {
+    const enum PerceptionGoal target = (self->team == 1) ? GOAL_RIGHT : GOAL_LEFT;
+    const Field *field = &scene->field;
+    const float goal_x = (self->team == 1) ? field->pitch_x + field->pitch_w : field->pitch_x;
+
+    if (perception_goal_distance(scene, self, target) < SHOOTING_RANGE) {
+        const float y = field->center_y + (rng_float(&scene->rng) - 0.5f) * (field->goal_height - 4 * BALL_RADIUS);
+        kick_to(self, scene, goal_x, y, power_of(self));
+        return;
+    }
+    struct Player *mate = perception_most_advanced(scene, self->team, self);
+    if (mate && perception_goal_distance(scene, mate, target) < perception_goal_distance(scene, self, target) &&
+        perception_players_within(scene, mate->position, MARKING_DISTANCE, 3 - self->team, NULL, 0) == 0) {
+        kick_to(self, scene, mate->position.x, mate->position.y, power_of(self) * 0.8f);
+        return;
+    }
+    kick_to(self, scene, goal_x, field->center_y, power_of(self));
+}
+
+static void example_change_state(struct Player *self, struct Scene *scene) {
+    if (scene->ball->possessor == self)
+        self->state = SHOOTING;
+    else if (perception_touches_ball(scene, self))
+        self->state = INTERCEPTING;
+    else
+        self->state = MOVING;
+}
+
+static PlayerLogicFn movement(int team, int kit) {
+    (void)team;
+    (void)kit;
+    return example_movement;
+}
+
+static PlayerLogicFn shooting(int team, int kit) {
+    (void)team;
+    (void)kit;
+    return example_shooting;
+}
+
+static PlayerLogicFn change_state(int team, int kit) {
+    (void)team;
+    (void)kit;
+    return example_change_state;
+}
+
+/* defence, agility, dribbling, shooting; at most MAX_TALENT_PER_PLAYER in total */
+static struct Talents talents(int team, int kit) {
+    static const struct Talents table[DEFAULT_TEAM_SIZE] = {
+        {2, 6, 5, 7}, {4, 6, 5, 5}, {7, 6, 4, 3}, {8, 4, 2, 6}, {7, 6, 4, 3}, {4, 6, 5, 5},
+    };
+    (void)team;
+    return table[lane_of(kit)];
+}
+
+/* kick-off positions on the default pitch: own half, outside the centre circle */
+static struct Vec2 positions(int team, int kit) {
+    const Field field = field_default();
+    const struct Vec2 lane = lanes[lane_of(kit)];
+    const float depth = lane.x < 320.0f ? lane.x : 320.0f;
+    // players sharing a lane line up behind each other
+    const int rank = kit < DEFAULT_TEAM_SIZE ? 0 : (kit - DEFAULT_TEAM_SIZE) / 5 + 1;
+    const float behind = (float)rank * 2.5f * PLAYER_RADIUS;
+    const float x = PLAYER_RADIUS + (depth > behind ? depth - behind : 0.0f);
+    const struct Vec2 left = { field.pitch_x + x, field.center_y + lane.y };
+    const struct Vec2 right = { field.pitch_x + field.pitch_w - x, field.center_y + lane.y };
+    return (team == 1) ? left : right;
+}
+
+static const struct CoachApi api =
+    COACH_API_INIT("example", movement, shooting, change_state, talents, positions);
+
+const struct CoachApi *soccer_coach_api(void);
+
+const struct CoachApi *soccer_coach_api(void) {
+    return &api;
+}
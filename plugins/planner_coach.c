@@ -0,0 +1,131 @@
+/**
+ * @file planner_coach.c
+ * @brief A coach plugin that plans its kicks with rollouts (game/rollout.h).
+ * * Off the ball it plays like the built-in coach. With the ball, in open
+ * play, it tries a pass to every teammate and shots at both posts and the
+ * middle of the goal: each candidate is played 2 seconds ahead in the
+ * scene's rollout at 15 Hz, scored (a goal, who has the ball at the end, how
+ * far up the pitch it got) and the best one is kicked. Kick-offs, and any
+ * kick once the tick's rollout budget is spent, go to the built-in coach.
+ */
+#include <math.h>
+
+#include "core/constants.h"
+#include "entities/ball.h"
+#include "entities/team.h"
+#include "game/rollout.h"
+#include "game/scene.h"
+#include "logic/coach_plugin.h"
+
+#define LOOKAHEAD_TICKS 30
+#define LOOKAHEAD_DT (1.0f / 15.0f)
+#define PASS_POWER 0.85f
+
+static float power_of(const struct Player *self) {
+    return ((float)self->talents.shooting / MAX_TALENT_PER_SKILL) * MAX_BALL_VELOCITY;
+}
+
+static struct Vec2 kick_towards(const struct Player *self, float x, float y, float power) {
+    const float dx = x - self->position.x;
+    const float dy = y - self->position.y;
+    const float d = hypotf(dx, dy);
+    const struct Vec2 kick = { d > 0.001f ? dx / d * power : 0.0f, d > 0.001f ? dy / d * power : 0.0f };
+    return kick;
+}
+
+/** @brief How good `outcome` is for `team`: goals first, then keeping the ball, then ground gained. */
+static float score_of(const struct RolloutOutcome *outcome, const struct Scene *scene, int team) {
+    if (outcome->goal)
+        return outcome->goal == team ? 1000.0f : -1000.0f;
+    const Field *field = &scene->field;
+    const float gained = (outcome->ball.x - field->center_x) / field->pitch_w;
+    float score = (team == 1) ? gained : -gained;
+    if (outcome->out)
+        score -= 1.0f;
+    else if (outcome->possessor >= 0)
+        score += (outcome->possessor / scene->team_size + 1 == team) ? 2.0f : -2.0f;
+    return score;
+}
+
+/** @brief Plays `kick` ahead; false if the rollout could not run it in full. */
+static bool try_kick(struct Rollout *rollout, const struct Scene *scene, struct Vec2 kick, int team, float *score) {
+    struct RolloutOutcome outcome;
+    if (rollout_clone(rollout, scene) != 0)
+        return false;
+    rollout_kick(rollout, kick);
+    rollout_run(rollout, LOOKAHEAD_TICKS, LOOKAHEAD_DT, &outcome);
+    if (outcome.exhausted)
+        return false;
+    *score = score_of(&outcome, scene, team);
+    return true;
+}
+
+static void planner_shooting(struct Player *self, struct Scene *scene) {
+    struct Rollout *rollout = (scene->state == STATE_RUNNING) ? scene_rollout(scene) : NULL;
+    const Field *field = &scene->field;
+    const float goal_x = (self->team == 1) ? field->pitch_x + field->pitch_w : field->pitch_x;
+    const float post = field->goal_height / 2.0f - 2.0f * BALL_RADIUS;
+    const struct Team *team = (self->team == 1) ? scene->first_team : scene->second_team;
+    struct Vec2 best_kick = { 0.0f, 0.0f };
+    float best = -INFINITY;
+    bool planned = rollout != NULL;
+
+    for (int c = -1; planned && c <= 1; c++) {
+        const struct Vec2 kick = kick_towards(self, goal_x, field->center_y + (float)c * post, power_of(self));
+        float score;
+        planned = try_kick(rollout, scene, kick, self->team, &score);
+        if (planned && score > best) {
+            best = score;
+            best_kick = kick;
+        }
+    }
+    for (int i = 0; planned && i < team->size; i++) {
+        const struct Player *mate = team->players[i];
+        if (mate == self)
+            continue;
+        const struct Vec2 kick = kick_towards(self, mate->position.x, mate->position.y, power_of(self) * PASS_POWER);
+        float score;
+        planned = try_kick(rollout, scene, kick, self->team, &score);
+        if (planned && score > best) {
+            best = score;
+            best_kick = kick;
+        }
+    }
+
+    if (planned) {
+        scene->ball->velocity = best_kick;
+        return;
+    }
+    coach_builtin()->shooting_logic(self->team, self->kit)(self, scene);
+}
+
+static PlayerLogicFn movement(int team, int kit) {
+    return coach_builtin()->movement_logic(team, kit);
+}
+
+static PlayerLogicFn shooting(int team, int kit) {
+    (void)team;
+    (void)kit;
+    return planner_shooting;
+}
+
+static PlayerLogicFn change_state(int team, int kit) {
+    return coach_builtin()->change_state_logic(team, kit);
+}
+
+static struct Talents talents(int team, int kit) {
+    return coach_builtin()->talents(team, kit);
+}
+
+static struct Vec2 positions(int team, int kit) {
+    return coach_builtin()->positions(team, kit);
+}
+
+static const struct CoachApi api =
+    COACH_API_INIT("planner", movement, shooting, change_state, talents, positions);
+
+const struct CoachApi *soccer_coach_api(void);
+
+const struct CoachApi *soccer_coach_api(void) {
+    return &api;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file possession_grid.c
+ * @brief Checks that update_ball_possessor() gives the same answer through
+ * the perception grid as by its plain scan.
+ * * For every seed, two copies of the same match are played a few seconds in.
+ * The ball is then put at one player's feet and made to have run into the
+ * player farthest from it (Scene::ball_contact), out of reach of the grid's
+ * radius query; both are set INTERCEPTING, along with a few others. One copy
+ * resolves possession with the grid up to date, the other by the scan; the
+ * holder and the random stream must come out the same. Exits non-zero if
+ * any seed differs.
+ */
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "core/constants.h"
+#include "core/log.h"
+#include "core/rng.h"
+#include "entities/ball.h"
+#include "game/batch.h"
+#include "game/grid.h"
+#include "game/perception.h"
+#include "game/possession.h"
+#include "game/scene.h"
+#include "game/timestep.h"
+
+#define SEEDS 50
+#define TEAM_SIZE 11
+#define WARMUP_SECONDS 3.0f
+
+/** @brief Puts the ball on `near` and the last contact on the player farthest from it; returns that player. */
+static int stage(Scene* scene, int near, struct Rng* rng) {
+    struct Roster* roster = &scene->roster;
+    struct Ball* ball = scene->ball;
+    ball->possessor = NULL;
+    ball->position.x = roster->pos_x[near];
+    ball->position.y = roster->pos_y[near];
+
+    int far = -1;
+    float far_d2 = -1.0f;
+    for (int i = 0; i < roster->count; i++) {
+        const float dx = roster->pos_x[i] - ball->position.x;
+        const float dy = roster->pos_y[i] - ball->position.y;
+        if (dx * dx + dy * dy > far_d2) {
+            far = i;
+            far_d2 = dx * dx + dy * dy;
+        }
+    }
+    for (int i = 0; i < roster->count; i++)
+        roster->state[i] = (i == near || i == far || rng_range(rng, 3) == 0) ? INTERCEPTING : IDLE;
+    scene->ball_contact = far;
+    return far;
+}
+
+int main(void) {
+    const float dt = 1.0f / DEFAULT_TICK_RATE;
+    int failures = 0;
+    log_configure("off");
+    for (uint64_t seed = 1; seed <= SEEDS; seed++) {
+        const struct MatchSpec spec = { .seed = seed, .length = 120.0f, .tick_rate = DEFAULT_TICK_RATE,
+                                        .team_size = TEAM_SIZE };
+        Scene scenes[2];
+        struct Ball balls[2];
+        int far[2];
+        for (int c = 0; c < 2; c++) {
+            if (batch_setup_scene(&scenes[c], &balls[c], &spec) != 0) {
+                fprintf(stderr, "out of memory\n");
+                return 1;
+            }
+            for (float t = 0.0f; t < WARMUP_SECONDS; t += dt)
+                update_scene(&scenes[c], dt);
+            struct Rng rng;
+            rng_seed(&rng, seed, 1);
+            far[c] = stage(&scenes[c], (int)rng_range(&rng, 2 * TEAM_SIZE), &rng);
+            perception_invalidate(&scenes[c].perception);
+        }
+
+        // copy 0 goes through the grid, copy 1 through the scan
+        struct Grid* grid = perception_grid(&scenes[0]);
+        const float dx = scenes[0].roster.pos_x[far[0]] - balls[0].position.x;
+        const float dy = scenes[0].roster.pos_y[far[0]] - balls[0].position.y;
+        const bool outside = hypotf(dx, dy) > balls[0].radius + grid->max_radius;
+        update_ball_possessor(&scenes[0]);
+        update_ball_possessor(&scenes[1]);
+
+        const int holder[2] = { roster_handle(&scenes[0].roster, balls[0].possessor),
+                                roster_handle(&scenes[1].roster, balls[1].possessor) };
+        if (!outside || holder[0] != holder[1] || memcmp(&scenes[0].rng, &scenes[1].rng, sizeof(struct Rng)) != 0) {
+            fprintf(stderr, "seed %" PRIu64 ": contact %d %s the query radius, grid holder %d, scan holder %d%s\n",
+                    seed, far[0], outside ? "outside" : "inside", holder[0], holder[1],
+                    memcmp(&scenes[0].rng, &scenes[1].rng, sizeof(struct Rng)) ? ", random streams differ" : "");
+            failures++;
+        }
+        destroy_scene(&scenes[0]);
+        destroy_scene(&scenes[1]);
+    }
+    log_shutdown();
+    printf("%d seeds, %d failures\n", SEEDS, failures);
+    return failures ? 1 : 0;
+}
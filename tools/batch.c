@@ -0,0 +1,270 @@
+/**
+ * @file batch.c
+ * @brief Plays N seeded matches across all cores and prints one CSV row per match.
+ * * All matches share the seed; match i draws from random stream i, so any row
+ * can be replayed with `soccersim_headless --seed S --stream i`. Rows are
+ * written in match order once
+ * every worker is done, so the output is identical for any --threads value.
+ * With --record-dir every match is also kept as DIR/match_NNNNNN.srpl, and
+ * --violations writes the referee's per-player rule tallies as CSV.
+ * With --checkpoint-dir every match saves its state as it plays, so a batch
+ * killed part way through (e.g. a preempted job) can be rerun with the same
+ * options and only replays the time since each match's last checkpoint.
+ */
+#define _POSIX_C_SOURCE 200112L // clock_gettime
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "core/constants.h"
+#include "core/log.h"
+#include "core/profile.h"
+#include "game/batch.h"
+#include "game/timestep.h"
+#include "logic/coach_loader.h"
+#include "replay/format.h"
+
+static void print_usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [--matches N] [--seed N] [--threads N] [--length SECONDS]\n"
+            "          [--tick-rate HZ] [--no-pin] [--output FILE] [--record-dir DIR]\n"
+            "          [--violations FILE] [--log SPEC] [--profile] [--trace FILE]\n"
+            "          [--coach1 FILE] [--coach2 FILE] [--team-size N] [--pitch WxH] [--collisions]\n"
+            "          [--checkpoint-dir DIR] [--checkpoint-every SECONDS]\n"
+            "  --matches N        number of matches to play (default 100)\n"
+            "  --seed N           batch seed; match i uses stream i of it (default %d)\n"
+            "  --threads N        worker threads (default: one per online CPU)\n"
+            "  --length SECONDS   match length in game seconds (default 120)\n"
+            "  --tick-rate HZ     simulation ticks per game second (default 60)\n"
+            "  --no-pin           do not pin workers to CPUs\n"
+            "  --output FILE      write the CSV there instead of stdout\n"
+            "  --record-dir DIR   record match i to DIR/match_<i>.srpl (DIR must exist);\n"
+            "                     at most %d players per side\n"
+            "  --violations FILE  write every player's rule violations to FILE as CSV\n"
+            "  --log SPEC         log levels, e.g. warn or rules=off,match=info (default info)\n"
+            "  --coach1 FILE      coach plugin (.so) for team 1 (default: the built-in coach)\n"
+            "  --coach2 FILE      coach plugin (.so) for team 2\n"
+            "  --team-size N      players per side, 1 to %d (default %d)\n"
+            "  --pitch WxH        pitch size in px (default %gx%g)\n"
+            "  --collisions       push overlapping players apart (off by default)\n"
+            "  --checkpoint-dir DIR  checkpoint match i to DIR/match_<i>.sckp as it plays and resume\n"
+            "                     from there when rerun (DIR must exist)\n"
+            "  --checkpoint-every SECONDS  game time between checkpoints (default 10)\n"
+            "  --profile          time the tick phases; p50/p99/max per phase go to stderr at exit\n"
+            "  --trace FILE       also write every timed phase to FILE as Chrome trace JSON\n",
+            prog, SEED, REPLAY_MAX_TEAM_SIZE, MAX_TEAM_SIZE, DEFAULT_TEAM_SIZE,
+            field_default().pitch_w, field_default().pitch_h);
+}
+
+/** @brief Frees every result's tallies, then the array. */
+static void free_results(struct MatchResult *results, int count) {
+    for (int i = 0; results && i < count; i++)
+        match_result_free(&results[i]);
+    free(results);
+}
+
+int main(int argc, char **argv) {
+    int matches = 100;
+    uint64_t seed = SEED;
+    int threads = 0;
+    float match_length = 120.0f;
+    float tick_rate = DEFAULT_TICK_RATE;
+    bool pin = true;
+    const char *output = NULL;
+    const char *violations_path = NULL;
+    const char *record_dir = NULL;
+    const char *checkpoint_dir = NULL;
+    float checkpoint_every = 10.0f;
+    const char *coach_paths[2] = { NULL, NULL };
+    int team_size = DEFAULT_TEAM_SIZE;
+    Field field = field_default();
+    bool body_collisions = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--matches") == 0 && value) {
+            matches = atoi(value);
+            i++;
+        } else if (strcmp(arg, "--seed") == 0 && value) {
+            seed = strtoull(value, NULL, 10);
+            i++;
+        } else if (strcmp(arg, "--threads") == 0 && value) {
+            threads = atoi(value);
+            i++;
+        } else if (strcmp(arg, "--length") == 0 && value) {
+            match_length = strtof(value, NULL);
+            i++;
+        } else if (strcmp(arg, "--tick-rate") == 0 && value) {
+            tick_rate = strtof(value, NULL);
+            i++;
+        } else if (strcmp(arg, "--no-pin") == 0) {
+            pin = false;
+        } else if (strcmp(arg, "--output") == 0 && value) {
+            output = value;
+            i++;
+        } else if (strcmp(arg, "--record-dir") == 0 && value) {
+            record_dir = value;
+            i++;
+        } else if (strcmp(arg, "--checkpoint-dir") == 0 && value) {
+            checkpoint_dir = value;
+            i++;
+        } else if (strcmp(arg, "--checkpoint-every") == 0 && value && strtof(value, NULL) > 0.0f) {
+            checkpoint_every = strtof(value, NULL);
+            i++;
+        } else if (strcmp(arg, "--violations") == 0 && value) {
+            violations_path = value;
+            i++;
+        } else if (strcmp(arg, "--log") == 0 && value && log_configure(value) == 0) {
+            i++;
+        } else if (strcmp(arg, "--coach1") == 0 && value) {
+            coach_paths[0] = value;
+            i++;
+        } else if (strcmp(arg, "--coach2") == 0 && value) {
+            coach_paths[1] = value;
+            i++;
+        } else if (strcmp(arg, "--team-size") == 0 && value && atoi(value) > 0 && atoi(value) <= MAX_TEAM_SIZE) {
+            team_size = atoi(value);
+            i++;
+        } else if (strcmp(arg, "--pitch") == 0 && value && field_parse(value, &field) == 0) {
+            i++;
+        } else if (strcmp(arg, "--collisions") == 0) {
+            body_collisions = true;
+        } else if (strcmp(arg, "--profile") == 0) {
+            profile_start(NULL);
+        } else if (strcmp(arg, "--trace") == 0 && value) {
+            profile_start(value);
+            i++;
+        } else {
+            print_usage(argv[0]);
+            return (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) ? 0 : 1;
+        }
+    }
+
+    if (matches < 1 || match_length <= 0.0f || tick_rate <= 0.0f) {
+        fprintf(stderr, "match count, length and tick rate must be positive\n");
+        return 1;
+    }
+    if (record_dir && team_size > REPLAY_MAX_TEAM_SIZE) {
+        fprintf(stderr, "--record-dir: a recording holds at most %d players per side (%d entities with the ball)\n",
+                REPLAY_MAX_TEAM_SIZE, REPLAY_MAX_ENTITIES);
+        return 1;
+    }
+    if (threads < 1)
+        threads = batch_cpu_count();
+
+    struct CoachPlugin coaches[2];
+    memset(coaches, 0, sizeof(coaches));
+    for (int t = 0; t < 2; t++) {
+        if (coach_paths[t] && coach_plugin_load(&coaches[t], coach_paths[t]) != 0) {
+            fprintf(stderr, "%s: not a loadable coach plugin\n", coach_paths[t]);
+            return 1;
+        }
+    }
+
+    struct MatchSpec *specs = malloc(sizeof(struct MatchSpec) * (size_t)matches);
+    struct MatchResult *results = calloc((size_t)matches, sizeof(struct MatchResult));
+    const size_t path_size = record_dir ? strlen(record_dir) + sizeof("/match_000000.srpl") + 8 : 0;
+    char *paths = record_dir ? malloc(path_size * (size_t)matches) : NULL;
+    const size_t checkpoint_size = checkpoint_dir ? strlen(checkpoint_dir) + sizeof("/match_000000.sckp") + 8 : 0;
+    char *checkpoints = checkpoint_dir ? malloc(checkpoint_size * (size_t)matches) : NULL;
+    if (!specs || !results || (record_dir && !paths) || (checkpoint_dir && !checkpoints)) {
+        fprintf(stderr, "out of memory\n");
+        free(specs);
+        free(results);
+        free(paths);
+        free(checkpoints);
+        return 1;
+    }
+
+    for (int i = 0; i < matches; i++) {
+        specs[i].seed = seed;
+        specs[i].stream = (uint64_t)i;
+        specs[i].length = match_length;
+        specs[i].tick_rate = tick_rate;
+        specs[i].record_path = NULL;
+        specs[i].coaches[0] = coaches[0].api;
+        specs[i].coaches[1] = coaches[1].api;
+        specs[i].team_size = team_size;
+        specs[i].field = field;
+        specs[i].body_collisions = body_collisions;
+        if (record_dir) {
+            char *path = paths + path_size * (size_t)i;
+            snprintf(path, path_size, "%s/match_%06d.srpl", record_dir, i);
+            specs[i].record_path = path;
+        }
+        specs[i].checkpoint_path = NULL;
+        specs[i].checkpoint_every = checkpoint_every;
+        specs[i].resume_path = NULL;
+        if (checkpoint_dir) {
+            char *path = checkpoints + checkpoint_size * (size_t)i;
+            snprintf(path, checkpoint_size, "%s/match_%06d.sckp", checkpoint_dir, i);
+            specs[i].checkpoint_path = path;
+        }
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int status = batch_run(specs, results, matches, threads, pin);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    coach_plugin_unload(&coaches[0]);
+    coach_plugin_unload(&coaches[1]);
+
+    if (status != 0) {
+        fprintf(stderr, "batch run failed\n");
+        free(specs);
+        free_results(results, matches);
+        free(paths);
+        free(checkpoints);
+        return 1;
+    }
+
+    FILE *out = output ? fopen(output, "w") : stdout;
+    if (!out) {
+        perror(output);
+        free(specs);
+        free_results(results, matches);
+        free(paths);
+        free(checkpoints);
+        return 1;
+    }
+
+    unsigned long total_ticks = 0;
+    fprintf(out, "match,seed,stream,first_score,second_score,ticks\n");
+    for (int i = 0; i < matches; i++) {
+        fprintf(out, "%d,%" PRIu64 ",%" PRIu64 ",%u,%u,%lu\n", i, results[i].seed, results[i].stream,
+                results[i].first_score, results[i].second_score, results[i].ticks);
+        total_ticks += results[i].ticks;
+    }
+    if (out != stdout)
+        fclose(out);
+
+    if (violations_path) {
+        FILE *violations = fopen(violations_path, "w");
+        if (!violations) {
+            perror(violations_path);
+            free(specs);
+            free_results(results, matches);
+            free(paths);
+            free(checkpoints);
+            return 1;
+        }
+        violations_write_csv_header(violations);
+        for (int i = 0; i < matches; i++)
+            violations_write_csv(violations, &results[i].violations, results[i].seed, results[i].stream);
+        fclose(violations);
+    }
+
+    double elapsed = (double)(end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    fprintf(stderr, "%d matches on %d threads in %.3f s (%.0f ticks/s)\n", matches, threads,
+            elapsed, elapsed > 0.0 ? (double)total_ticks / elapsed : 0.0);
+
+    free(specs);
+    free_results(results, matches);
+    free(paths);
+    free(checkpoints);
+    return 0;
+}
@@ -0,0 +1,187 @@
+/**
+ * @file headless.c
+ * @brief Runs a single match without a window, as fast as the CPU allows.
+ * * This binary links only the engine core (no SDL), so it can be used on
+ * batch servers that have no display. Every tick advances the game clock
+ * by a fixed 1 / tick-rate seconds, without waiting on a wall clock.
+ * With --checkpoint the match state is saved periodically and a rerun picks
+ * up where it stopped; --resume plays on from any checkpoint, e.g. with other
+ * coaches to see how the rest of the match would have gone.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "core/constants.h"
+#include "core/log.h"
+#include "core/profile.h"
+#include "game/batch.h"
+#include "game/timestep.h"
+#include "logic/coach_loader.h"
+#include "replay/format.h"
+
+static void print_usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [--seed N] [--stream N] [--length SECONDS] [--tick-rate HZ] [--record FILE]\n"
+            "          [--violations FILE] [--log SPEC] [--profile] [--trace FILE]\n"
+            "          [--coach1 FILE] [--coach2 FILE] [--team-size N] [--pitch WxH] [--collisions]\n"
+            "          [--checkpoint FILE] [--checkpoint-every SECONDS] [--resume FILE]\n"
+            "  --seed N           match seed (default %d)\n"
+            "  --stream N         random substream of the seed (default 0)\n"
+            "  --length SECONDS   match length in game seconds (default 120)\n"
+            "  --tick-rate HZ     simulation ticks per game second (default 60)\n"
+            "  --record FILE      record the match to FILE (.srpl); at most %d players per side\n"
+            "  --violations FILE  write every player's rule violations to FILE as CSV\n"
+            "  --log SPEC         log levels, e.g. warn or rules=off,match=info (default info)\n"
+            "  --coach1 FILE      coach plugin (.so) for team 1 (default: the built-in coach)\n"
+            "  --coach2 FILE      coach plugin (.so) for team 2\n"
+            "  --team-size N      players per side, 1 to %d (default %d)\n"
+            "  --pitch WxH        pitch size in px (default %gx%g)\n"
+            "  --collisions       push overlapping players apart (off by default)\n"
+            "  --checkpoint FILE  save the match state to FILE as it plays; if FILE exists,\n"
+            "                     resume from it (seed and stream must match)\n"
+            "  --checkpoint-every SECONDS  game time between checkpoints (default 10)\n"
+            "  --resume FILE      play on from the checkpoint in FILE with the given coaches;\n"
+            "                     seed, length, tick rate, team size and pitch come from FILE\n"
+            "  --profile          time the tick phases; p50/p99/max per phase go to stderr at exit\n"
+            "  --trace FILE       also write every timed phase to FILE as Chrome trace JSON\n",
+            prog, SEED, REPLAY_MAX_TEAM_SIZE, MAX_TEAM_SIZE, DEFAULT_TEAM_SIZE,
+            field_default().pitch_w, field_default().pitch_h);
+}
+
+int main(int argc, char **argv) {
+    uint64_t seed = SEED;
+    uint64_t stream = 0;
+    float match_length = 120.0f;
+    float tick_rate = DEFAULT_TICK_RATE;
+    const char *record_path = NULL;
+    const char *violations_path = NULL;
+    const char *coach_paths[2] = { NULL, NULL };
+    int team_size = DEFAULT_TEAM_SIZE;
+    Field field = field_default();
+    bool body_collisions = false;
+    const char *checkpoint_path = NULL;
+    float checkpoint_every = 10.0f;
+    const char *resume_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--seed") == 0 && value) {
+            seed = strtoull(value, NULL, 10);
+            i++;
+        } else if (strcmp(arg, "--stream") == 0 && value) {
+            stream = strtoull(value, NULL, 10);
+            i++;
+        } else if (strcmp(arg, "--length") == 0 && value) {
+            match_length = strtof(value, NULL);
+            i++;
+        } else if (strcmp(arg, "--tick-rate") == 0 && value) {
+            tick_rate = strtof(value, NULL);
+            i++;
+        } else if (strcmp(arg, "--record") == 0 && value) {
+            record_path = value;
+            i++;
+        } else if (strcmp(arg, "--violations") == 0 && value) {
+            violations_path = value;
+            i++;
+        } else if (strcmp(arg, "--log") == 0 && value && log_configure(value) == 0) {
+            i++;
+        } else if (strcmp(arg, "--coach1") == 0 && value) {
+            coach_paths[0] = value;
+            i++;
+        } else if (strcmp(arg, "--coach2") == 0 && value) {
+            coach_paths[1] = value;
+            i++;
+        } else if (strcmp(arg, "--team-size") == 0 && value && atoi(value) > 0 && atoi(value) <= MAX_TEAM_SIZE) {
+            team_size = atoi(value);
+            i++;
+        } else if (strcmp(arg, "--pitch") == 0 && value && field_parse(value, &field) == 0) {
+            i++;
+        } else if (strcmp(arg, "--collisions") == 0) {
+            body_collisions = true;
+        } else if (strcmp(arg, "--checkpoint") == 0 && value) {
+            checkpoint_path = value;
+            i++;
+        } else if (strcmp(arg, "--checkpoint-every") == 0 && value && strtof(value, NULL) > 0.0f) {
+            checkpoint_every = strtof(value, NULL);
+            i++;
+        } else if (strcmp(arg, "--resume") == 0 && value) {
+            resume_path = value;
+            i++;
+        } else if (strcmp(arg, "--profile") == 0) {
+            profile_start(NULL);
+        } else if (strcmp(arg, "--trace") == 0 && value) {
+            profile_start(value);
+            i++;
+        } else {
+            print_usage(argv[0]);
+            return (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) ? 0 : 1;
+        }
+    }
+
+    if (match_length <= 0.0f || tick_rate <= 0.0f) {
+        fprintf(stderr, "match length and tick rate must be positive\n");
+        return 1;
+    }
+    if (record_path && team_size > REPLAY_MAX_TEAM_SIZE) {
+        fprintf(stderr, "--record: a recording holds at most %d players per side (%d entities with the ball)\n",
+                REPLAY_MAX_TEAM_SIZE, REPLAY_MAX_ENTITIES);
+        return 1;
+    }
+
+    struct CoachPlugin coaches[2];
+    memset(coaches, 0, sizeof(coaches));
+    for (int t = 0; t < 2; t++) {
+        if (coach_paths[t] && coach_plugin_load(&coaches[t], coach_paths[t]) != 0) {
+            fprintf(stderr, "%s: not a loadable coach plugin\n", coach_paths[t]);
+            return 1;
+        }
+    }
+
+    struct MatchSpec spec = { .seed = seed, .stream = stream, .length = match_length, .tick_rate = tick_rate,
+                              .record_path = record_path, .coaches = { coaches[0].api, coaches[1].api },
+                              .team_size = team_size, .field = field,
+                              .body_collisions = body_collisions,
+                              .checkpoint_path = checkpoint_path, .checkpoint_every = checkpoint_every,
+                              .resume_path = resume_path };
+    struct MatchResult result;
+
+    clock_t start = clock();
+    const int status = run_match(&spec, &result);
+    // profile_finish() runs at exit, after the plugins are gone: it only reads engine memory
+    coach_plugin_unload(&coaches[0]);
+    coach_plugin_unload(&coaches[1]);
+    if (status != 0) {
+        if (checkpoint_path || resume_path)
+            fprintf(stderr, "could not resume or checkpoint the match%s\n",
+                    record_path ? " (a resumed match cannot be recorded)" : "");
+        else if (record_path)
+            fprintf(stderr, "could not record the match to %s\n", record_path);
+        else
+            fprintf(stderr, "could not set up the match: out of memory\n");
+        return 1;
+    }
+    double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("seed %" PRIu64 " stream %" PRIu64 ": team 1 %u - %u team 2\n",
+           result.seed, result.stream, result.first_score, result.second_score);
+    printf("%lu ticks in %.3f s CPU (%.0f ticks/s)\n", result.ticks, elapsed,
+           elapsed > 0.0 ? (double)result.ticks / elapsed : 0.0);
+
+    if (violations_path) {
+        FILE *out = fopen(violations_path, "w");
+        if (!out) {
+            perror(violations_path);
+            return 1;
+        }
+        violations_write_csv_header(out);
+        violations_write_csv(out, &result.violations, result.seed, result.stream);
+        fclose(out);
+    }
+    match_result_free(&result);
+    return 0;
+}
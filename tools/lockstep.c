@@ -0,0 +1,299 @@
+/**
+ * @file lockstep.c
+ * @brief Plays N seeded matches in SIMD lockstep groups and prints one CSV row per match.
+ * * Rows match soccersim_batch for the same --seed (match i uses stream i).
+ * With --verify every group is also played by the scalar kernels and by
+ * plain update_scene(); any bit of difference in positions, velocities,
+ * possession, state or score after any tick makes the run fail.
+ */
+#define _POSIX_C_SOURCE 200112L // clock_gettime
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "core/constants.h"
+#include "core/log.h"
+#include "core/profile.h"
+#include "entities/ball.h"
+#include "entities/team.h"
+#include "game/batch.h"
+#include "game/lockstep.h"
+#include "game/timestep.h"
+#include "logic/coach_loader.h"
+
+static void print_usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [--matches N] [--lanes N] [--seed N] [--length SECONDS]\n"
+            "          [--tick-rate HZ] [--scalar] [--verify] [--log SPEC] [--profile] [--trace FILE]\n"
+            "          [--coach1 FILE] [--coach2 FILE] [--team-size N] [--pitch WxH] [--collisions]\n"
+            "  --matches N        number of matches to play (default 64)\n"
+            "  --lanes N          matches stepped together, 1..%d (default 8)\n"
+            "  --seed N           batch seed; match i uses stream i of it (default %d)\n"
+            "  --length SECONDS   match length in game seconds (default 120)\n"
+            "  --tick-rate HZ     simulation ticks per game second (default %.0f)\n"
+            "  --scalar           use the scalar kernels instead of %s\n"
+            "  --verify           cross-check SIMD, scalar and update_scene() every tick\n"
+            "  --log SPEC         log levels, e.g. warn or rules=off,match=info (default info)\n"
+            "  --coach1 FILE      coach plugin (.so) for team 1 (default: the built-in coach)\n"
+            "  --coach2 FILE      coach plugin (.so) for team 2\n"
+            "  --team-size N      players per side, 1 to %d (default %d)\n"
+            "  --pitch WxH        pitch size in px (default %gx%g)\n"
+            "  --collisions       push overlapping players apart (off by default)\n"
+            "  --profile          time the tick phases; p50/p99/max per phase go to stderr at exit\n"
+            "  --trace FILE       also write every timed phase to FILE as Chrome trace JSON\n",
+            prog, LOCKSTEP_MAX_LANES, SEED, DEFAULT_TICK_RATE, lockstep_isa(),
+            MAX_TEAM_SIZE, DEFAULT_TEAM_SIZE, field_default().pitch_w, field_default().pitch_h);
+}
+
+/** @brief Frees every result's tallies, then the array. */
+static void free_results(struct MatchResult *results, int count) {
+    for (int i = 0; results && i < count; i++)
+        match_result_free(&results[i]);
+    free(results);
+}
+
+/**
+ * @brief Bitwise comparison of everything the physics and referee touch.
+ */
+static bool same_state(const Scene *a, const Scene *b) {
+    const struct Roster *ra = &a->roster;
+    const struct Roster *rb = &b->roster;
+    const size_t floats = sizeof(float) * (size_t)ra->count;
+
+    if (memcmp(ra->pos_x, rb->pos_x, floats) || memcmp(ra->pos_y, rb->pos_y, floats) ||
+        memcmp(ra->vel_x, rb->vel_x, floats) || memcmp(ra->vel_y, rb->vel_y, floats))
+        return false;
+    if (memcmp(&a->ball->position, &b->ball->position, sizeof(struct Vec2)) ||
+        memcmp(&a->ball->velocity, &b->ball->velocity, sizeof(struct Vec2)))
+        return false;
+
+    const long pa = a->ball->possessor ? (long)(a->ball->possessor - ra->views) : -1;
+    const long pb = b->ball->possessor ? (long)(b->ball->possessor - rb->views) : -1;
+    return pa == pb && a->state == b->state &&
+           a->first_team->score == b->first_team->score &&
+           a->second_team->score == b->second_team->score &&
+           violations_equal(&a->violations, &b->violations);
+}
+
+/**
+ * @brief Plays specs[0..lanes) as one lockstep group (plus reference copies when verifying).
+ * @return 0 on success, -1 on allocation failure, 1 on a verification mismatch.
+ */
+static int play_group(const struct MatchSpec *specs, struct MatchResult *results, int lanes,
+                      bool use_simd, bool verify) {
+    const int copies = verify ? 3 : 1;  // [0] tested group, [1] scalar group, [2] update_scene()
+    Scene scenes[3][LOCKSTEP_MAX_LANES];
+    struct Ball balls[3][LOCKSTEP_MAX_LANES];
+    Scene *lanes_of[3][LOCKSTEP_MAX_LANES];
+    struct Lockstep groups[2];
+    int status = 0;
+    memset(groups, 0, sizeof(groups));
+
+    for (int c = 0; c < copies; c++) {
+        for (int l = 0; l < lanes; l++) {
+            if (batch_setup_scene(&scenes[c][l], &balls[c][l], &specs[l]) != 0) {
+                // release the scenes built so far, in the order they were built
+                for (int k = 0; k < c * lanes + l; k++)
+                    destroy_scene(&scenes[k / lanes][k % lanes]);
+                return -1;
+            }
+            lanes_of[c][l] = &scenes[c][l];
+        }
+    }
+
+    if (lockstep_init(&groups[0], lanes_of[0], lanes, use_simd) != 0)
+        status = -1;
+    if (status == 0 && verify && lockstep_init(&groups[1], lanes_of[1], lanes, false) != 0) {
+        lockstep_free(&groups[0]);
+        status = -1;
+    }
+
+    const float dt = 1.0f / specs[0].tick_rate;
+    unsigned long ticks[LOCKSTEP_MAX_LANES] = {0};
+    unsigned long tick = 0;
+
+    while (status == 0) {
+        for (int l = 0; l < lanes; l++)
+            if (scenes[0][l].state != STATE_TIMEOUT)
+                ticks[l]++;
+
+        int running = lockstep_step(&groups[0], dt);
+        tick++;
+
+        if (verify) {
+            lockstep_step(&groups[1], dt);
+            for (int l = 0; l < lanes; l++) {
+                if (scenes[2][l].state != STATE_TIMEOUT)
+                    update_scene(&scenes[2][l], dt);
+                if (!same_state(&scenes[0][l], &scenes[1][l]) ||
+                    !same_state(&scenes[0][l], &scenes[2][l])) {
+                    fprintf(stderr, "lockstep mismatch: seed %" PRIu64 " stream %" PRIu64 " tick %lu\n",
+                            specs[l].seed, specs[l].stream, tick);
+                    status = 1;
+                }
+            }
+        }
+        if (running == 0)
+            break;
+    }
+
+    if (status >= 0 && groups[0].block) {
+        for (int l = 0; l < lanes; l++) {
+            results[l].seed = specs[l].seed;
+            results[l].stream = specs[l].stream;
+            results[l].first_score = scenes[0][l].first_team->score;
+            results[l].second_score = scenes[0][l].second_team->score;
+            results[l].ticks = ticks[l];
+            results[l].violations = scenes[0][l].violations;
+            memset(&scenes[0][l].violations, 0, sizeof(scenes[0][l].violations));
+        }
+        lockstep_free(&groups[0]);
+        if (verify)
+            lockstep_free(&groups[1]);
+    }
+
+    for (int c = 0; c < copies; c++)
+        for (int l = 0; l < lanes; l++)
+            destroy_scene(&scenes[c][l]);
+    return status;
+}
+
+int main(int argc, char **argv) {
+    int matches = 64;
+    int lanes = 8;
+    uint64_t seed = SEED;
+    float match_length = 120.0f;
+    float tick_rate = DEFAULT_TICK_RATE;
+    bool use_simd = true;
+    bool verify = false;
+    const char *coach_paths[2] = { NULL, NULL };
+    int team_size = DEFAULT_TEAM_SIZE;
+    Field field = field_default();
+    bool body_collisions = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--matches") == 0 && value) {
+            matches = atoi(value);
+            i++;
+        } else if (strcmp(arg, "--lanes") == 0 && value) {
+            lanes = atoi(value);
+            i++;
+        } else if (strcmp(arg, "--seed") == 0 && value) {
+            seed = strtoull(value, NULL, 10);
+            i++;
+        } else if (strcmp(arg, "--length") == 0 && value) {
+            match_length = strtof(value, NULL);
+            i++;
+        } else if (strcmp(arg, "--tick-rate") == 0 && value) {
+            tick_rate = strtof(value, NULL);
+            i++;
+        } else if (strcmp(arg, "--scalar") == 0) {
+            use_simd = false;
+        } else if (strcmp(arg, "--log") == 0 && value && log_configure(value) == 0) {
+            i++;
+        } else if (strcmp(arg, "--coach1") == 0 && value) {
+            coach_paths[0] = value;
+            i++;
+        } else if (strcmp(arg, "--coach2") == 0 && value) {
+            coach_paths[1] = value;
+            i++;
+        } else if (strcmp(arg, "--team-size") == 0 && value && atoi(value) > 0 && atoi(value) <= MAX_TEAM_SIZE) {
+            team_size = atoi(value);
+            i++;
+        } else if (strcmp(arg, "--pitch") == 0 && value && field_parse(value, &field) == 0) {
+            i++;
+        } else if (strcmp(arg, "--collisions") == 0) {
+            body_collisions = true;
+        } else if (strcmp(arg, "--profile") == 0) {
+            profile_start(NULL);
+        } else if (strcmp(arg, "--trace") == 0 && value) {
+            profile_start(value);
+            i++;
+        } else if (strcmp(arg, "--verify") == 0) {
+            verify = true;
+        } else {
+            print_usage(argv[0]);
+            return (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) ? 0 : 1;
+        }
+    }
+
+    if (matches < 1 || lanes < 1 || lanes > LOCKSTEP_MAX_LANES ||
+        match_length <= 0.0f || tick_rate <= 0.0f) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    struct CoachPlugin coaches[2];
+    memset(coaches, 0, sizeof(coaches));
+    for (int t = 0; t < 2; t++) {
+        if (coach_paths[t] && coach_plugin_load(&coaches[t], coach_paths[t]) != 0) {
+            fprintf(stderr, "%s: not a loadable coach plugin\n", coach_paths[t]);
+            return 1;
+        }
+    }
+
+    struct MatchSpec *specs = malloc(sizeof(struct MatchSpec) * (size_t)matches);
+    struct MatchResult *results = calloc((size_t)matches, sizeof(struct MatchResult));
+    if (!specs || !results) {
+        fprintf(stderr, "out of memory\n");
+        free(specs);
+        free(results);
+        return 1;
+    }
+
+    for (int i = 0; i < matches; i++) {
+        specs[i].seed = seed;
+        specs[i].stream = (uint64_t)i;
+        specs[i].length = match_length;
+        specs[i].tick_rate = tick_rate;
+        specs[i].record_path = NULL;
+        specs[i].coaches[0] = coaches[0].api;
+        specs[i].coaches[1] = coaches[1].api;
+        specs[i].team_size = team_size;
+        specs[i].field = field;
+        specs[i].body_collisions = body_collisions;
+        specs[i].checkpoint_path = NULL;
+        specs[i].checkpoint_every = 0.0f;
+        specs[i].resume_path = NULL;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int status = 0;
+    for (int first = 0; first < matches && status == 0; first += lanes) {
+        const int count = (matches - first < lanes) ? matches - first : lanes;
+        status = play_group(&specs[first], &results[first], count, use_simd, verify);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    coach_plugin_unload(&coaches[0]);
+    coach_plugin_unload(&coaches[1]);
+
+    if (status != 0) {
+        fprintf(stderr, status < 0 ? "lockstep run failed\n" : "lockstep verification FAILED\n");
+        free(specs);
+        free_results(results, matches);
+        return 1;
+    }
+
+    unsigned long total_ticks = 0;
+    printf("match,seed,stream,first_score,second_score,ticks\n");
+    for (int i = 0; i < matches; i++) {
+        printf("%d,%" PRIu64 ",%" PRIu64 ",%u,%u,%lu\n", i, results[i].seed, results[i].stream,
+               results[i].first_score, results[i].second_score, results[i].ticks);
+        total_ticks += results[i].ticks;
+    }
+
+    double elapsed = (double)(end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    fprintf(stderr, "%d matches, %d lanes, %s kernels%s in %.3f s (%.0f ticks/s)\n", matches, lanes,
+            use_simd ? lockstep_isa() : "scalar", verify ? " (verified)" : "", elapsed,
+            elapsed > 0.0 ? (double)total_ticks / elapsed : 0.0);
+
+    free(specs);
+    free_results(results, matches);
+    return 0;
+}
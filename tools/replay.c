@@ -0,0 +1,198 @@
+/**
+ * @file replay.c
+ * @brief Inspects .srpl match recordings.
+ * * `info FILE` prints the header (seed, talents, kick-off) and the final
+ * score; `dump FILE` decodes every tick to CSV, one row per tick with the
+ * state, possessor, referee event, ball and player positions; `verify FILE`
+ * seeks to every tick and checks that replay_seek() lands on exactly the
+ * state sequential decoding reaches, and plays on identically from there.
+ */
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "logic/referee.h"
+#include "replay/reader.h"
+
+static void print_usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s info FILE\n"
+            "       %s dump FILE\n"
+            "       %s verify FILE\n"
+            "  info   header, talents, kick-off positions and final score\n"
+            "  dump   every decoded tick as CSV\n"
+            "  verify seek to every tick and compare with sequential decoding\n",
+            prog, prog, prog);
+}
+
+static int print_info(const struct Replay *replay, const char *path) {
+    const struct ReplayHeader *h = replay->header;
+    printf("%s: version %u, %zu bytes\n", path, h->version, replay->size);
+    printf("seed %" PRIu64 " stream %" PRIu64 ", %.0f Hz, %.0f s, %u players\n",
+           h->seed, h->stream, h->tick_rate, h->match_length, h->player_count);
+    printf("quantum %g px / %g px/s, dead-band %u / %u\n",
+           h->pos_quantum, h->vel_quantum, h->pos_deadband, h->vel_deadband);
+    if (replay->field)
+        printf("pitch %g x %g at (%g, %g), world %g x %g, goals %g x %g\n",
+               replay->field->pitch_w, replay->field->pitch_h, replay->field->pitch_x, replay->field->pitch_y,
+               replay->field->width, replay->field->height, replay->field->goal_width, replay->field->goal_height);
+    if (replay->footer)
+        printf("index: %" PRIu32 " keyframes every %" PRIu32 " ticks, %" PRIu32 " events\n",
+               replay->footer->keyframe_count, h->keyframe_interval, replay->footer->event_count);
+
+    printf("index,team,kit,defence,agility,dribbling,shooting,x,y\n");
+    for (int i = 0; i < h->player_count; i++) {
+        const struct ReplayEntityInfo *p = &replay->players[i];
+        printf("%d,%u,%u,%u,%u,%u,%u,%.3f,%.3f\n", i, p->team, p->kit,
+               p->talents[0], p->talents[1], p->talents[2], p->talents[3],
+               p->x * h->pos_quantum, p->y * h->pos_quantum);
+    }
+
+    struct ReplayCursor cursor;
+    struct ReplayFrame frame;
+    unsigned goals = 0, outs = 0;
+    int status;
+    replay_rewind(&cursor, replay, &frame);
+    while ((status = replay_next(&cursor, &frame)) == 1) {
+        goals += frame.event == GOAL;
+        outs += frame.event == OUT;
+    }
+    if (status < 0) {
+        fprintf(stderr, "%s: corrupt tick stream at byte %zu\n", path, cursor.offset);
+        return 1;
+    }
+    printf("%lu ticks, %u goals, %u outs, final score %u - %u\n",
+           cursor.tick, goals, outs, cursor.first_score, cursor.second_score);
+    return 0;
+}
+
+static void print_row(const struct ReplayFrame *f) {
+    printf("%lu,%d,%d,%d,%u,%u", f->tick, f->state, f->possessor, f->event,
+           f->first_score, f->second_score);
+    for (int e = 0; e < f->entities; e++)
+        printf(",%.3f,%.3f", f->x[e], f->y[e]);
+    printf("\n");
+}
+
+static int dump(const struct Replay *replay, const char *path) {
+    const int players = replay->header->player_count;
+    printf("tick,state,possessor,event,first_score,second_score");
+    for (int i = 0; i < players; i++)
+        printf(",p%d_x,p%d_y", i, i);
+    printf(",ball_x,ball_y\n");
+
+    struct ReplayCursor cursor;
+    struct ReplayFrame frame;
+    int status;
+    replay_rewind(&cursor, replay, &frame);
+    print_row(&frame);
+    while ((status = replay_next(&cursor, &frame)) == 1)
+        print_row(&frame);
+    if (status < 0) {
+        fprintf(stderr, "%s: corrupt tick stream at byte %zu\n", path, cursor.offset);
+        return 1;
+    }
+    return 0;
+}
+
+static bool same_frame(const struct ReplayFrame *a, const struct ReplayFrame *b) {
+    const size_t floats = sizeof(float) * (size_t)a->entities;
+    return a->tick == b->tick && a->entities == b->entities && a->state == b->state &&
+           a->possessor == b->possessor && a->event == b->event &&
+           a->first_score == b->first_score && a->second_score == b->second_score &&
+           a->remaining_time == b->remaining_time &&
+           memcmp(a->x, b->x, floats) == 0 && memcmp(a->y, b->y, floats) == 0 &&
+           memcmp(a->vx, b->vx, floats) == 0 && memcmp(a->vy, b->vy, floats) == 0;
+}
+
+/** @brief Ticks verify() plays on from every seek. */
+#define VERIFY_PLAY_ON 3
+
+static int verify(const struct Replay *replay, const char *path) {
+    // sequential decoding is the reference; the frames are large, so keep them on the heap
+    struct ReplayCursor *cursors = malloc(sizeof(struct ReplayCursor) * 2);
+    struct ReplayFrame *frames = malloc(sizeof(struct ReplayFrame) * (2 + VERIFY_PLAY_ON));
+    if (!cursors || !frames) {
+        free(cursors);
+        free(frames);
+        return 1;
+    }
+    struct ReplayCursor *sequential = &cursors[0], *seeker = &cursors[1];
+    struct ReplayFrame *expected = &frames[0], *seen = &frames[1], *ahead = &frames[2];
+    unsigned long seeks = 0;
+    int failed = 0;
+
+    // the ticks after each seek are checked against a second sequential pass
+    struct ReplayCursor lookahead;
+    replay_rewind(sequential, replay, expected);
+    replay_rewind(&lookahead, replay, seen);
+    int ahead_count = 0;
+    for (int k = 0; k < VERIFY_PLAY_ON && replay_next(&lookahead, &ahead[k]) == 1; k++)
+        ahead_count++;
+
+    int status = 1;
+    while (status == 1 && !failed) {
+        if (replay_seek(seeker, replay, expected->tick, seen) != 1 || !same_frame(seen, expected)) {
+            fprintf(stderr, "%s: seeking to tick %lu does not match sequential decoding\n", path, expected->tick);
+            failed = 1;
+            break;
+        }
+        for (int k = 0; k < ahead_count; k++) {
+            if (replay_next(seeker, seen) != 1 || !same_frame(seen, &ahead[k])) {
+                fprintf(stderr, "%s: playing on from tick %lu differs at tick %lu\n", path,
+                        expected->tick, ahead[k].tick);
+                failed = 1;
+                break;
+            }
+        }
+        seeks++;
+
+        status = replay_next(sequential, expected);
+        // slide the look-ahead window one tick on
+        for (int k = 1; k < ahead_count; k++)
+            ahead[k - 1] = ahead[k];
+        if (ahead_count > 0 && replay_next(&lookahead, &ahead[ahead_count - 1]) != 1)
+            ahead_count--;
+    }
+    if (status < 0) {
+        fprintf(stderr, "%s: corrupt tick stream at byte %zu\n", path, sequential->offset);
+        failed = 1;
+    }
+
+    // past the end, a seek stops at the last tick
+    if (!failed && replay_seek(seeker, replay, sequential->tick + 1000, seen) != 0) {
+        fprintf(stderr, "%s: seeking past the end did not report the end of the match\n", path);
+        failed = 1;
+    }
+    if (!failed)
+        printf("%s: %lu seeks match sequential decoding (%s)\n", path, seeks,
+               replay->footer ? "keyframe index" : "no index");
+    free(cursors);
+    free(frames);
+    return failed;
+}
+
+int main(int argc, char **argv) {
+    if (argc != 3 || (strcmp(argv[1], "info") != 0 && strcmp(argv[1], "dump") != 0 &&
+                      strcmp(argv[1], "verify") != 0)) {
+        print_usage(argv[0]);
+        return (argc == 2 && (strcmp(argv[1], "--help") == 0 || strcmp(argv[1], "-h") == 0)) ? 0 : 1;
+    }
+
+    struct Replay replay;
+    if (replay_open(&replay, argv[2]) != 0) {
+        fprintf(stderr, "%s: not a readable match recording\n", argv[2]);
+        return 1;
+    }
+    int status;
+    if (strcmp(argv[1], "info") == 0)
+        status = print_info(&replay, argv[2]);
+    else if (strcmp(argv[1], "dump") == 0)
+        status = dump(&replay, argv[2]);
+    else
+        status = verify(&replay, argv[2]);
+    replay_close(&replay);
+    return status;
+}
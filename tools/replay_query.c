@@ -0,0 +1,149 @@
+/**
+ * @file replay_query.c
+ * @brief Lists indexed events across a directory of .srpl recordings.
+ * * Only the header and the index at the end of each file are read (through
+ * mmap), never the tick stream, so scanning thousands of matches for their
+ * goals costs a few pages per file. Prints one CSV row per event, files in
+ * name order; version 1 recordings have no index and are reported and skipped.
+ */
+#define _POSIX_C_SOURCE 200809L // opendir, strdup
+#include <dirent.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "replay/reader.h"
+
+static void print_usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s DIR [--event goal|out|possession|all]\n"
+            "  --event KIND   which indexed events to list (default goal)\n",
+            prog);
+}
+
+static const char *event_name(int kind) {
+    switch (kind) {
+    case REPLAY_EVENT_GOAL: return "goal";
+    case REPLAY_EVENT_OUT: return "out";
+    case REPLAY_EVENT_POSSESSION: return "possession";
+    default: return "unknown";
+    }
+}
+
+static int compare_names(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static bool is_recording(const char *name) {
+    const size_t length = strlen(name);
+    return length > 5 && strcmp(name + length - 5, ".srpl") == 0;
+}
+
+/** @brief Collects the .srpl file names of `dir`, sorted. */
+static char **list_recordings(const char *dir, size_t *count) {
+    DIR *handle = opendir(dir);
+    if (!handle)
+        return NULL;
+
+    char **names = NULL;
+    size_t capacity = 0;
+    *count = 0;
+    struct dirent *entry;
+    while ((entry = readdir(handle)) != NULL) {
+        if (!is_recording(entry->d_name))
+            continue;
+        if (*count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            char **grown = realloc(names, capacity * sizeof(*names));
+            if (!grown)
+                break;
+            names = grown;
+        }
+        if (!(names[*count] = strdup(entry->d_name)))
+            break;
+        (*count)++;
+    }
+    closedir(handle);
+    if (names)
+        qsort(names, *count, sizeof(*names), compare_names);
+    else
+        names = calloc(1, sizeof(*names));  // an empty directory is not an error
+    return names;
+}
+
+int main(int argc, char **argv) {
+    const char *dir = NULL;
+    int kind = REPLAY_EVENT_GOAL;   // 0 lists every kind
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--event") == 0 && value) {
+            if (strcmp(value, "goal") == 0)
+                kind = REPLAY_EVENT_GOAL;
+            else if (strcmp(value, "out") == 0)
+                kind = REPLAY_EVENT_OUT;
+            else if (strcmp(value, "possession") == 0)
+                kind = REPLAY_EVENT_POSSESSION;
+            else if (strcmp(value, "all") == 0)
+                kind = 0;
+            else {
+                print_usage(argv[0]);
+                return 1;
+            }
+            i++;
+        } else if (arg[0] != '-' && !dir) {
+            dir = arg;
+        } else {
+            print_usage(argv[0]);
+            return (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) ? 0 : 1;
+        }
+    }
+    if (!dir) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    size_t count;
+    char **names = list_recordings(dir, &count);
+    if (!names) {
+        fprintf(stderr, "%s: cannot list directory\n", dir);
+        return 1;
+    }
+
+    int status = 0;
+    char path[4096];
+    printf("file,seed,stream,tick,time,event,subject,first_score,second_score\n");
+    for (size_t f = 0; f < count; f++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, names[f]);
+        struct Replay replay;
+        if (replay_open(&replay, path) != 0) {
+            fprintf(stderr, "%s: not a readable match recording\n", path);
+            status = 1;
+            continue;
+        }
+        if (!replay.footer) {
+            fprintf(stderr, "%s: version %u recording has no index\n", path, replay.header->version);
+            replay_close(&replay);
+            continue;
+        }
+
+        const struct ReplayHeader *h = replay.header;
+        for (uint32_t e = 0; e < replay.footer->event_count; e++) {
+            const struct ReplayEvent *event = &replay.events[e];
+            if (kind && event->kind != kind)
+                continue;
+            printf("%s,%" PRIu64 ",%" PRIu64 ",%" PRIu32 ",%.3f,%s,%u,%u,%u\n",
+                   names[f], h->seed, h->stream, event->tick, event->tick / h->tick_rate,
+                   event_name(event->kind), event->subject, event->first_score, event->second_score);
+        }
+        replay_close(&replay);
+    }
+
+    for (size_t f = 0; f < count; f++)
+        free(names[f]);
+    free(names);
+    return status;
+}
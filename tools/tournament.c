@@ -0,0 +1,451 @@
+/**
+ * @file tournament.c
+ * @brief Plays a round-robin or Swiss tournament between coaches and prints the table.
+ * * Every pairing is played from both sides over --seeds match streams of the
+ * tournament seed. Matches run on a work-stealing pool, the slowest pairings
+ * first; each is appended to the --results file as soon as it finishes, and a
+ * rerun with the same options skips everything already in there, so a killed
+ * tournament picks up where it stopped. Any row can be replayed with
+ * `soccersim_headless --seed S --stream N --coach1 HOME --coach2 AWAY`.
+ */
+#define _POSIX_C_SOURCE 200809L // getline, clock_gettime, truncate
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "core/constants.h"
+#include "core/log.h"
+#include "core/profile.h"
+#include "game/batch.h"
+#include "game/timestep.h"
+#include "game/tournament.h"
+#include "logic/coach_loader.h"
+
+#define BUILTIN_COACH "builtin"
+#define RESULTS_MAGIC "# soccersim tournament v1"
+#define CALIBRATION_LENGTH 10.0f   /* game seconds of the self-match that times a coach */
+
+enum Format { FORMAT_ROUND_ROBIN, FORMAT_SWISS };
+
+static void print_usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [--format round-robin|swiss] [--rounds N] [--seeds N] [--seed N]\n"
+            "          [--threads N] [--no-pin] [--length SECONDS] [--tick-rate HZ]\n"
+            "          [--team-size N] [--pitch WxH] [--results FILE] [--log SPEC] [--profile]\n"
+            "          [--trace FILE] COACH COACH...\n"
+            "  COACH              a coach plugin (.so), or \"" BUILTIN_COACH "\" for the built-in coach\n"
+            "  --format F         round-robin (default) or swiss\n"
+            "  --rounds N         Swiss rounds (default: ceil(log2(coaches)))\n"
+            "  --seeds N          match streams per pairing and side (default 2)\n"
+            "  --seed N           tournament seed (default %d)\n"
+            "  --threads N        worker threads (default: one per online CPU)\n"
+            "  --no-pin           do not pin workers to CPUs\n"
+            "  --length SECONDS   match length in game seconds (default 120)\n"
+            "  --tick-rate HZ     simulation ticks per game second (default 60)\n"
+            "  --team-size N      players per side, 1 to %d (default %d)\n"
+            "  --pitch WxH        pitch size in px (default %gx%g)\n"
+            "  --results FILE     stream finished matches to FILE; rerun with the same\n"
+            "                     options to resume a killed tournament\n"
+            "  --log SPEC         log levels, e.g. warn or rules=off,match=info (default info)\n"
+            "  --profile          time the tick phases; p50/p99/max per phase go to stderr at exit\n"
+            "  --trace FILE       also write every timed phase to FILE as Chrome trace JSON\n",
+            prog, SEED, MAX_TEAM_SIZE, DEFAULT_TEAM_SIZE, field_default().pitch_w, field_default().pitch_h);
+}
+
+/**
+ * @struct ResultRow
+ * @brief One match read back from a results file.
+ */
+struct ResultRow {
+    int round, home, away, seed_index;
+    unsigned int home_score, away_score;
+    unsigned long ticks;
+    double seconds;
+    bool used;
+};
+
+/**
+ * @struct Results
+ * @brief The results file: rows already on disk, and the stream new ones go to.
+ */
+struct Results {
+    FILE *file;             /**< NULL without --results. */
+    uint64_t seed;
+    struct ResultRow *rows;
+    int count;
+    int played;             /**< Matches finished in this run, for progress. */
+    int total;
+};
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/** @brief The first line of a results file; a resume needs an exact match. */
+static char *results_header(enum Format format, int rounds, int seeds, uint64_t seed, float length,
+                            float tick_rate, int team_size, const Field *field, char **names, int entries) {
+    size_t size = 256;
+    for (int e = 0; e < entries; e++)
+        size += strlen(names[e]) + 1;
+    char *header = malloc(size);
+    if (!header)
+        return NULL;
+    int n = snprintf(header, size, RESULTS_MAGIC " format=%s rounds=%d seeds=%d seed=%" PRIu64
+                     " length=%g tick_rate=%g team_size=%d pitch=%gx%g coaches=",
+                     format == FORMAT_SWISS ? "swiss" : "round-robin", rounds, seeds, seed,
+                     (double)length, (double)tick_rate, team_size, (double)field->pitch_w, (double)field->pitch_h);
+    for (int e = 0; e < entries; e++)
+        n += snprintf(header + n, size - (size_t)n, "%s%s", e ? "," : "", names[e]);
+    return header;
+}
+
+/**
+ * @brief Reads the rows of an existing results file written with `header`.
+ * A last line cut short by a kill is dropped from the file.
+ * @return 0 on success (also when there is no file yet), -1 if the file belongs to another tournament.
+ */
+static int load_results(const char *path, const char *header, int entries, int seeds,
+                        struct Results *results) {
+    FILE *in = fopen(path, "r");
+    if (!in)
+        return 0;
+
+    char *line = NULL;
+    size_t capacity = 0;
+    ssize_t length;
+    long valid = 0;         // end of the last complete line
+    int status = 0;
+    int line_number = 0;
+    int allocated = 0;
+
+    while ((length = getline(&line, &capacity, in)) > 0) {
+        line_number++;
+        if (line[length - 1] != '\n')
+            break;
+        line[length - 1] = '\0';
+        valid = ftell(in);
+
+        if (line_number == 1) {
+            if (strcmp(line, header) != 0) {
+                fprintf(stderr, "%s holds another tournament:\n  %s\nexpected:\n  %s\n", path, line, header);
+                status = -1;
+                break;
+            }
+            continue;
+        }
+        if (line_number == 2)
+            continue;   // column names
+
+        struct ResultRow row = { 0 };
+        uint64_t seed, stream;
+        if (sscanf(line, "%d,%d,%d,%" SCNu64 ",%" SCNu64 ",%u,%u,%lu,%lf", &row.round, &row.home,
+                   &row.away, &seed, &stream, &row.home_score, &row.away_score, &row.ticks,
+                   &row.seconds) != 9 ||
+            row.round < 1 || row.home < 0 || row.home >= entries || row.away < 0 ||
+            row.away >= entries || stream >= (uint64_t)seeds) {
+            LOG(LOG_WARN, LOG_ENGINE, "%s:%d: skipping malformed row", path, line_number);
+            continue;
+        }
+        row.seed_index = (int)stream;
+        if (results->count == allocated) {
+            allocated = allocated ? allocated * 2 : 256;
+            struct ResultRow *grown = realloc(results->rows, sizeof(*grown) * (size_t)allocated);
+            if (!grown) {
+                status = -1;
+                break;
+            }
+            results->rows = grown;
+        }
+        results->rows[results->count++] = row;
+    }
+    free(line);
+
+    fseek(in, 0, SEEK_END);
+    const long size = ftell(in);
+    fclose(in);
+    if (status == 0 && size > valid && truncate(path, valid) != 0) {
+        perror(path);
+        return -1;
+    }
+    return status;
+}
+
+/** @brief Marks every match already on disk as done, with its recorded outcome. */
+static void apply_results(struct TournamentMatch *matches, int count, struct Results *results) {
+    for (int i = 0; i < count; i++) {
+        struct TournamentMatch *m = &matches[i];
+        for (int r = 0; r < results->count; r++) {
+            struct ResultRow *row = &results->rows[r];
+            if (row->used || row->round != m->round || row->home != m->home || row->away != m->away ||
+                row->seed_index != m->seed_index)
+                continue;
+            m->done = true;
+            m->home_score = row->home_score;
+            m->away_score = row->away_score;
+            m->ticks = row->ticks;
+            m->seconds = row->seconds;
+            row->used = true;
+            break;
+        }
+    }
+}
+
+static void write_result(struct TournamentMatch *match, void *context) {
+    struct Results *results = context;
+    results->played++;
+    if (results->file) {
+        fprintf(results->file, "%d,%d,%d,%" PRIu64 ",%d,%u,%u,%lu,%.6f\n", match->round, match->home,
+                match->away, results->seed, match->seed_index, match->home_score, match->away_score,
+                match->ticks, match->seconds);
+        fflush(results->file);
+    }
+    LOG(LOG_DEBUG, LOG_MATCH, "round %d: %d-%d stream %d: %u-%u (%d/%d)", match->round, match->home,
+        match->away, match->seed_index, match->home_score, match->away_score, results->played,
+        results->total);
+}
+
+/** @brief Wall seconds one game second costs each coach, from a short match against itself. */
+static int calibrate(const struct CoachApi *const *apis, int entries, const struct TournamentConfig *config,
+                     double *rate) {
+    for (int e = 0; e < entries; e++) {
+        struct MatchSpec spec = {
+            .seed = config->seed,
+            .stream = 0,
+            .length = CALIBRATION_LENGTH,
+            .tick_rate = config->tick_rate,
+            .record_path = NULL,
+            .coaches = { apis[e], apis[e] },
+            .team_size = config->team_size,
+            .field = config->field
+        };
+        struct MatchResult result;
+        const double start = now_seconds();
+        if (run_match(&spec, &result) != 0)
+            return -1;
+        rate[e] = (now_seconds() - start) / CALIBRATION_LENGTH;
+        match_result_free(&result);
+    }
+    return 0;
+}
+
+static void estimate_costs(struct TournamentMatch *matches, int count, const double *rate, float length) {
+    for (int i = 0; i < count; i++)
+        matches[i].cost = (rate[matches[i].home] + rate[matches[i].away]) * 0.5 * length;
+}
+
+static int count_pending(const struct TournamentMatch *matches, int count) {
+    int pending = 0;
+    for (int i = 0; i < count; i++)
+        pending += !matches[i].done;
+    return pending;
+}
+
+static void print_table(FILE *out, const struct Standing *table, char **names, int entries) {
+    fprintf(out, "rank,coach,played,won,drawn,lost,goals_for,goals_against,byes,points\n");
+    for (int i = 0; i < entries; i++) {
+        const struct Standing *s = &table[i];
+        fprintf(out, "%d,%s,%d,%d,%d,%d,%d,%d,%d,%d\n", i + 1, names[s->entry], s->played, s->won,
+                s->drawn, s->lost, s->goals_for, s->goals_against, s->byes, s->points);
+    }
+}
+
+int main(int argc, char **argv) {
+    enum Format format = FORMAT_ROUND_ROBIN;
+    int rounds = 0;
+    int seeds = 2;
+    uint64_t seed = SEED;
+    int threads = 0;
+    bool pin = true;
+    float match_length = 120.0f;
+    float tick_rate = DEFAULT_TICK_RATE;
+    const char *results_path = NULL;
+    int team_size = DEFAULT_TEAM_SIZE;
+    Field field = field_default();
+    char **names = malloc(sizeof(char *) * (size_t)argc);
+    int entries = 0;
+
+    if (!names) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--format") == 0 && value &&
+            (strcmp(value, "round-robin") == 0 || strcmp(value, "swiss") == 0)) {
+            format = strcmp(value, "swiss") == 0 ? FORMAT_SWISS : FORMAT_ROUND_ROBIN;
+            i++;
+        } else if (strcmp(arg, "--rounds") == 0 && value) {
+            rounds = atoi(value);
+            i++;
+        } else if (strcmp(arg, "--seeds") == 0 && value) {
+            seeds = atoi(value);
+            i++;
+        } else if (strcmp(arg, "--seed") == 0 && value) {
+            seed = strtoull(value, NULL, 10);
+            i++;
+        } else if (strcmp(arg, "--threads") == 0 && value) {
+            threads = atoi(value);
+            i++;
+        } else if (strcmp(arg, "--no-pin") == 0) {
+            pin = false;
+        } else if (strcmp(arg, "--length") == 0 && value) {
+            match_length = strtof(value, NULL);
+            i++;
+        } else if (strcmp(arg, "--tick-rate") == 0 && value) {
+            tick_rate = strtof(value, NULL);
+            i++;
+        } else if (strcmp(arg, "--team-size") == 0 && value && atoi(value) > 0 && atoi(value) <= MAX_TEAM_SIZE) {
+            team_size = atoi(value);
+            i++;
+        } else if (strcmp(arg, "--pitch") == 0 && value && field_parse(value, &field) == 0) {
+            i++;
+        } else if (strcmp(arg, "--results") == 0 && value) {
+            results_path = value;
+            i++;
+        } else if (strcmp(arg, "--log") == 0 && value && log_configure(value) == 0) {
+            i++;
+        } else if (strcmp(arg, "--profile") == 0) {
+            profile_start(NULL);
+        } else if (strcmp(arg, "--trace") == 0 && value) {
+            profile_start(value);
+            i++;
+        } else if (arg[0] != '-' && !strchr(arg, ',')) {
+            names[entries++] = argv[i];
+        } else {
+            print_usage(argv[0]);
+            free(names);
+            return (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) ? 0 : 1;
+        }
+    }
+
+    if (entries < 2 || seeds < 1 || match_length <= 0.0f || tick_rate <= 0.0f) {
+        fprintf(stderr, "need at least two coaches, and positive seeds, length and tick rate\n");
+        free(names);
+        return 1;
+    }
+    if (format == FORMAT_SWISS && rounds < 1)
+        while ((1 << rounds) < entries)
+            rounds++;
+    if (format == FORMAT_ROUND_ROBIN)
+        rounds = 1;
+    if (threads < 1)
+        threads = batch_cpu_count();
+
+    struct CoachPlugin *plugins = calloc((size_t)entries, sizeof(*plugins));
+    const struct CoachApi **apis = calloc((size_t)entries, sizeof(*apis));
+    double *rate = calloc((size_t)entries, sizeof(*rate));
+    int *byes = calloc((size_t)entries, sizeof(*byes));
+    struct Standing *table = calloc((size_t)entries, sizeof(*table));
+    char *header = results_header(format, rounds, seeds, seed, match_length, tick_rate, team_size, &field,
+                                  names, entries);
+    struct Results results = { .seed = seed };
+    struct TournamentMatch *all = NULL;
+    int all_count = 0;
+    int status = 1;
+
+    if (!plugins || !apis || !rate || !byes || !table || !header) {
+        fprintf(stderr, "out of memory\n");
+        goto done;
+    }
+    for (int e = 0; e < entries; e++) {
+        if (strcmp(names[e], BUILTIN_COACH) == 0)
+            continue;
+        if (coach_plugin_load(&plugins[e], names[e]) != 0) {
+            fprintf(stderr, "%s: not a loadable coach plugin\n", names[e]);
+            goto done;
+        }
+        apis[e] = plugins[e].api;
+    }
+
+    if (results_path) {
+        if (load_results(results_path, header, entries, seeds, &results) != 0)
+            goto done;
+        results.file = fopen(results_path, "a");
+        if (!results.file) {
+            perror(results_path);
+            goto done;
+        }
+        if (ftell(results.file) == 0) {
+            fprintf(results.file, "%s\nround,home,away,seed,stream,home_score,away_score,ticks,seconds\n", header);
+            fflush(results.file);
+        }
+        if (results.count > 0)
+            LOG(LOG_INFO, LOG_ENGINE, "%s: resuming with %d matches already played", results_path, results.count);
+    }
+
+    const struct TournamentConfig config = {
+        .seed = seed,
+        .length = match_length,
+        .tick_rate = tick_rate,
+        .coaches = apis,
+        .team_size = team_size,
+        .field = field
+    };
+    if (calibrate(apis, entries, &config, rate) != 0) {
+        fprintf(stderr, "calibration match failed\n");
+        goto done;
+    }
+
+    const double start = now_seconds();
+    for (int round = 1; round <= rounds; round++) {
+        int count = 0, bye = -1;
+        struct TournamentMatch *matches = (format == FORMAT_SWISS)
+            ? tournament_swiss_round(all, all_count, entries, seeds, round, byes, &bye, &count)
+            : tournament_round_robin(entries, seeds, &count);
+        struct TournamentMatch *grown = matches ? realloc(all, sizeof(*all) * (size_t)(all_count + count)) : NULL;
+        if (!grown) {
+            free(matches);
+            fprintf(stderr, "out of memory\n");
+            goto done;
+        }
+        all = grown;
+
+        apply_results(matches, count, &results);
+        estimate_costs(matches, count, rate, match_length);
+        results.played = 0;
+        results.total = count_pending(matches, count);
+        if (bye >= 0)
+            LOG(LOG_INFO, LOG_ENGINE, "round %d: %s has a bye", round, names[bye]);
+        LOG(LOG_INFO, LOG_ENGINE, "round %d: %d matches, %d to play", round, count, results.total);
+
+        const int played = tournament_play(matches, count, &config, threads, pin, write_result, &results);
+        memcpy(all + all_count, matches, sizeof(*all) * (size_t)count);
+        all_count += count;
+        free(matches);
+        if (played != 0) {
+            fprintf(stderr, "round %d failed\n", round);
+            goto done;
+        }
+    }
+    const double elapsed = now_seconds() - start;
+
+    tournament_standings(all, all_count, entries, byes, table);
+    print_table(stdout, table, names, entries);
+    fprintf(stderr, "%d matches between %d coaches on %d threads in %.3f s\n", all_count, entries, threads,
+            elapsed);
+    status = 0;
+
+done:
+    if (results.file)
+        fclose(results.file);
+    if (plugins)
+        for (int e = 0; e < entries; e++)
+            coach_plugin_unload(&plugins[e]);
+    free(results.rows);
+    free(all);
+    free(header);
+    free(table);
+    free(byes);
+    free(rate);
+    free(apis);
+    free(plugins);
+    free(names);
+    return status;
+}